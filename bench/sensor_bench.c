@@ -0,0 +1,792 @@
+/*
+    sensor_bench.c
+
+    Micro et macro benchmarks du driver et des HAL host.
+
+    Micro-benchmarks (ns/op, ops/s, percentiles) :
+    - driver : sensor_read_temperature_centi, sensor_read_samples, sensor_get_id (cache)
+    - fake bus : reg_read direct, puis à travers le décorateur de stats
+    - trace : reg_read enregistré, puis rejoué
+    - shm : reg_read servi par un simulateur dans un autre processus,
+            4 lectures séparées puis en un transfert vectorisé
+    - log : log asynchrone (chemin appelant), macro INFO désactivée
+    - time : now_ns host et simulé
+    - convert, filter, codec, store : traitement et stockage des échantillons
+
+    Capacité (temps simulé) :
+    - coût sur le fil d'une lecture de température (I2C 100k/400k/1M, SPI 8 MHz)
+      et nombre de capteurs par bus à 100 Hz de scrutation
+
+    Bus partagé (débit total, SHARED_THREADS threads sur un bus multi-capteurs) :
+    - mutex pris à chaque transaction, puis combinaison (hal_bus_combine)
+
+    Macro-benchmark (end-to-end) :
+    - N capteurs simulés (flotte creuse, 128 par bus, dernier bus partiel),
+      scrutés en boucle pendant une durée fixe
+
+    Usage :
+      sensor_bench [--json] [--duration-ms N] [--sensors N]
+
+    --json : une ligne JSON par résultat (pour comparer entre versions)
+*/
+
+/*
+    Le bench se compile comme un build "production" : les logs INFO
+    sont éliminés (voir log.disabled_info), les autres restent.
+*/
+#define HAL_LOG_MIN_LEVEL 1
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h> // getpid, unlink, fork
+#include <sys/wait.h>
+#include <pthread.h>
+
+#include "sensor/sensor.h"
+#include "sensor/sensor_convert.h"
+#include "sensor/sensor_filter.h"
+#include "sensor/sensor_codec.h"
+#include "store/store.h"
+#include "hal/hal_bus_fake.h"
+#include "hal/hal_bus_fake_fleet.h"
+#include "hal/hal_bus_stats.h"
+#include "hal/hal_bus_trace.h"
+#include "hal/hal_bus_shm.h"
+#include "hal/hal_bus_timing.h"
+#include "hal/hal_bus_combine.h"
+#include "hal/hal_time_fake.h"
+#include "hal/hal_time_sim.h"
+#include "hal/hal_log_async.h"
+
+/*
+    Mesure : BENCH_BATCHES lots de BENCH_BATCH_OPS opérations.
+    Les percentiles portent sur le coût moyen par opération de chaque lot
+    (une mesure d'horloge par opération fausserait les petits coûts).
+*/
+#define BENCH_BATCHES    2000
+#define BENCH_BATCH_OPS  64
+#define BENCH_WARMUP     200
+
+/* Options de ligne de commande */
+static int g_json = 0;
+
+/* Résultat invalide (ex: messages de log perdus) : code de sortie 1 */
+static int g_failed = 0;
+
+/* Puits : empêche le compilateur de supprimer le travail mesuré */
+static volatile int64_t g_sink;
+
+/* Horloge de mesure : HAL time host */
+static hal_time_t g_clock;
+
+/*
+    Opération mesurée : fn(arg) exécutée BENCH_BATCH_OPS fois par lot.
+*/
+typedef void (*bench_fn_t)(void *arg);
+
+typedef struct {
+    double p50;
+    double p90;
+    double p99;
+    double mean;
+} bench_stats_t;
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+    Affiche un résultat (texte aligné ou JSON).
+*/
+static void report(const char *name, const bench_stats_t *st)
+{
+    double ops_s = (st->mean > 0.0) ? 1e9 / st->mean : 0.0;
+
+    if (g_json) {
+        printf("{\"bench\":\"%s\",\"ns_per_op\":%.2f,\"ops_per_s\":%.0f,"
+               "\"p50_ns\":%.2f,\"p90_ns\":%.2f,\"p99_ns\":%.2f}\n",
+               name, st->mean, ops_s, st->p50, st->p90, st->p99);
+    } else {
+        printf("%-28s %10.2f ns/op %14.0f ops/s   p50 %8.2f  p90 %8.2f  p99 %8.2f\n",
+               name, st->mean, ops_s, st->p50, st->p90, st->p99);
+    }
+}
+
+/*
+    Lance un micro-benchmark et affiche ses statistiques.
+
+    between (optionnel) : appelé entre deux lots, hors mesure
+    (ex: laisser le thread de fond vider la file du log asynchrone).
+*/
+static void run_bench_between(const char *name, bench_fn_t fn, void *arg, bench_fn_t between)
+{
+    static double per_op[BENCH_BATCHES];
+
+    for (int i = 0; i < BENCH_WARMUP; i++) {
+        fn(arg);
+    }
+    if (between) {
+        between(arg);
+    }
+
+    uint64_t total_ns = 0;
+    for (int b = 0; b < BENCH_BATCHES; b++) {
+        uint64_t t0 = hal_time_now_ns(&g_clock);
+        for (int i = 0; i < BENCH_BATCH_OPS; i++) {
+            fn(arg);
+        }
+        uint64_t dt = hal_time_now_ns(&g_clock) - t0;
+
+        total_ns += dt;
+        per_op[b] = (double)dt / BENCH_BATCH_OPS;
+
+        if (between) {
+            between(arg);
+        }
+    }
+
+    qsort(per_op, BENCH_BATCHES, sizeof(per_op[0]), cmp_double);
+
+    bench_stats_t st;
+    st.p50 = per_op[BENCH_BATCHES / 2];
+    st.p90 = per_op[(BENCH_BATCHES * 90) / 100];
+    st.p99 = per_op[(BENCH_BATCHES * 99) / 100];
+    st.mean = (double)total_ns / ((double)BENCH_BATCHES * BENCH_BATCH_OPS);
+
+    report(name, &st);
+}
+
+static void run_bench(const char *name, bench_fn_t fn, void *arg)
+{
+    run_bench_between(name, fn, arg, NULL);
+}
+
+/* ---------------- Opérations mesurées ---------------- */
+
+typedef struct {
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    sensor_t sensor;
+} bench_fixture_t;
+
+static void op_read_temperature(void *arg)
+{
+    bench_fixture_t *f = (bench_fixture_t *)arg;
+    int16_t temp;
+    sensor_read_temperature_centi(&f->sensor, &temp);
+    g_sink += temp;
+}
+
+static void op_get_id_cached(void *arg)
+{
+    bench_fixture_t *f = (bench_fixture_t *)arg;
+    uint8_t id;
+    sensor_get_id(&f->sensor, &id);
+    g_sink += id;
+}
+
+static void op_read_samples_burst(void *arg)
+{
+    bench_fixture_t *f = (bench_fixture_t *)arg;
+    int16_t samples[SENSOR_FIFO_DEPTH];
+    size_t n = 0;
+
+    hal_bus_fake_fifo_fill(&f->bus_ctx, SENSOR_FIFO_DEPTH);
+    sensor_read_samples(&f->sensor, samples, SENSOR_FIFO_DEPTH, &n);
+    g_sink += samples[0] + (int64_t)n;
+}
+
+static void op_fake_reg_read(void *arg)
+{
+    bench_fixture_t *f = (bench_fixture_t *)arg;
+    uint8_t buf[2];
+    f->bus.reg_read(f->bus.ctx, 0x50, 0x10, buf, 2);
+    g_sink += buf[0];
+}
+
+static void op_wrapped_reg_read(void *arg)
+{
+    const hal_bus_t *bus = (const hal_bus_t *)arg;
+    uint8_t buf[2];
+    bus->reg_read(bus->ctx, 0x50, 0x10, buf, 2);
+    g_sink += buf[0];
+}
+
+/* 4 lectures : une par appel, puis un seul transfert vectorisé */
+static void op_reg_read_x4(void *arg)
+{
+    const hal_bus_t *bus = (const hal_bus_t *)arg;
+    uint8_t buf[4][2];
+    for (int i = 0; i < 4; i++) {
+        bus->reg_read(bus->ctx, 0x50, 0x10, buf[i], 2);
+    }
+    g_sink += buf[3][0];
+}
+
+static void op_xfer_x4(void *arg)
+{
+    const hal_bus_t *bus = (const hal_bus_t *)arg;
+    uint8_t buf[4][2];
+    hal_bus_seg_t segs[4];
+    for (int i = 0; i < 4; i++) {
+        segs[i] = (hal_bus_seg_t){ 0x50, 0x10, HAL_BUS_SEG_READ, buf[i], 2 };
+    }
+    hal_bus_vectored(bus, segs, 4);
+    g_sink += buf[3][0];
+}
+
+/*
+    Log asynchrone : on mesure la mise en file, pas la perte sur file pleine.
+    Entre deux lots, flush dès que le lot suivant pourrait la remplir.
+*/
+typedef struct {
+    hal_log_t log;
+    hal_log_async_ctx_t ctx;
+    size_t queued;
+} bench_log_t;
+
+_Static_assert(BENCH_WARMUP <= HAL_LOG_ASYNC_RING_SIZE &&
+               BENCH_BATCH_OPS <= HAL_LOG_ASYNC_RING_SIZE,
+               "log.async: un lot doit tenir dans la file du thread");
+
+static void op_log_async(void *arg)
+{
+    bench_log_t *l = (bench_log_t *)arg;
+    l->log.log(l->log.ctx, HAL_LOG_INFO, "sensor 0x%02X: temp %d", 0x50, 2534);
+    l->queued++;
+}
+
+static void log_async_drain(void *arg)
+{
+    bench_log_t *l = (bench_log_t *)arg;
+    if (l->queued + BENCH_BATCH_OPS > HAL_LOG_ASYNC_RING_SIZE) {
+        hal_log_async_flush(&l->ctx);
+        l->queued = 0;
+    }
+}
+
+/* Même message via la macro INFO, éliminée à la compilation */
+static void op_log_disabled(void *arg)
+{
+    const hal_log_t *log = (const hal_log_t *)arg;
+    (void)log;
+    HAL_LOGI(log, "sensor 0x%02X: temp %d", 0x50, 2534);
+    g_sink++;
+}
+
+/* Décodage d'une rafale FIFO pleine (32 échantillons) */
+static uint8_t g_raw[2 * SENSOR_FIFO_DEPTH];
+
+static void op_convert_centi(void *arg)
+{
+    int16_t out[SENSOR_FIFO_DEPTH];
+    (void)arg;
+    sensor_convert_be16_to_centi(g_raw, out, SENSOR_FIFO_DEPTH);
+    g_sink += out[SENSOR_FIFO_DEPTH - 1];
+}
+
+static void op_convert_float(void *arg)
+{
+    float out[SENSOR_FIFO_DEPTH];
+    (void)arg;
+    sensor_convert_be16_to_float(g_raw, out, SENSOR_FIFO_DEPTH, 0.01f, 0.0f);
+    g_sink += (int64_t)out[SENSOR_FIFO_DEPTH - 1];
+}
+
+/* Filtres sur une rafale FIFO pleine */
+static void op_filter(void *arg)
+{
+    sensor_filter_t *f = (sensor_filter_t *)arg;
+    int16_t buf[SENSOR_FIFO_DEPTH];
+    for (size_t i = 0; i < SENSOR_FIFO_DEPTH; i++) {
+        buf[i] = (int16_t)(2500 + (int)(i * 7 % 13));
+    }
+    g_sink += (int64_t)sensor_filter_process(f, buf, buf, SENSOR_FIFO_DEPTH) + buf[0];
+}
+
+static void op_pipeline(void *arg)
+{
+    sensor_pipeline_t *p = (sensor_pipeline_t *)arg;
+    int16_t buf[SENSOR_FIFO_DEPTH];
+    for (size_t i = 0; i < SENSOR_FIFO_DEPTH; i++) {
+        buf[i] = (int16_t)(2500 + (int)(i * 7 % 13));
+    }
+    g_sink += (int64_t)sensor_pipeline_process(p, buf, SENSOR_FIFO_DEPTH) + buf[0];
+}
+
+/* Codec : bloc de 128 échantillons réguliers (+5, 1 ms) */
+#define BENCH_CODEC_N 128
+static int16_t g_codec_v[BENCH_CODEC_N];
+static uint64_t g_codec_t[BENCH_CODEC_N];
+static uint8_t g_codec_block[SENSOR_CODEC_BLOCK_BOUND(BENCH_CODEC_N)];
+static size_t g_codec_len;
+
+static void op_codec_encode(void *arg)
+{
+    (void)arg;
+    sensor_codec_encode_block(g_codec_v, g_codec_t, BENCH_CODEC_N,
+                              g_codec_block, sizeof(g_codec_block), &g_codec_len);
+    g_sink += (int64_t)g_codec_len;
+}
+
+static void op_codec_decode(void *arg)
+{
+    int16_t v[BENCH_CODEC_N];
+    uint64_t t[BENCH_CODEC_N];
+    size_t n = 0;
+    (void)arg;
+    sensor_codec_decode_block(g_codec_block, g_codec_len, v, t, BENCH_CODEC_N, &n);
+    g_sink += v[n - 1] + (int64_t)t[n - 1];
+}
+
+/* Ajout dans un segment mmap (aucun appel système) */
+static void op_store_append(void *arg)
+{
+    static uint64_t t = 0;
+    sensor_sample_t s = { t++, 1, 2500, 0 };
+    g_sink += store_segment_append((store_segment_t *)arg, &s);
+}
+
+typedef struct {
+    hal_bus_t bus;
+    hal_bus_trace_play_ctx_t ctx;
+} bench_replay_t;
+
+static void op_trace_replay(void *arg)
+{
+    bench_replay_t *r = (bench_replay_t *)arg;
+    uint8_t buf[2];
+
+    // Trace épuisée : on repart du début
+    if (r->bus.reg_read(r->bus.ctx, 0x50, 0x10, buf, 2) != HAL_OK) {
+        hal_bus_trace_play_rewind(&r->ctx);
+        r->bus.reg_read(r->bus.ctx, 0x50, 0x10, buf, 2);
+    }
+    g_sink += buf[0];
+}
+
+static void op_time_host(void *arg)
+{
+    g_sink += (int64_t)hal_time_now_ns((const hal_time_t *)arg);
+}
+
+static void op_time_sim(void *arg)
+{
+    g_sink += (int64_t)hal_time_now_ns((const hal_time_t *)arg);
+}
+
+/* ---------------- Capacité ---------------- */
+
+/*
+    Une lecture de température passée par le modèle de temps de fil :
+    coût d'un cycle de scrutation, capteurs par bus à CAPACITY_POLL_HZ.
+*/
+#define CAPACITY_POLL_HZ 100u
+
+static void run_capacity(void)
+{
+    static const struct {
+        const char *name;
+        hal_bus_timing_cfg_t cfg;
+    } buses[] = {
+        { "i2c_100k", HAL_BUS_TIMING_I2C_100K },
+        { "i2c_400k", HAL_BUS_TIMING_I2C_400K },
+        { "i2c_1m",   HAL_BUS_TIMING_I2C_1M },
+        { "spi_8m",   HAL_BUS_TIMING_SPI(8000000u) },
+    };
+
+    for (size_t i = 0; i < sizeof(buses) / sizeof(buses[0]); i++) {
+        hal_bus_fake_ctx_t fake_ctx;
+        hal_bus_t fake, bus;
+        hal_time_sim_ctx_t sim_ctx;
+        hal_time_t sim;
+        hal_bus_timing_ctx_t timing;
+        sensor_t s;
+
+        hal_bus_fake_init(&fake_ctx, &fake);
+        hal_time_sim_init(&sim_ctx, &sim, 0);
+        hal_bus_timing_init(&timing, &bus, &fake, &buses[i].cfg, &sim_ctx, 1);
+        if (sensor_init(&s, 0x50, &bus, &sim, NULL) != SENSOR_OK) {
+            continue;
+        }
+
+        hal_bus_timing_reset(&timing);
+        int16_t temp;
+        sensor_read_temperature_centi(&s, &temp);
+
+        hal_bus_timing_report_t rep;
+        hal_bus_timing_report(&timing, &rep);
+        uint64_t per_s = rep.busy_ns ? 1000000000u / rep.busy_ns : 0;
+
+        if (g_json) {
+            printf("{\"bench\":\"capacity.%s\",\"ns_per_poll\":%llu,\"sensors_at_%uhz\":%llu}\n",
+                   buses[i].name, (unsigned long long)rep.busy_ns, CAPACITY_POLL_HZ,
+                   (unsigned long long)(per_s / CAPACITY_POLL_HZ));
+        } else {
+            printf("capacity.%-19s %10llu ns/poll   %llu sensors/bus at %u Hz\n",
+                   buses[i].name, (unsigned long long)rep.busy_ns,
+                   (unsigned long long)(per_s / CAPACITY_POLL_HZ), CAPACITY_POLL_HZ);
+        }
+    }
+}
+
+/* ---------------- Bus partagé ---------------- */
+
+#define SHARED_THREADS 4
+#define SHARED_OPS     20000
+
+/* Référence : un mutex autour de chaque transaction */
+typedef struct {
+    hal_bus_t inner;
+    pthread_mutex_t lock;
+} bench_locked_bus_t;
+
+static hal_status_t locked_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    bench_locked_bus_t *lb = (bench_locked_bus_t *)ctx;
+    pthread_mutex_lock(&lb->lock);
+    hal_status_t st = lb->inner.reg_read(lb->inner.ctx, dev_addr, reg, data, len);
+    pthread_mutex_unlock(&lb->lock);
+    return st;
+}
+
+static hal_status_t locked_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    bench_locked_bus_t *lb = (bench_locked_bus_t *)ctx;
+    pthread_mutex_lock(&lb->lock);
+    hal_status_t st = lb->inner.reg_write(lb->inner.ctx, dev_addr, reg, data, len);
+    pthread_mutex_unlock(&lb->lock);
+    return st;
+}
+
+typedef struct {
+    const hal_bus_t *bus;
+    uint8_t addr;
+} bench_shared_arg_t;
+
+static void *shared_worker(void *arg)
+{
+    const bench_shared_arg_t *a = (const bench_shared_arg_t *)arg;
+    uint8_t buf[2];
+
+    for (int i = 0; i < SHARED_OPS; i++) {
+        a->bus->reg_read(a->bus->ctx, a->addr, 0x10, buf, 2);
+    }
+    g_sink += buf[0];
+    return NULL;
+}
+
+static void run_shared(const char *name, const hal_bus_t *bus)
+{
+    pthread_t th[SHARED_THREADS];
+    bench_shared_arg_t args[SHARED_THREADS];
+
+    uint64_t t0 = hal_time_now_ns(&g_clock);
+    for (int i = 0; i < SHARED_THREADS; i++) {
+        args[i].bus = bus;
+        args[i].addr = (uint8_t)(0x50 + i);
+        pthread_create(&th[i], NULL, shared_worker, &args[i]);
+    }
+    for (int i = 0; i < SHARED_THREADS; i++) {
+        pthread_join(th[i], NULL);
+    }
+    uint64_t dt = hal_time_now_ns(&g_clock) - t0;
+
+    double ops = (double)SHARED_THREADS * SHARED_OPS;
+    double ops_s = dt ? ops * 1e9 / (double)dt : 0.0;
+
+    if (g_json) {
+        printf("{\"bench\":\"%s\",\"threads\":%d,\"ops_per_s\":%.0f,\"ns_per_op\":%.2f}\n",
+               name, SHARED_THREADS, ops_s, (double)dt / ops);
+    } else {
+        printf("%-28s %10.2f ns/op %14.0f ops/s   (%d threads)\n",
+               name, (double)dt / ops, ops_s, SHARED_THREADS);
+    }
+}
+
+static void run_shared_bus(void)
+{
+    static hal_bus_fake_ctx_t devs[SHARED_THREADS];
+    hal_bus_fake_multi_ctx_t multi_ctx;
+    hal_bus_t multi;
+
+    hal_bus_fake_multi_init(&multi_ctx, &multi);
+    for (int i = 0; i < SHARED_THREADS; i++) {
+        hal_bus_fake_dev_init(&devs[i]);
+        hal_bus_fake_multi_attach(&multi_ctx, (uint8_t)(0x50 + i), &devs[i]);
+    }
+
+    bench_locked_bus_t locked = { .inner = multi };
+    pthread_mutex_init(&locked.lock, NULL);
+    hal_bus_t locked_bus = { .ctx = &locked, .reg_read = locked_read, .reg_write = locked_write, .xfer = NULL };
+    run_shared("shared_bus.mutex", &locked_bus);
+    pthread_mutex_destroy(&locked.lock);
+
+    hal_bus_combine_ctx_t comb;
+    hal_bus_t comb_bus;
+    if (hal_bus_combine_init(&comb, &comb_bus, &multi) == HAL_OK) {
+        run_shared("shared_bus.combine", &comb_bus);
+        if (!g_json) {
+            uint64_t batches = atomic_load(&comb.batches);
+            printf("  (combine: %.2f requests/batch)\n",
+                   batches ? (double)atomic_load(&comb.requests) / (double)batches : 0.0);
+        }
+        hal_bus_combine_deinit(&comb);
+    }
+}
+
+/* ---------------- Macro-benchmark ---------------- */
+
+/*
+    Exactement N capteurs sur une flotte creuse (128 par bus, le dernier
+    bus n'est que partiellement peuplé), scrutés en tourniquet pendant
+    duration_ms.
+*/
+static void run_end_to_end(uint32_t n_sensors, uint32_t duration_ms)
+{
+    enum { PER_BUS = 128 };
+
+    uint32_t n_buses = (n_sensors + PER_BUS - 1) / PER_BUS;
+    uint16_t per_bus = (uint16_t)(n_sensors < PER_BUS ? n_sensors : PER_BUS);
+
+    hal_fake_model_t model;
+    hal_fake_model_init_default(&model);
+
+    hal_bus_fake_fleet_t fleet;
+    hal_bus_t *buses = calloc(n_buses, sizeof(*buses));
+    sensor_t *sensors = calloc(n_sensors, sizeof(*sensors));
+    if (!buses || !sensors ||
+        hal_bus_fake_fleet_init(&fleet, &model, n_buses, per_bus, 0) != HAL_OK) {
+        fprintf(stderr, "end_to_end: allocation failed\n");
+        free(buses);
+        free(sensors);
+        return;
+    }
+
+    uint32_t total = n_sensors;
+    uint32_t ready = 0;
+    for (uint32_t i = 0; i < total; i++) {
+        uint32_t b = i / per_bus;
+        if (i % per_bus == 0) {
+            hal_bus_fake_fleet_bus(&fleet, b, &buses[b]);
+        }
+        if (sensor_init(&sensors[i], (uint8_t)(i % per_bus), &buses[b], NULL, NULL) == SENSOR_OK) {
+            ready++;
+        }
+    }
+
+    uint64_t deadline = hal_time_now_ns(&g_clock) + (uint64_t)duration_ms * 1000000u;
+    uint64_t reads = 0;
+    uint64_t errors = 0;
+    uint64_t t0 = hal_time_now_ns(&g_clock);
+    uint64_t t1 = t0;
+
+    while (t1 < deadline) {
+        for (uint32_t i = 0; i < total; i++) {
+            int16_t temp;
+            if (sensor_read_temperature_centi(&sensors[i], &temp) == SENSOR_OK) {
+                reads++;
+                g_sink += temp;
+            } else {
+                errors++;
+            }
+        }
+        t1 = hal_time_now_ns(&g_clock);
+    }
+
+    double secs = (double)(t1 - t0) / 1e9;
+    double reads_s = (secs > 0.0) ? (double)reads / secs : 0.0;
+    double ns_read = (reads > 0) ? (double)(t1 - t0) / (double)reads : 0.0;
+
+    if (g_json) {
+        printf("{\"bench\":\"end_to_end\",\"sensors\":%u,\"ready\":%u,\"duration_s\":%.3f,"
+               "\"reads\":%llu,\"errors\":%llu,\"reads_per_s\":%.0f,\"ns_per_read\":%.2f,"
+               "\"fleet_bytes\":%zu}\n",
+               total, ready, secs, (unsigned long long)reads, (unsigned long long)errors,
+               reads_s, ns_read, hal_bus_fake_fleet_memory(&fleet));
+    } else {
+        printf("end_to_end: %u sensors (%u ready), %.3f s, %llu reads, %llu errors\n",
+               total, ready, secs, (unsigned long long)reads, (unsigned long long)errors);
+        printf("end_to_end: %.0f reads/s, %.2f ns/read, fleet %zu bytes\n",
+               reads_s, ns_read, hal_bus_fake_fleet_memory(&fleet));
+    }
+
+    hal_bus_fake_fleet_deinit(&fleet);
+    free(sensors);
+    free(buses);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t duration_ms = 1000;
+    uint32_t n_sensors = 1024;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            g_json = 1;
+        } else if (strcmp(argv[i], "--duration-ms") == 0 && i + 1 < argc) {
+            duration_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--sensors") == 0 && i + 1 < argc) {
+            n_sensors = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--json] [--duration-ms N] [--sensors N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n_sensors == 0) {
+        n_sensors = 1;
+    }
+
+    hal_time_fake_init(&g_clock);
+
+    if (!g_json) {
+        printf("=== sensor_bench ===\n");
+    }
+
+    /* Driver + fake bus */
+    static bench_fixture_t fx;
+    hal_bus_fake_init(&fx.bus_ctx, &fx.bus);
+    if (sensor_init(&fx.sensor, 0x50, &fx.bus, NULL, NULL) != SENSOR_OK) {
+        fprintf(stderr, "sensor_init failed\n");
+        return 1;
+    }
+
+    run_bench("driver.read_temperature", op_read_temperature, &fx);
+    run_bench("driver.get_id_cached", op_get_id_cached, &fx);
+    run_bench("driver.read_samples_x32", op_read_samples_burst, &fx);
+    run_bench("fake_bus.reg_read", op_fake_reg_read, &fx);
+
+    /* Même lecture, comptée et chronométrée par le décorateur */
+    static hal_bus_stats_ctx_t stats_ctx;
+    hal_bus_t stats_bus;
+    if (hal_bus_stats_init(&stats_ctx, &stats_bus, &fx.bus, &g_clock) == HAL_OK) {
+        run_bench("bus_stats.reg_read", op_wrapped_reg_read, &stats_bus);
+        hal_bus_stats_deinit(&stats_ctx);
+    }
+
+    /* Même lecture, servie par un simulateur dans un processus fils */
+    hal_bus_shm_t shm;
+    if (hal_bus_shm_create(&shm, NULL) == HAL_OK) {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            hal_bus_fake_ctx_t sim_ctx;
+            hal_bus_t sim_bus;
+            hal_bus_fake_init(&sim_ctx, &sim_bus);
+            hal_bus_shm_serve(&shm, &sim_bus);
+            _exit(0);
+        }
+        if (pid > 0) {
+            hal_bus_t shm_bus;
+            hal_bus_shm_client_init(&shm, &shm_bus);
+            run_bench("shm_bus.reg_read", op_wrapped_reg_read, &shm_bus);
+            run_bench("shm_bus.reg_read_x4", op_reg_read_x4, &shm_bus);
+            run_bench("shm_bus.xfer_x4", op_xfer_x4, &shm_bus);
+            hal_bus_shm_shutdown(&shm);
+            waitpid(pid, NULL, 0);
+        }
+        hal_bus_shm_detach(&shm);
+    }
+
+    /* Conversion : implémentation choisie à l'exécution, puis scalaire */
+    for (size_t i = 0; i < sizeof(g_raw); i++) {
+        g_raw[i] = (uint8_t)(i * 37u);
+    }
+    if (!g_json) {
+        printf("  (convert: %s)\n", sensor_convert_isa_name(sensor_convert_active()));
+    }
+    run_bench("convert.be16_centi_x32", op_convert_centi, NULL);
+    run_bench("convert.be16_float_x32", op_convert_float, NULL);
+    sensor_convert_select(SENSOR_CONVERT_SCALAR);
+    run_bench("convert.be16_centi_x32_scalar", op_convert_centi, NULL);
+    run_bench("convert.be16_float_x32_scalar", op_convert_float, NULL);
+    sensor_convert_select(SENSOR_CONVERT_AUTO);
+
+    /* Filtres : médiane 3 (SIMD), puis chaîne médiane -> IIR -> CIC /8 */
+    sensor_filter_t median3;
+    sensor_filter_init_median(&median3, 3);
+    run_bench("filter.median3_x32", op_filter, &median3);
+
+    sensor_filter_t stages[3];
+    sensor_pipeline_t pipeline;
+    sensor_filter_init_median(&stages[0], 3);
+    sensor_filter_init_iir1(&stages[1], 2);
+    sensor_filter_init_cic(&stages[2], 3, 8);
+    sensor_pipeline_init(&pipeline, stages, 3);
+    run_bench("filter.pipeline_x32", op_pipeline, &pipeline);
+
+    /* Codec */
+    for (size_t i = 0; i < BENCH_CODEC_N; i++) {
+        g_codec_v[i] = (int16_t)(2500 + 5 * (int)i);
+        g_codec_t[i] = 1000 * (uint64_t)i;
+    }
+    run_bench("codec.encode_x128", op_codec_encode, NULL);
+    run_bench("codec.decode_x128", op_codec_decode, NULL);
+    if (!g_json) {
+        printf("  (codec: %zu bytes for %d samples, raw %zu)\n", g_codec_len, BENCH_CODEC_N,
+               (size_t)BENCH_CODEC_N * (sizeof(int16_t) + sizeof(uint64_t)));
+    }
+
+    /* Stockage : segment temporaire assez grand pour warmup + mesures */
+    char seg_path[64];
+    store_segment_t seg;
+    snprintf(seg_path, sizeof(seg_path), "/tmp/sensor_bench_%d.tss", (int)getpid());
+    if (store_segment_create(&seg, seg_path, 1u << 20) == SENSOR_OK) {
+        run_bench("store.append", op_store_append, &seg);
+        store_segment_close(&seg);
+        unlink(seg_path);
+    }
+
+    /* Trace : enregistrement autour du fake bus, puis rejeu de la même trace */
+    char trace_path[64];
+    hal_bus_trace_rec_ctx_t rec_ctx;
+    hal_bus_t rec_bus;
+    snprintf(trace_path, sizeof(trace_path), "/tmp/sensor_bench_%d.tr", (int)getpid());
+    if (hal_bus_trace_rec_init(&rec_ctx, &rec_bus, &fx.bus, &g_clock, trace_path) == HAL_OK) {
+        run_bench("trace.record_reg_read", op_wrapped_reg_read, &rec_bus);
+        hal_bus_trace_rec_close(&rec_ctx);
+
+        static bench_replay_t replay;
+        if (hal_bus_trace_play_init(&replay.ctx, &replay.bus, NULL, trace_path) == HAL_OK) {
+            run_bench("trace.replay_reg_read", op_trace_replay, &replay);
+            hal_bus_trace_play_close(&replay.ctx);
+        }
+        unlink(trace_path);
+    }
+
+    /* Log asynchrone vers /dev/null (le coût mesuré est celui de l'appelant) */
+    FILE *devnull = fopen("/dev/null", "w");
+    static bench_log_t blog;
+    if (devnull && hal_log_async_init(&blog.ctx, &blog.log, devnull, devnull) == 0) {
+        run_bench_between("log.async", op_log_async, &blog, log_async_drain);
+        hal_log_async_deinit(&blog.ctx);
+        if (hal_log_async_dropped(&blog.ctx) > 0) {
+            fprintf(stderr, "log.async: %llu messages dropped, result invalid\n",
+                    (unsigned long long)hal_log_async_dropped(&blog.ctx));
+            g_failed = 1;
+        }
+        run_bench("log.disabled_info", op_log_disabled, &blog.log);
+    }
+    if (devnull) {
+        fclose(devnull);
+    }
+
+    /* Horloges */
+    hal_time_t sim;
+    hal_time_sim_ctx_t sim_ctx;
+    hal_time_sim_init(&sim_ctx, &sim, 0);
+    run_bench("time.host_now_ns", op_time_host, &g_clock);
+    run_bench("time.sim_now_ns", op_time_sim, &sim);
+
+    /* Scénario complet */
+    run_capacity();
+    run_shared_bus();
+    run_end_to_end(n_sensors, duration_ms);
+
+    return g_failed;
+}
@@ -4,13 +4,17 @@
     Démo :
     - configure les HAL host (fake bus + time + log)
     - initialise le driver capteur
-    - lit la température en boucle
+    - lit la température en boucle (thread principal = acquisition)
+    - affiche les échantillons dans un thread consommateur séparé,
+      via une file SPSC : un printf lent ne retarde pas l'acquisition
 */
 
 #include <stdio.h>
 #include <stdint.h>
+#include <pthread.h>
 
 #include "sensor/sensor.h"
+#include "sensor/sensor_ring.h"
 #include "hal/hal_bus_fake.h"
 #include "hal/hal_time.h"
 #include "hal/hal_log.h"
@@ -26,6 +30,38 @@
 void hal_time_fake_init(hal_time_t *time);
 void hal_log_stdio_init(hal_log_t *log);
 
+/* File entre acquisition et affichage (puissance de 2) */
+#define DEMO_RING_CAPACITY 64
+
+static sensor_sample_t g_ring_buf[DEMO_RING_CAPACITY];
+static sensor_ring_t g_ring;
+
+/*
+    Thread consommateur : vide la file par lots et affiche.
+*/
+static void *consumer_main(void *arg)
+{
+    const hal_time_t *time = (const hal_time_t *)arg;
+    sensor_sample_t batch[16];
+
+    while (1) {
+        size_t n = sensor_ring_pop_batch(&g_ring, batch, 16);
+
+        for (size_t i = 0; i < n; i++) {
+            /* value est en centi-degrés : 2534 => 25.34°C */
+            printf("[t=%llu us] Temperature: %.2f °C\n",
+                   (unsigned long long)batch[i].t_us,
+                   (float)batch[i].value / 100.0f);
+        }
+
+        if (n == 0) {
+            time->delay_ms(time->ctx, 100);
+        }
+    }
+
+    return NULL;
+}
+
 int main(void)
 {
     printf("=== Sensor Driver Demo (Simulated) ===\n");
@@ -62,18 +98,28 @@ int main(void)
         return 1;
     }
 
+    /* Horodatage des échantillons : même HAL time */
+    sensor_set_clock(&sensor, &time);
+
     printf("Sensor init OK\n");
 
-    /* ---------------- Lecture en boucle ---------------- */
+    /* ---------------- File + consommateur ---------------- */
 
-    while (1) {
-        int16_t temp_centi = 0;
+    sensor_ring_init(&g_ring, g_ring_buf, DEMO_RING_CAPACITY);
 
-        if (sensor_read_temperature_centi(&sensor, &temp_centi) == SENSOR_OK) {
-            /* temp_centi est en centi-degrés : 2534 => 25.34°C */
-            printf("Temperature: %.2f °C\n", (float)temp_centi / 100.0f);
-        } else {
-            printf("Temperature read error\n");
+    pthread_t consumer;
+    if (pthread_create(&consumer, NULL, consumer_main, &time) != 0) {
+        printf("Consumer thread creation failed\n");
+        return 1;
+    }
+
+    /* ---------------- Acquisition en boucle ---------------- */
+
+    while (1) {
+        /* Erreur bus ou file pleine (échantillon perdu, compté) */
+        if (sensor_read_to_ring(&sensor, &g_ring, 0, sensor_timestamp_us(&sensor)) != SENSOR_OK) {
+            printf("Temperature read error (dropped=%llu)\n",
+                   (unsigned long long)sensor_ring_dropped(&g_ring));
         }
 
         /* Attendre 1 seconde */
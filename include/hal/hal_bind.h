@@ -0,0 +1,83 @@
+#pragma once
+/*
+    hal_bind.h
+
+    Liaison entre le driver et les backends HAL.
+
+    Deux modes :
+
+    - dynamique (par défaut) :
+        le driver appelle bus->reg_read(...) via pointeur de fonction.
+        Plusieurs backends peuvent coexister dans le même binaire.
+
+    - statique (opt-in, HAL_STATIC_BINDING défini) :
+        le backend est choisi à la compilation via l'en-tête
+        HAL_STATIC_BINDING_HEADER, qui fournit :
+          hal_static_bus_read / hal_static_bus_write / hal_static_bus_xfer
+          hal_static_delay_ms / hal_static_now_ns
+          hal_static_log
+        Plus d'appel indirect ni de test de pointeur de fonction :
+        le compilateur peut inliner tout le chemin de lecture
+        (avec LTO si le backend est dans une autre unité de compilation).
+        Les champs ctx des structures HAL restent utilisés.
+
+    Le driver utilise UNIQUEMENT les macros ci-dessous
+    (et HAL_LOGx de hal_log.h, qui suivent le même mode).
+*/
+
+#include <stddef.h>
+
+#if defined(HAL_STATIC_BINDING)
+
+#ifndef HAL_STATIC_BINDING_HEADER
+#error "HAL_STATIC_BINDING requiert HAL_STATIC_BINDING_HEADER (ex: \"hal/hal_bind_host.h\")"
+#endif
+#include HAL_STATIC_BINDING_HEADER
+
+#define HAL_BUS_CAN_READ(bus_)   ((bus_) != NULL)
+#define HAL_BUS_CAN_WRITE(bus_)  ((bus_) != NULL)
+
+#define HAL_BUS_READ(bus_, addr_, reg_, data_, len_) \
+    hal_static_bus_read((bus_)->ctx, (addr_), (reg_), (data_), (len_))
+
+#define HAL_BUS_WRITE(bus_, addr_, reg_, data_, len_) \
+    hal_static_bus_write((bus_)->ctx, (addr_), (reg_), (data_), (len_))
+
+#define HAL_BUS_XFER(bus_, xfer_, segs_, n_) \
+    hal_static_bus_xfer((bus_)->ctx, (segs_), (n_))
+
+#define HAL_TIME_DELAY_MS(time_, ms_) do {                          \
+    if (time_) {                                                    \
+        hal_static_delay_ms((time_)->ctx, (ms_));                   \
+    }                                                               \
+} while (0)
+
+#define HAL_TIME_NOW_NS(time_) \
+    ((time_) ? hal_static_now_ns((time_)->ctx) : 0u)
+
+#else
+
+#define HAL_BUS_CAN_READ(bus_)   ((bus_) && (bus_)->reg_read)
+#define HAL_BUS_CAN_WRITE(bus_)  ((bus_) && (bus_)->reg_write)
+
+#define HAL_BUS_READ(bus_, addr_, reg_, data_, len_) \
+    (bus_)->reg_read((bus_)->ctx, (addr_), (reg_), (data_), (len_))
+
+#define HAL_BUS_WRITE(bus_, addr_, reg_, data_, len_) \
+    (bus_)->reg_write((bus_)->ctx, (addr_), (reg_), (data_), (len_))
+
+/* xfer_ : transfert natif choisi par l'appelant (NULL = repli générique) */
+#define HAL_BUS_XFER(bus_, xfer_, segs_, n_)                    \
+    ((xfer_) ? (xfer_)((bus_)->ctx, (segs_), (n_))              \
+             : hal_bus_vectored_generic((bus_), (segs_), (n_)))
+
+#define HAL_TIME_DELAY_MS(time_, ms_) do {                          \
+    if ((time_) && (time_)->delay_ms) {                             \
+        (time_)->delay_ms((time_)->ctx, (ms_));                     \
+    }                                                               \
+} while (0)
+
+#define HAL_TIME_NOW_NS(time_) \
+    hal_time_now_ns(time_)
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+/*
+    hal_bind_host.h
+
+    Backends host pour la liaison statique (voir hal_bind.h) :
+    - bus   : fake bus mono-capteur (hal_bus_fake.c)
+    - time  : usleep / CLOCK_MONOTONIC, inliné ici
+    - log   : stdio (hal_log_stdio.c)
+
+    Utilisation :
+      -DHAL_STATIC_BINDING -DHAL_STATIC_BINDING_HEADER="\"hal/hal_bind_host.h\""
+*/
+
+#include <stdint.h>
+#include <time.h>   // clock_gettime
+#include <unistd.h> // usleep
+
+#include "hal/hal_bus_fake.h"
+#include "hal/hal_log_stdio.h"
+
+#define hal_static_bus_read   hal_bus_fake_reg_read
+#define hal_static_bus_write  hal_bus_fake_reg_write
+#define hal_static_bus_xfer   hal_bus_fake_xfer
+#define hal_static_log        hal_log_stdio_log
+
+static inline void hal_static_delay_ms(void *ctx, uint32_t ms)
+{
+    (void)ctx;
+    usleep((useconds_t)(ms * 1000u));
+}
+
+static inline uint64_t hal_static_now_ns(void *ctx)
+{
+    (void)ctx;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
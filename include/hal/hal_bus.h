@@ -14,6 +14,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 /*
     Codes de retour standard de la HAL.
@@ -25,11 +26,31 @@ typedef enum {
     HAL_TIMEOUT = -2   // Timeout de communication
 } hal_status_t;
 
+/*
+    Segment d'un transfert vectorisé (voir hal_bus_t::xfer, hal_bus_vectored).
+
+    dir  : HAL_BUS_SEG_READ (data rempli) ou HAL_BUS_SEG_WRITE (data lu)
+*/
+#define HAL_BUS_SEG_READ   0u
+#define HAL_BUS_SEG_WRITE  1u
+
+typedef struct {
+    uint8_t dev_addr;
+    uint8_t reg;
+    uint8_t dir;
+    uint8_t *data;
+    size_t len;
+} hal_bus_seg_t;
+
 /*
     Structure représentant un bus HAL.
 
     Le driver ne sait pas ce qu'il y a dedans,
     il appelle seulement les fonctions.
+
+    ctx / reg_read / reg_write suffisent : un backend antérieur à xfer,
+    qui remplit la structure champ par champ, reste valide. Le driver
+    ne lit jamais xfer de lui-même (voir sensor_set_bus_xfer).
 */
 typedef struct {
 
@@ -81,4 +102,61 @@ typedef struct {
         size_t len
     );
 
+    /*
+        Transfert vectorisé (optionnel, NULL = repli générique).
+
+        Lu seulement par qui sait que le backend le renseigne :
+        hal_bus_vectored() (décorateurs host de ce dépôt, dont les
+        backends passent par hal_bus_init) ou le driver après
+        sensor_set_bus_xfer().
+
+        Exécute segs[0..n-1] dans l'ordre, en une seule opération bus :
+        restart entre les segments quand le bus le permet (I2C), un seul
+        aller-retour vers le contrôleur ou le simulateur.
+
+        Renvoie HAL_OK, ou le statut du premier segment en échec.
+        Les segments qui le suivent peuvent ne pas avoir été exécutés.
+    */
+    hal_status_t (*xfer)(
+        void *ctx,
+        const hal_bus_seg_t *segs,
+        size_t n
+    );
+
 } hal_bus_t;
+
+/*
+    Met toutes les fonctions à NULL, xfer compris.
+    Les backends de ce dépôt l'appellent avant de se renseigner.
+*/
+static inline void hal_bus_init(hal_bus_t *bus)
+{
+    memset(bus, 0, sizeof(*bus));
+}
+
+/*
+    Repli générique : un appel reg_read / reg_write par segment,
+    arrêt au premier échec.
+*/
+static inline hal_status_t hal_bus_vectored_generic(const hal_bus_t *bus, const hal_bus_seg_t *segs, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        const hal_bus_seg_t *sg = &segs[i];
+        hal_status_t st = (sg->dir == HAL_BUS_SEG_WRITE)
+            ? bus->reg_write(bus->ctx, sg->dev_addr, sg->reg, sg->data, sg->len)
+            : bus->reg_read(bus->ctx, sg->dev_addr, sg->reg, sg->data, sg->len);
+        if (st != HAL_OK) {
+            return st;
+        }
+    }
+    return HAL_OK;
+}
+
+/*
+    Transfert vectorisé : natif si le backend le fournit, générique sinon.
+    bus->xfer doit être valide ou NULL (voir hal_bus_t::xfer).
+*/
+static inline hal_status_t hal_bus_vectored(const hal_bus_t *bus, const hal_bus_seg_t *segs, size_t n)
+{
+    return bus->xfer ? bus->xfer(bus->ctx, segs, n) : hal_bus_vectored_generic(bus, segs, n);
+}
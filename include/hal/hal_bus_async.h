@@ -0,0 +1,105 @@
+#pragma once
+/*
+    hal_bus_async.h
+
+    Interface HAL pour des transactions bus asynchrones.
+
+    Contrairement à hal_bus_t (appels bloquants), ici on :
+    - prend un descripteur de transaction dans un pool fixe
+    - le soumet (submit) : l'appel rend la main tout de suite
+    - récupère la fin de transaction par callback ou par poll
+
+    -> Un seul thread d'acquisition peut ainsi garder plusieurs
+       transferts en vol, comme avec un bus piloté par DMA.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hal/hal_bus.h"
+
+/*
+    Sens de la transaction.
+*/
+typedef enum {
+    HAL_XFER_READ = 0,   // reg_read
+    HAL_XFER_WRITE = 1   // reg_write
+} hal_xfer_dir_t;
+
+typedef struct hal_bus_xfer hal_bus_xfer_t;
+
+/*
+    Callback de fin de transaction.
+
+    Appelé depuis le contexte du backend (thread worker, ISR DMA...),
+    il doit donc rester court.
+*/
+typedef void (*hal_bus_xfer_cb_t)(hal_bus_xfer_t *xfer);
+
+/*
+    Descripteur de transaction.
+
+    Rempli par l'appelant avant submit(), sauf :
+    - status : écrit par le backend à la fin de la transaction
+    - next   : usage interne du backend
+*/
+struct hal_bus_xfer {
+    hal_xfer_dir_t dir;
+    uint8_t dev_addr;
+    uint8_t reg;
+    uint8_t *data;       // buffer appelant, doit vivre jusqu'à la fin
+    size_t len;
+
+    /*
+        Si on_done est non NULL, il est appelé à la fin et le descripteur
+        n'est PAS renvoyé par poll(). Sinon il est rangé dans la file
+        de complétion.
+    */
+    hal_bus_xfer_cb_t on_done;
+    void *user;
+
+    hal_status_t status;
+    hal_bus_xfer_t *next;
+};
+
+/*
+    Structure représentant un bus HAL asynchrone.
+*/
+typedef struct {
+
+    /*
+        Contexte du backend (jamais utilisé directement par l'appelant).
+    */
+    void *ctx;
+
+    /*
+        Prend un descripteur libre dans le pool.
+        Renvoie NULL si tous les descripteurs sont en vol.
+    */
+    hal_bus_xfer_t *(*xfer_alloc)(void *ctx);
+
+    /*
+        Rend un descripteur terminé au pool.
+    */
+    void (*xfer_free)(void *ctx, hal_bus_xfer_t *xfer);
+
+    /*
+        Soumet une transaction. Ne bloque pas.
+    */
+    hal_status_t (*submit)(void *ctx, hal_bus_xfer_t *xfer);
+
+    /*
+        Récupère jusqu'à max transactions terminées (sans callback).
+
+        - timeout_ms : 0 = non bloquant, sinon attente maximale
+                       de la première complétion
+
+        Renvoie le nombre de descripteurs écrits dans done[].
+    */
+    size_t (*poll)(
+        void *ctx,
+        hal_bus_xfer_t **done,
+        size_t max,
+        uint32_t timeout_ms
+    );
+
+} hal_bus_async_t;
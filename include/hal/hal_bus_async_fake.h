@@ -0,0 +1,74 @@
+#pragma once
+/*
+    hal_bus_async_fake.h
+
+    Implémentation "host" (macOS/PC) de la HAL bus asynchrone.
+
+    Principe :
+    - un thread worker exécute les transactions soumises,
+      dans l'ordre, sur un hal_bus_t bloquant (ex: le fake bus)
+    - l'appelant ne bloque jamais dans submit()
+
+    -> Reproduit le comportement d'un bus DMA sur cible.
+*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "hal/hal_bus_async.h"
+
+/*
+    Nombre de descripteurs du pool (transactions en vol max).
+*/
+#define HAL_BUS_ASYNC_FAKE_POOL_SIZE 32
+
+/*
+    Contexte interne.
+
+    pool[]           : descripteurs
+    free_list        : descripteurs libres
+    sq_head/sq_tail  : file de soumission (FIFO)
+    cq_head/cq_tail  : file de complétion (FIFO, sans callback)
+    running          : le worker doit continuer (protégé par lock)
+    alive            : contexte initialisé ; remis à 0 par le premier
+                       deinit, avant de toucher au mutex
+*/
+typedef struct {
+    const hal_bus_t *backend;
+
+    hal_bus_xfer_t pool[HAL_BUS_ASYNC_FAKE_POOL_SIZE];
+    hal_bus_xfer_t *free_list;
+
+    hal_bus_xfer_t *sq_head;
+    hal_bus_xfer_t *sq_tail;
+    hal_bus_xfer_t *cq_head;
+    hal_bus_xfer_t *cq_tail;
+
+    pthread_mutex_t lock;
+    pthread_cond_t sq_cond;
+    pthread_cond_t cq_cond;
+    pthread_t worker;
+    int running;
+    atomic_int alive;
+} hal_bus_async_fake_ctx_t;
+
+/*
+    Initialise le bus asynchrone et démarre le thread worker.
+
+    Paramètres :
+    - ctx     : contexte (alloué par l'utilisateur)
+    - async   : interface à remplir
+    - backend : bus bloquant sur lequel exécuter les transactions
+
+    Renvoie HAL_ERR si le thread n'a pas pu être créé.
+*/
+hal_status_t hal_bus_async_fake_init(
+    hal_bus_async_fake_ctx_t *ctx,
+    hal_bus_async_t *async,
+    const hal_bus_t *backend
+);
+
+/*
+    Arrête le worker après avoir exécuté les transactions déjà soumises.
+    Un second appel ne fait rien.
+*/
+void hal_bus_async_fake_deinit(hal_bus_async_fake_ctx_t *ctx);
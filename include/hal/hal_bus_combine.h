@@ -0,0 +1,82 @@
+#pragma once
+/*
+    hal_bus_combine.h
+
+    Bus partagé entre threads, arbitré par combinaison (flat combining).
+
+    Au lieu d'un mutex pris à chaque transaction :
+    - chaque thread publie sa requête dans son propre enregistrement
+      (pas de contention sur une file commune)
+    - le thread qui obtient le verrou devient combineur : il exécute
+      d'un trait toutes les requêtes publiées, puis rend le verrou
+    - les autres attendent que leur enregistrement passe à "fait"
+
+    Le bus enveloppé ne voit qu'un thread à la fois, les transactions
+    s'enchaînent sans passage de verrou entre elles, et chaque requête
+    publiée est servie au plus tard par le combineur suivant (équité).
+
+    Les enregistrements sont pris dans une hal_thread_slots : celui d'un
+    thread terminé est repris par le suivant. Au-delà de
+    HAL_BUS_COMBINE_MAX_THREADS threads vivants, les suivants prennent
+    le verrou et exécutent leur requête eux-mêmes (toujours correct,
+    sans combinaison).
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "hal/hal_bus.h"
+#include "hal/hal_thread_slot.h"
+
+#define HAL_BUS_COMBINE_MAX_THREADS HAL_THREAD_SLOTS_MAX
+
+/* Passes max d'un combineur (borne sa latence propre) */
+#define HAL_BUS_COMBINE_PASSES 3
+
+/*
+    Enregistrement de publication d'un thread (une ligne de cache).
+*/
+typedef struct {
+    _Alignas(64) _Atomic uint32_t state;   // vide / publiée / faite
+    hal_status_t status;
+    const hal_bus_seg_t *segs;
+    size_t n;
+} hal_bus_combine_rec_t;
+
+/*
+    Contexte du bus partagé.
+
+    requests / batches : requêtes servies par un combineur / sessions de
+    combinaison ayant servi au moins une requête
+    (taille moyenne de lot = requests / batches)
+*/
+typedef struct {
+    hal_bus_t inner;
+
+    _Alignas(64) _Atomic uint32_t lock;
+
+    hal_thread_slots_t recs;   // hal_bus_combine_rec_t par thread
+    unsigned next_scan;    // départ tournant du balayage (sous lock)
+
+    _Atomic uint64_t requests;
+    _Atomic uint64_t batches;
+} hal_bus_combine_ctx_t;
+
+/*
+    Enveloppe inner (qui n'a pas besoin d'être thread-safe) et remplit bus,
+    utilisable depuis plusieurs threads.
+
+    HAL_ERR si un argument manque ou si la table de threads n'a pas
+    pu être créée.
+*/
+hal_status_t hal_bus_combine_init(
+    hal_bus_combine_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner
+);
+
+/*
+    Libère les enregistrements (plus aucune transaction en cours).
+*/
+void hal_bus_combine_deinit(hal_bus_combine_ctx_t *ctx);
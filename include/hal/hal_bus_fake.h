@@ -9,10 +9,23 @@
     - on simule un capteur "register-based" avec un tableau de 256 registres
     - le driver appelle bus->reg_read / bus->reg_write
     - ici, on lit/écrit dans le tableau regs[]
+    - une FIFO d'échantillons simulée est lisible en rafale via FIFO_DATA
+
+    Deux variantes :
+    - hal_bus_fake_init()       : un seul capteur, dev_addr ignoré
+    - hal_bus_fake_multi_init() : un bus avec un capteur par adresse
+                                  (simulation de flotte, un contexte par bus)
 */
 
 #include "hal/hal_bus.h"
 #include <stdint.h>
+#include <stddef.h>
+
+/*
+    Profondeur de la FIFO simulée (en échantillons 16 bits).
+    Doit correspondre à SENSOR_FIFO_DEPTH (sensor.h).
+*/
+#define HAL_BUS_FAKE_FIFO_DEPTH 32
 
 /*
     Contexte interne du fake bus.
@@ -22,10 +35,23 @@
 
     fake_temp_centi :
       température simulée en centi-degrés (ex: 2500 = 25.00°C)
+
+    fifo[], fifo_head, fifo_count :
+      FIFO circulaire d'échantillons produits par le capteur simulé
+      (le plus ancien est à fifo_head).
+
+    fifo_overrun :
+      passe à 1 quand un échantillon a été perdu (FIFO pleine),
+      remis à 0 par la lecture de FIFO_STATUS.
 */
 typedef struct {
     uint8_t regs[256];
     int16_t fake_temp_centi;
+
+    int16_t fifo[HAL_BUS_FAKE_FIFO_DEPTH];
+    uint8_t fifo_head;
+    uint8_t fifo_count;
+    uint8_t fifo_overrun;
 } hal_bus_fake_ctx_t;
 
 /*
@@ -39,6 +65,92 @@ typedef struct {
     - reset regs
     - met WHO_AM_I à la valeur attendue par le driver
     - initialise une température de départ
-    - configure les pointeurs de fonctions reg_read/reg_write
+    - configure les pointeurs de fonctions reg_read/reg_write/xfer
 */
 void hal_bus_fake_init(hal_bus_fake_ctx_t *ctx, hal_bus_t *bus);
+
+/*
+    Fonctions reg_read / reg_write / xfer du bus mono-capteur.
+
+    Normalement appelées via hal_bus_t ; exposées pour la liaison
+    statique (hal_bind_host.h), où ctx est le hal_bus_fake_ctx_t.
+*/
+hal_status_t hal_bus_fake_reg_read(
+    void *ctx,
+    uint8_t dev_addr,
+    uint8_t reg,
+    uint8_t *data,
+    size_t len
+);
+
+hal_status_t hal_bus_fake_reg_write(
+    void *ctx,
+    uint8_t dev_addr,
+    uint8_t reg,
+    const uint8_t *data,
+    size_t len
+);
+
+hal_status_t hal_bus_fake_xfer(
+    void *ctx,
+    const hal_bus_seg_t *segs,
+    size_t n
+);
+
+/*
+    Initialise uniquement le capteur simulé (sans configurer de bus).
+
+    Même état de départ que hal_bus_fake_init() ; utile pour les capteurs
+    branchés sur un bus multi-capteurs.
+*/
+void hal_bus_fake_dev_init(hal_bus_fake_ctx_t *ctx);
+
+/*
+    Simule la production de n échantillons par le capteur.
+
+    Chaque échantillon suit le même modèle que la température simulée
+    (+0.05°C par pas) et est poussé dans la FIFO.
+    Si la FIFO est pleine, le plus ancien échantillon est écrasé
+    et le drapeau d'overrun est levé (comme un capteur en mode "stream").
+*/
+void hal_bus_fake_fifo_fill(hal_bus_fake_ctx_t *ctx, size_t n);
+
+/*
+    Nombre d'adresses d'un bus multi-capteurs (adresses I2C 7 bits).
+*/
+#define HAL_BUS_FAKE_MAX_DEVICES 128
+
+/*
+    Contexte d'un bus multi-capteurs.
+
+    devices[addr] :
+      capteur simulé qui répond à l'adresse addr (NULL = personne).
+      Table directe : la résolution d'adresse est en O(1).
+      Les capteurs sont alloués par l'utilisateur.
+
+    nack_count :
+      nombre de transactions vers une adresse sans capteur.
+*/
+typedef struct {
+    hal_bus_fake_ctx_t *devices[HAL_BUS_FAKE_MAX_DEVICES];
+    uint32_t nack_count;
+} hal_bus_fake_multi_ctx_t;
+
+/*
+    Initialise un bus multi-capteurs vide.
+
+    Pour simuler plusieurs bus, on utilise un contexte (et un hal_bus_t)
+    par bus.
+*/
+void hal_bus_fake_multi_init(hal_bus_fake_multi_ctx_t *ctx, hal_bus_t *bus);
+
+/*
+    Branche le capteur dev à l'adresse dev_addr (dev == NULL : débranche).
+
+    Renvoie HAL_ERR si l'adresse est hors plage.
+*/
+hal_status_t hal_bus_fake_multi_attach(
+    hal_bus_fake_multi_ctx_t *ctx,
+    uint8_t dev_addr,
+    hal_bus_fake_ctx_t *dev
+);
@@ -0,0 +1,147 @@
+#pragma once
+/*
+    hal_bus_fake_fleet.h
+
+    Simulation de très grandes flottes de capteurs (jusqu'au million).
+
+    hal_bus_fake_ctx_t stocke 256 registres complets par capteur :
+    trop lourd pour 1M de capteurs et mauvais pour le cache.
+    Ici, chaque capteur simulé est compact (16 octets) :
+
+    - les registres jamais écrits sont lus dans une page modèle
+      partagée par tous les capteurs (hal_fake_model_t)
+    - les quelques registres écrits sont stockés dans le capteur
+      (HAL_FAKE_SPARSE_INLINE entrées max)
+    - au-delà, le capteur reçoit une page privée, copiée depuis
+      le modèle (copy-on-write)
+    - les registres volatils (TEMP_MSB/LSB, FIFO) ne sont jamais stockés :
+      ils sont générés à la lecture
+
+    Tous les capteurs sont dans un seul tableau contigu, indexé par
+    (bus, adresse) : résolution en O(1), balayage cache-friendly.
+
+    Limite : pas de FIFO dans ce modèle (FIFO_STATUS lit toujours 0).
+*/
+
+#include "hal/hal_bus.h"
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+    Nombre de registres écrits stockés dans le capteur avant la copie de page.
+*/
+#define HAL_FAKE_SPARSE_INLINE 4
+
+/*
+    Modèle de capteur (partagé, lecture seule après init).
+
+    regs[]           : valeurs au reset de tous les registres
+    volatile_map[]   : bitmap des registres générés à la lecture
+    temp_start_centi : température initiale de chaque capteur
+    temp_step_centi  : pas de température par lecture
+*/
+typedef struct {
+    uint8_t regs[256];
+    uint8_t volatile_map[256 / 8];
+    int16_t temp_start_centi;
+    int16_t temp_step_centi;
+} hal_fake_model_t;
+
+/*
+    Capteur simulé compact (16 octets).
+
+    page       : index (1-based) de la page privée dans la flotte, 0 = aucune
+    temp_centi : température simulée courante
+    n_inline   : nombre d'entrées inline utilisées
+*/
+typedef struct {
+    uint32_t page;
+    int16_t temp_centi;
+    uint8_t n_inline;
+    uint8_t reserved;
+    uint8_t inline_reg[HAL_FAKE_SPARSE_INLINE];
+    uint8_t inline_val[HAL_FAKE_SPARSE_INLINE];
+} hal_fake_sparse_dev_t;
+
+struct hal_bus_fake_fleet;
+
+/*
+    Port : ce que voit un hal_bus_t (un port par bus simulé).
+*/
+typedef struct {
+    struct hal_bus_fake_fleet *fleet;
+    uint32_t bus_index;
+} hal_bus_fake_fleet_port_t;
+
+/*
+    Flotte de capteurs simulés.
+
+    Le capteur (bus b, adresse a) est devs[b * devs_per_bus + (a - addr_base)].
+*/
+typedef struct hal_bus_fake_fleet {
+    const hal_fake_model_t *model;
+
+    hal_fake_sparse_dev_t *devs;
+    uint32_t n_buses;
+    uint16_t devs_per_bus;
+    uint8_t addr_base;
+
+    hal_bus_fake_fleet_port_t *ports;
+
+    uint8_t (*pages)[256];   // pages privées (copy-on-write)
+    uint32_t n_pages;
+    uint32_t cap_pages;
+
+    uint64_t nack_count;
+} hal_bus_fake_fleet_t;
+
+/*
+    Remplit un modèle avec le capteur par défaut
+    (même comportement que hal_bus_fake : WHO_AM_I = 0x42, 25.00°C, +0.05°C).
+*/
+void hal_fake_model_init_default(hal_fake_model_t *model);
+
+/*
+    Crée une flotte de n_buses * devs_per_bus capteurs.
+
+    - model        : modèle partagé (doit vivre aussi longtemps que la flotte)
+    - addr_base    : adresse du premier capteur sur chaque bus
+    - devs_per_bus : capteurs par bus (addr_base + devs_per_bus <= 128)
+
+    Renvoie HAL_ERR si les paramètres sont invalides ou si l'allocation échoue.
+*/
+hal_status_t hal_bus_fake_fleet_init(
+    hal_bus_fake_fleet_t *fleet,
+    const hal_fake_model_t *model,
+    uint32_t n_buses,
+    uint16_t devs_per_bus,
+    uint8_t addr_base
+);
+
+/*
+    Libère la flotte (capteurs, ports, pages privées).
+*/
+void hal_bus_fake_fleet_deinit(hal_bus_fake_fleet_t *fleet);
+
+/*
+    Configure bus pour parler au bus simulé bus_index de la flotte.
+*/
+hal_status_t hal_bus_fake_fleet_bus(
+    hal_bus_fake_fleet_t *fleet,
+    uint32_t bus_index,
+    hal_bus_t *bus
+);
+
+/*
+    Accès direct à un capteur simulé (NULL si hors flotte).
+*/
+hal_fake_sparse_dev_t *hal_bus_fake_fleet_dev(
+    hal_bus_fake_fleet_t *fleet,
+    uint32_t bus_index,
+    uint8_t dev_addr
+);
+
+/*
+    Mémoire totale utilisée par la flotte (en octets).
+*/
+size_t hal_bus_fake_fleet_memory(const hal_bus_fake_fleet_t *fleet);
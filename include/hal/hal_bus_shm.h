@@ -0,0 +1,128 @@
+#pragma once
+/*
+    hal_bus_shm.h
+
+    Bus vers un simulateur de capteurs hors processus, par mémoire partagée.
+
+    Le driver (client) et le simulateur (serveur) partagent une région :
+    - HAL_BUS_SHM_SLOTS emplacements de transaction ; les données sont
+      dans l'emplacement, le modèle du serveur les lit / écrit sur place
+    - une machine d'état par emplacement :
+        FREE -> CLAIMED (client remplit) -> POSTED -> TAKEN (serveur
+        exécute) -> DONE -> FREE (client a relu le résultat)
+
+    Réveils : futex partagé sous Linux (attente active courte d'abord,
+    appel système seulement si l'autre côté dort), sinon attente par
+    petites pauses.
+
+    Un transfert vectorisé (hal_bus_t::xfer) occupe un emplacement par
+    segment, chaînés : seule la tête est publiée et attendue, le serveur
+    exécute la chaîne d'un trait (un réveil pour n segments).
+
+    Côté client, plusieurs threads peuvent utiliser le même bus :
+    chacun prend ses emplacements libres.
+    Côté serveur, un seul thread sert la région (hal_bus_shm_serve).
+    Un simulateur mort en pleine transaction peut être remplacé : le
+    nouveau serveur reprend au démarrage les emplacements de l'ancien
+    (le client en attente reçoit HAL_ERR).
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "hal/hal_bus.h"
+
+#define HAL_BUS_SHM_SLOTS    32
+#define HAL_BUS_SHM_MAX_LEN  256
+
+/* Attente max d'une réponse du simulateur (mort, bloqué) */
+#define HAL_BUS_SHM_TIMEOUT_MS 1000
+
+#define HAL_BUS_SHM_MAGIC   0x48534D42u  // "BMSH"
+#define HAL_BUS_SHM_VERSION 2u
+
+#define HAL_BUS_SHM_END     0xFFu
+
+/*
+    Emplacement de transaction (une ligne de cache pour l'en-tête).
+*/
+typedef struct {
+    _Alignas(64) _Atomic uint32_t state;
+    uint8_t op;            // 0 = lecture, 1 = écriture
+    uint8_t dev_addr;
+    uint8_t reg;
+    int8_t status;
+    uint8_t next;          // maillon suivant de la chaîne (HAL_BUS_SHM_END = dernier)
+    uint32_t len;
+    uint8_t data[HAL_BUS_SHM_MAX_LEN];
+} hal_bus_shm_slot_t;
+
+/*
+    Région partagée.
+
+    req_seq        : incrémenté à chaque requête (mot du futex serveur)
+    server_waiting : le serveur dort sur req_seq
+    stop           : arrêt demandé au serveur
+*/
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    _Alignas(64) _Atomic uint32_t req_seq;
+    _Atomic uint32_t server_waiting;
+    _Atomic uint32_t stop;
+    hal_bus_shm_slot_t slots[HAL_BUS_SHM_SLOTS];
+} hal_bus_shm_region_t;
+
+/*
+    Poignée locale sur la région (une par processus).
+
+    timeout_ms : attente max d'une réponse côté client
+*/
+typedef struct {
+    hal_bus_shm_region_t *region;
+    int owner;             // créateur : détruit le nom au détachement
+    char name[64];
+    uint32_t timeout_ms;
+} hal_bus_shm_t;
+
+/*
+    Crée la région.
+
+    name != NULL : objet POSIX nommé (shm_open), à rattacher depuis le
+                   simulateur avec hal_bus_shm_attach
+    name == NULL : mapping anonyme partagé, hérité par fork()
+*/
+hal_status_t hal_bus_shm_create(hal_bus_shm_t *shm, const char *name);
+
+/*
+    Rattache une région nommée créée par un autre processus.
+*/
+hal_status_t hal_bus_shm_attach(hal_bus_shm_t *shm, const char *name);
+
+/*
+    Démappe la région (et supprime le nom si on l'a créée).
+*/
+void hal_bus_shm_detach(hal_bus_shm_t *shm);
+
+/*
+    Côté driver : remplit bus (xfer natif), chaque transaction est
+    envoyée au simulateur.
+
+    Erreurs : HAL_ERR si un len > HAL_BUS_SHM_MAX_LEN,
+              HAL_TIMEOUT si le simulateur ne répond pas.
+*/
+hal_status_t hal_bus_shm_client_init(hal_bus_shm_t *shm, hal_bus_t *bus);
+
+/*
+    Côté simulateur : sert les transactions sur model (ex : fake bus
+    multi-capteurs) jusqu'à hal_bus_shm_shutdown. Renvoie le nombre servi.
+
+    Un emplacement mal formé (op inconnue, len > HAL_BUS_SHM_MAX_LEN)
+    reçoit HAL_ERR sans appel au modèle.
+*/
+uint64_t hal_bus_shm_serve(hal_bus_shm_t *shm, const hal_bus_t *model);
+
+/*
+    Demande l'arrêt du serveur (appelable des deux côtés).
+*/
+void hal_bus_shm_shutdown(hal_bus_shm_t *shm);
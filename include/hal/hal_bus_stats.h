@@ -0,0 +1,136 @@
+#pragma once
+/*
+    hal_bus_stats.h
+
+    Décorateur d'instrumentation pour hal_bus_t.
+
+    Il enveloppe n'importe quel bus (fake, flotte, vrai backend) et
+    transmet chaque transaction en comptant :
+    - par adresse capteur : lectures, écritures, octets, erreurs,
+      timeouts, latence (totale, max, histogramme log2)
+    - par registre de départ : lectures, écritures, octets
+
+    Chemin chaud sans verrou : chaque thread écrit dans ses propres
+    compteurs (hal_thread_slots : alloués à sa première transaction,
+    repris par un nouveau thread quand il se termine, sans remise à
+    zéro). Un instantané additionne les compteurs de tous les threads.
+
+    La latence est mesurée avec la HAL time fournie (NULL = pas de mesure).
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "hal/hal_bus.h"
+#include "hal/hal_time.h"
+#include "hal/hal_thread_slot.h"
+
+#define HAL_BUS_STATS_MAX_THREADS  HAL_THREAD_SLOTS_MAX
+#define HAL_BUS_STATS_DEVICES      256  // toutes les adresses 8 bits
+#define HAL_BUS_STATS_REGS         256
+
+/*
+    Histogramme de latence : bucket k = [2^(k-1), 2^k) ns (bucket 0 = 0 ns),
+    le dernier bucket reçoit tout ce qui dépasse.
+*/
+#define HAL_BUS_STATS_HIST_BUCKETS 24
+
+/*
+    Compteurs d'un capteur (instantané).
+*/
+typedef struct {
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    uint64_t errors;
+    uint64_t timeouts;
+    uint64_t lat_total_ns;
+    uint64_t lat_max_ns;
+    uint64_t hist[HAL_BUS_STATS_HIST_BUCKETS];
+} hal_bus_stats_dev_t;
+
+/*
+    Compteurs d'un registre de départ (instantané, tous capteurs).
+*/
+typedef struct {
+    uint64_t reads;
+    uint64_t writes;
+    uint64_t bytes;
+} hal_bus_stats_reg_t;
+
+/*
+    Instantané complet (~75 Ko : à allouer en statique ou sur le tas).
+*/
+typedef struct {
+    hal_bus_stats_dev_t dev[HAL_BUS_STATS_DEVICES];
+    hal_bus_stats_reg_t reg[HAL_BUS_STATS_REGS];
+    hal_bus_stats_dev_t total;
+    uint64_t uncounted;   // transactions au-delà de HAL_BUS_STATS_MAX_THREADS threads vivants
+} hal_bus_stats_snapshot_t;
+
+/*
+    Compteurs d'un thread (écrits par ce thread seul).
+*/
+typedef struct {
+    _Atomic uint64_t c[6];  // reads, writes, bytes_read, bytes_written, errors, timeouts
+    _Atomic uint64_t lat_total_ns;
+    _Atomic uint64_t lat_max_ns;
+    _Atomic uint64_t hist[HAL_BUS_STATS_HIST_BUCKETS];
+} hal_bus_stats_dev_shard_t;
+
+typedef struct {
+    _Atomic uint64_t c[3];  // reads, writes, bytes
+} hal_bus_stats_reg_shard_t;
+
+typedef struct {
+    hal_bus_stats_dev_shard_t dev[HAL_BUS_STATS_DEVICES];
+    hal_bus_stats_reg_shard_t reg[HAL_BUS_STATS_REGS];
+} hal_bus_stats_shard_t;
+
+/*
+    Contexte du décorateur.
+*/
+typedef struct {
+    hal_bus_t inner;          // bus enveloppé (copie)
+    const hal_time_t *time;   // horloge de latence (NULL ou sans now_ns = aucune)
+
+    hal_thread_slots_t shards;   // hal_bus_stats_shard_t par thread
+
+    _Atomic uint64_t uncounted;
+} hal_bus_stats_ctx_t;
+
+/*
+    Initialise le décorateur autour de inner et remplit bus.
+*/
+hal_status_t hal_bus_stats_init(
+    hal_bus_stats_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner,
+    const hal_time_t *time
+);
+
+/*
+    Libère les compteurs (plus aucune transaction ne doit être en cours).
+*/
+void hal_bus_stats_deinit(hal_bus_stats_ctx_t *ctx);
+
+/*
+    Additionne les compteurs de tous les threads.
+    Peut être appelé pendant le trafic (valeurs à quelques transactions près).
+*/
+void hal_bus_stats_snapshot(hal_bus_stats_ctx_t *ctx, hal_bus_stats_snapshot_t *snap);
+
+/*
+    Borne haute de la latence au percentile pct (0..100), depuis l'histogramme.
+*/
+uint64_t hal_bus_stats_percentile_ns(const hal_bus_stats_dev_t *dev, unsigned pct);
+
+/*
+    Classements : remplit out[] avec au plus n adresses / registres,
+    du plus lent (latence moyenne) / plus sollicité (transactions) au moins.
+    Retourne le nombre écrit.
+*/
+size_t hal_bus_stats_slowest_devices(const hal_bus_stats_snapshot_t *snap, uint8_t *out, size_t n);
+size_t hal_bus_stats_hottest_regs(const hal_bus_stats_snapshot_t *snap, uint8_t *out, size_t n);
@@ -0,0 +1,137 @@
+#pragma once
+/*
+    hal_bus_timing.h
+
+    Modèle de temps de fil I2C / SPI pour les bus simulés.
+
+    Les bus simulés répondent instantanément. Ce décorateur facture à
+    chaque transaction son coût réel sur le fil, en périodes d'horloge
+    bus, sur une horloge simulée (hal_time_sim) :
+
+    I2C (adresse 7 bits, écriture du registre puis restart pour lire) :
+      lecture  : S + adr/W + ACK + reg + ACK + Sr + adr/R + ACK
+                 + len x (8 + ACK) + P              = 30 + 9 x len périodes
+      écriture : S + adr/W + ACK + reg + ACK + len x (8 + ACK) + P
+                                                    = 20 + 9 x len périodes
+      NACK     : S + adr + NACK + P                 = 11 périodes
+      (S, Sr, P comptés une période chacun)
+      puis gap_ns de bus libre (tBUF) avant la transaction suivante.
+
+    SPI (CS par capteur, octet de commande puis données) :
+      8 + 8 x len périodes, puis gap_ns (CS setup/hold + inactivité).
+
+    Le bus a sa propre ligne de temps : une transaction commence au plus
+    tôt quand le bus est libre. Deux usages :
+    - advance_clock = 1 : l'appelant attend la fin du transfert (l'horloge
+      simulée avance), comme un driver bloquant sur un seul bus
+    - advance_clock = 0 : l'horloge n'est pas touchée (plusieurs bus
+      partagent une horloge d'ordonnanceur) ; seule l'occupation est comptée
+
+    Dimensionnement : capteurs par bus ~ 1e9 / (fréquence de scrutation
+    x coût d'un cycle de scrutation en ns), à comparer à utilization_ppm.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hal/hal_bus.h"
+#include "hal/hal_time_sim.h"
+
+typedef enum {
+    HAL_BUS_WIRE_I2C = 0,
+    HAL_BUS_WIRE_SPI = 1
+} hal_bus_wire_t;
+
+/*
+    Paramètres du fil.
+
+    clock_hz : horloge SCL / SCK
+    gap_ns   : temps mort imposé après chaque transaction
+*/
+typedef struct {
+    hal_bus_wire_t wire;
+    uint32_t clock_hz;
+    uint32_t gap_ns;
+} hal_bus_timing_cfg_t;
+
+/* Modes I2C standard (tBUF minimal de la spécification I2C), initialiseurs */
+#define HAL_BUS_TIMING_I2C_100K  { HAL_BUS_WIRE_I2C, 100000u, 4700u }
+#define HAL_BUS_TIMING_I2C_400K  { HAL_BUS_WIRE_I2C, 400000u, 1300u }
+#define HAL_BUS_TIMING_I2C_1M    { HAL_BUS_WIRE_I2C, 1000000u, 500u }
+
+/* SPI à hz, 100 ns de CS inactif entre transactions */
+#define HAL_BUS_TIMING_SPI(hz)   { HAL_BUS_WIRE_SPI, (hz), 100u }
+
+/*
+    Contexte du décorateur.
+
+    bus_free_ns  : date où le bus redevient libre
+    busy_ns      : temps de fil cumulé (gaps compris)
+    wait_ns      : attente cumulée d'un bus occupé (advance_clock = 0)
+*/
+typedef struct {
+    hal_bus_t inner;
+    hal_bus_timing_cfg_t cfg;
+    hal_time_sim_ctx_t *clock;
+    int advance_clock;
+
+    uint64_t t_start_ns;
+    uint64_t bus_free_ns;
+    uint64_t busy_ns;
+    uint64_t wait_ns;
+    uint64_t transactions;
+    uint64_t bytes;
+} hal_bus_timing_ctx_t;
+
+/*
+    Rapport d'occupation depuis l'init (ou le dernier reset).
+
+    utilization_ppm : busy_ns / elapsed_ns, en millionièmes
+*/
+typedef struct {
+    uint64_t elapsed_ns;
+    uint64_t busy_ns;
+    uint64_t wait_ns;
+    uint64_t transactions;
+    uint64_t bytes;
+    uint32_t utilization_ppm;
+} hal_bus_timing_report_t;
+
+/*
+    Enveloppe inner ; chaque transaction est facturée sur clock.
+    Renvoie HAL_ERR si clock_hz vaut 0.
+*/
+hal_status_t hal_bus_timing_init(
+    hal_bus_timing_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner,
+    const hal_bus_timing_cfg_t *cfg,
+    hal_time_sim_ctx_t *clock,
+    int advance_clock
+);
+
+/*
+    Coût sur le fil d'une transaction (gap compris), sans l'exécuter.
+*/
+uint64_t hal_bus_timing_cost_ns(
+    const hal_bus_timing_cfg_t *cfg,
+    int is_write,
+    size_t len,
+    hal_status_t status
+);
+
+/*
+    Coût d'un transfert vectorisé (hal_bus_t::xfer) : une seule
+    transaction, Sr entre segments en I2C ; une trame CS par segment en SPI.
+*/
+uint64_t hal_bus_timing_xfer_cost_ns(
+    const hal_bus_timing_cfg_t *cfg,
+    const hal_bus_seg_t *segs,
+    size_t n
+);
+
+void hal_bus_timing_report(const hal_bus_timing_ctx_t *ctx, hal_bus_timing_report_t *out);
+
+/*
+    Remet les compteurs à zéro ; la fenêtre de mesure repart de maintenant.
+*/
+void hal_bus_timing_reset(hal_bus_timing_ctx_t *ctx);
@@ -0,0 +1,178 @@
+#pragma once
+/*
+    hal_bus_trace.h
+
+    Enregistrement / rejeu des transactions d'un hal_bus_t (POSIX).
+
+    Enregistreur : décorateur autour d'un bus existant. Chaque transaction
+    (capteur, registre, sens, statut, données, date) est ajoutée à un
+    fichier trace mappé en mémoire, agrandi par doublement.
+
+    Rejoueur : backend hal_bus_t qui sert les transactions depuis la trace,
+    sans délai (vitesse maximale) et de façon déterministe. Il fournit
+    aussi un hal_time_t qui renvoie la date enregistrée de la transaction
+    courante : le driver voit la même horloge qu'à l'enregistrement.
+
+    Format (petit-boutiste, comme la machine d'enregistrement) :
+    - en-tête de 64 octets (hal_bus_trace_header_t)
+    - enregistrements compacts, non alignés :
+        dt_ns (u32), len (u16), dev (u8), reg (u8), op (u8), status (i8),
+        puis len octets de données
+      dt_ns est l'écart avec l'enregistrement précédent ; un écart qui ne
+      tient pas sur 32 bits est précédé d'un enregistrement OP_TIME
+      portant la date absolue (8 octets).
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hal/hal_bus.h"
+#include "hal/hal_time.h"
+
+#define HAL_BUS_TRACE_MAGIC    "HBTRACE1"
+#define HAL_BUS_TRACE_VERSION  1u
+
+/* Taille max des données d'une transaction enregistrée */
+#define HAL_BUS_TRACE_MAX_LEN  UINT16_MAX
+
+/* Taille initiale du fichier (doublée à chaque débordement) */
+#define HAL_BUS_TRACE_INITIAL_SIZE  (1u << 20)
+
+/*
+    Rejeu : nombre d'enregistrements examinés pour retrouver la transaction
+    demandée quand le driver s'écarte de la trace (driver modifié).
+*/
+#define HAL_BUS_TRACE_RESYNC_WINDOW 8
+
+/* Types d'enregistrement */
+#define HAL_BUS_TRACE_OP_READ   0u
+#define HAL_BUS_TRACE_OP_WRITE  1u
+#define HAL_BUS_TRACE_OP_TIME   2u
+
+#define HAL_BUS_TRACE_RECORD_HEADER 10u
+
+/*
+    En-tête du fichier.
+
+    used  : octets d'enregistrements valides après l'en-tête
+    count : nombre de transactions (hors OP_TIME)
+    t0_ns : date de référence du premier dt_ns
+*/
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t used;
+    uint64_t count;
+    uint64_t t0_ns;
+    uint8_t reserved[24];
+} hal_bus_trace_header_t;
+
+/*
+    Transaction décodée (data pointe dans le mapping).
+*/
+typedef struct {
+    uint64_t t_ns;
+    uint8_t dev_addr;
+    uint8_t reg;
+    uint8_t op;
+    hal_status_t status;
+    uint16_t len;
+    const uint8_t *data;
+} hal_bus_trace_record_t;
+
+/* ---------------- Enregistrement ---------------- */
+
+/*
+    Contexte de l'enregistreur.
+
+    Pas de verrou : comme les bus simulés, un enregistreur sert un seul
+    thread à la fois.
+*/
+typedef struct {
+    hal_bus_t inner;          // bus enregistré (copie)
+    const hal_time_t *time;   // horloge des dates (NULL = dates à 0)
+
+    int fd;
+    uint8_t *map;
+    size_t map_size;
+    hal_bus_trace_header_t *hdr;
+
+    uint64_t last_ns;
+    uint64_t dropped;         // transactions non enregistrées (fichier plein, trop longues)
+} hal_bus_trace_rec_ctx_t;
+
+/*
+    Crée le fichier path (échoue s'il existe) et enveloppe inner.
+*/
+hal_status_t hal_bus_trace_rec_init(
+    hal_bus_trace_rec_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner,
+    const hal_time_t *time,
+    const char *path
+);
+
+/*
+    Tronque le fichier à la taille utile, le synchronise et le ferme.
+*/
+hal_status_t hal_bus_trace_rec_close(hal_bus_trace_rec_ctx_t *ctx);
+
+/* ---------------- Rejeu ---------------- */
+
+/*
+    Contexte du rejoueur.
+
+    pos        : position du prochain enregistrement
+    now_ns     : date de la dernière transaction servie
+    matched    : transactions servies
+    skipped    : enregistrements sautés pour se resynchroniser
+    mismatches : transactions absentes de la trace (HAL_ERR)
+*/
+typedef struct {
+    int fd;
+    const uint8_t *map;
+    size_t map_size;
+    const hal_bus_trace_header_t *hdr;
+
+    size_t pos;
+    uint64_t pos_ns;
+    uint64_t now_ns;
+
+    uint64_t matched;
+    uint64_t skipped;
+    uint64_t mismatches;
+} hal_bus_trace_play_ctx_t;
+
+/*
+    Ouvre la trace path en lecture et remplit bus (et time si non NULL).
+*/
+hal_status_t hal_bus_trace_play_init(
+    hal_bus_trace_play_ctx_t *ctx,
+    hal_bus_t *bus,
+    hal_time_t *time,
+    const char *path
+);
+
+/*
+    Revient au début de la trace (compteurs remis à zéro).
+*/
+void hal_bus_trace_play_rewind(hal_bus_trace_play_ctx_t *ctx);
+
+/*
+    1 si toutes les transactions ont été consommées.
+*/
+int hal_bus_trace_play_done(const hal_bus_trace_play_ctx_t *ctx);
+
+void hal_bus_trace_play_close(hal_bus_trace_play_ctx_t *ctx);
+
+/*
+    Lecture séquentielle de la trace (outils d'analyse), indépendante
+    de la position du rejeu. *pos démarre à 0 (*t_ns est alors initialisé).
+    Renvoie 0 en fin de trace, 1 sinon.
+*/
+int hal_bus_trace_next(
+    const hal_bus_trace_play_ctx_t *ctx,
+    size_t *pos,
+    uint64_t *t_ns,
+    hal_bus_trace_record_t *rec
+);
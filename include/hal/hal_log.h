@@ -6,15 +6,22 @@
 
     Permet d'afficher des messages sans
     forcer printf ou un UART spécifique.
+
+    Le code driver passe par les macros HAL_LOGI / HAL_LOGW / HAL_LOGE
+    (en bas de fichier) plutôt que d'appeler log->log directement :
+    les niveaux sous HAL_LOG_MIN_LEVEL disparaissent à la compilation.
 */
 
+#include <stdint.h>
+#include <stdatomic.h>
+
 /*
     Niveaux de log standards.
 */
 typedef enum {
-    HAL_LOG_INFO,  // Information générale
-    HAL_LOG_WARN,  // Avertissement
-    HAL_LOG_ERR    // Erreur critique
+    HAL_LOG_INFO = 0,  // Information générale
+    HAL_LOG_WARN = 1,  // Avertissement
+    HAL_LOG_ERR = 2    // Erreur critique
 } hal_log_level_t;
 
 /*
@@ -45,3 +52,160 @@ typedef struct {
     );
 
 } hal_log_t;
+
+/*
+    Niveau minimal compilé (défini par le build, ex: -DHAL_LOG_MIN_LEVEL=2).
+
+    0 = tout, 1 = WARN + ERR, 2 = ERR seulement, 3 = aucun log.
+
+    En dessous de ce niveau, les macros s'expandent en ((void)0) :
+    ni appel indirect, ni évaluation des arguments.
+*/
+#ifndef HAL_LOG_MIN_LEVEL
+#define HAL_LOG_MIN_LEVEL 0
+#endif
+
+/*
+    Appel effectif (log peut être NULL : rien n'est fait).
+
+    En liaison statique (voir hal_bind.h), appel direct de hal_static_log.
+*/
+#if defined(HAL_STATIC_BINDING)
+#define HAL_LOG_AT(log_, level_, ...) do {                          \
+    const hal_log_t *hal_log_p_ = (log_);                           \
+    if (hal_log_p_) {                                               \
+        hal_static_log(hal_log_p_->ctx, (level_), __VA_ARGS__);     \
+    }                                                               \
+} while (0)
+#else
+#define HAL_LOG_AT(log_, level_, ...) do {                          \
+    const hal_log_t *hal_log_p_ = (log_);                           \
+    if (hal_log_p_ && hal_log_p_->log) {                            \
+        hal_log_p_->log(hal_log_p_->ctx, (level_), __VA_ARGS__);    \
+    }                                                               \
+} while (0)
+#endif
+
+/*
+    Limitation de débit : seau de jetons par fenêtre de temps.
+
+    Dans chaque fenêtre de HAL_LOG_RL_WINDOW_NS, les `burst` premiers
+    messages passent, les suivants sont comptés puis jetés. Le premier
+    message qui passe ensuite est précédé du nombre de messages jetés :
+    une nouvelle rafale, même des heures plus tard, reste visible.
+
+    Sans horloge (now_ns == 0), une fenêtre dure
+    HAL_LOG_RL_WINDOW_EVENTS messages au lieu d'une durée.
+
+    L'état tient dans un seul _Atomic uint64_t (fenêtre | passés |
+    jetés), mis à jour par compare-and-swap : un limiteur peut être
+    partagé entre threads. Le propriétaire (ex: un sensor_t) le garde
+    à côté de son log : une instance bavarde ne fait pas taire les autres.
+*/
+#ifndef HAL_LOG_RL_WINDOW_NS
+#define HAL_LOG_RL_WINDOW_NS 1000000000ull   // 1 s
+#endif
+
+#ifndef HAL_LOG_RL_WINDOW_EVENTS
+#define HAL_LOG_RL_WINDOW_EVENTS 1000u
+#endif
+
+#define HAL_LOG_RL_FIELD_MAX 0xFFFFu
+
+typedef struct {
+    _Atomic uint64_t state;   // fenêtre (32 bits) | passés (16) | jetés (16)
+} hal_log_ratelimit_t;
+
+/*
+    Vrai si le message peut être émis. *dropped reçoit alors le nombre
+    de messages jetés depuis le dernier message émis (0 sinon).
+*/
+static inline int hal_log_ratelimit_allow(
+    hal_log_ratelimit_t *rl,
+    uint64_t now_ns,
+    uint32_t burst,
+    uint32_t *dropped)
+{
+    uint64_t old = atomic_load_explicit(&rl->state, memory_order_relaxed);
+    uint64_t next;
+    int allow;
+
+    if (burst > HAL_LOG_RL_FIELD_MAX) {
+        burst = HAL_LOG_RL_FIELD_MAX;
+    }
+
+    do {
+        uint32_t win = (uint32_t)(old >> 32);
+        uint32_t passed = (uint32_t)(old >> 16) & HAL_LOG_RL_FIELD_MAX;
+        uint32_t lost = (uint32_t)old & HAL_LOG_RL_FIELD_MAX;
+        uint32_t cur;
+
+        if (now_ns) {
+            cur = (uint32_t)(now_ns / HAL_LOG_RL_WINDOW_NS);
+        } else {
+            cur = (passed + lost >= HAL_LOG_RL_WINDOW_EVENTS) ? win + 1u : win;
+        }
+
+        // Nouvelle fenêtre : jetons rendus, les jetés restent à signaler
+        if (cur != win) {
+            passed = 0;
+        }
+
+        allow = passed < burst;
+        *dropped = allow ? lost : 0;
+
+        if (allow) {
+            passed++;
+            lost = 0;
+        } else if (lost < HAL_LOG_RL_FIELD_MAX) {
+            lost++;
+        }
+
+        next = ((uint64_t)cur << 32) | ((uint64_t)passed << 16) | lost;
+    } while (!atomic_compare_exchange_weak_explicit(&rl->state, &old, next,
+                                                     memory_order_relaxed,
+                                                     memory_order_relaxed));
+    return allow;
+}
+
+#define HAL_LOG_AT_RL(log_, level_, rl_, now_ns_, burst_, ...) do {         \
+    uint32_t hal_log_rl_dropped_ = 0;                                       \
+    if ((log_) && hal_log_ratelimit_allow((rl_), (now_ns_), (burst_),       \
+                                          &hal_log_rl_dropped_)) {          \
+        if (hal_log_rl_dropped_) {                                          \
+            HAL_LOG_AT(log_, level_, "%u messages suppressed",              \
+                       (unsigned)hal_log_rl_dropped_);                      \
+        }                                                                   \
+        HAL_LOG_AT(log_, level_, __VA_ARGS__);                              \
+    }                                                                       \
+} while (0)
+
+/*
+    Macros par niveau.
+
+    HAL_LOGx(log, fmt, ...)                        : log simple
+    HAL_LOGx_RL(log, rl, now_ns, burst, fmt, ...)  : log limité (voir plus haut)
+*/
+#if HAL_LOG_MIN_LEVEL <= 0
+#define HAL_LOGI(log_, ...)                          HAL_LOG_AT(log_, HAL_LOG_INFO, __VA_ARGS__)
+#define HAL_LOGI_RL(log_, rl_, now_ns_, burst_, ...) HAL_LOG_AT_RL(log_, HAL_LOG_INFO, rl_, now_ns_, burst_, __VA_ARGS__)
+#else
+#define HAL_LOGI(log_, ...)                          ((void)0)
+#define HAL_LOGI_RL(log_, rl_, now_ns_, burst_, ...) ((void)0)
+#endif
+
+#if HAL_LOG_MIN_LEVEL <= 1
+#define HAL_LOGW(log_, ...)                          HAL_LOG_AT(log_, HAL_LOG_WARN, __VA_ARGS__)
+#define HAL_LOGW_RL(log_, rl_, now_ns_, burst_, ...) HAL_LOG_AT_RL(log_, HAL_LOG_WARN, rl_, now_ns_, burst_, __VA_ARGS__)
+#else
+#define HAL_LOGW(log_, ...)                          ((void)0)
+#define HAL_LOGW_RL(log_, rl_, now_ns_, burst_, ...) ((void)0)
+#endif
+
+#if HAL_LOG_MIN_LEVEL <= 2
+#define HAL_LOGE(log_, ...)                          HAL_LOG_AT(log_, HAL_LOG_ERR, __VA_ARGS__)
+#define HAL_LOGE_RL(log_, rl_, now_ns_, burst_, ...) HAL_LOG_AT_RL(log_, HAL_LOG_ERR, rl_, now_ns_, burst_, __VA_ARGS__)
+#else
+#define HAL_LOGE(log_, ...)                          ((void)0)
+#define HAL_LOGE_RL(log_, rl_, now_ns_, burst_, ...) ((void)0)
+#endif
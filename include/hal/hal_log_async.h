@@ -0,0 +1,140 @@
+#pragma once
+/*
+    hal_log_async.h
+
+    Implémentation "host" asynchrone et binaire de la HAL log.
+
+    Objectif :
+    - sur le thread appelant, ne faire AUCUN formatage ni appel système :
+      on copie seulement le pointeur de format et les arguments bruts
+      dans une file propre au thread (SPSC, lock-free)
+    - un thread de fond décode les enregistrements et écrit les lignes
+      (même rendu que hal_log_stdio : "[INFO] message")
+
+    Limites :
+    - HAL_LOG_ASYNC_MAX_ARGS arguments par message
+    - les chaînes (%s) sont copiées dans HAL_LOG_ASYNC_STR_BYTES octets
+      partagés par message (tronquées au-delà)
+    - %n n'est pas supporté (ignoré)
+    - si la file du thread est pleine, le message est perdu et compté
+    - au plus HAL_LOG_ASYNC_MAX_THREADS threads vivants ont une file ;
+      celle d'un thread terminé est reprise une fois vidée
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "hal/hal_log.h"
+#include "hal/hal_thread_slot.h"
+
+#define HAL_LOG_ASYNC_MAX_ARGS     8
+#define HAL_LOG_ASYNC_STR_BYTES    48
+#define HAL_LOG_ASYNC_RING_SIZE    256   // enregistrements par thread (puissance de 2)
+#define HAL_LOG_ASYNC_MAX_THREADS  HAL_THREAD_SLOTS_MAX
+
+/*
+    Argument brut capturé.
+
+    Les entiers sont normalisés en 64 bits (avec la troncature
+    des modificateurs hh/h déjà appliquée), les %s stockent
+    un offset dans str[].
+*/
+typedef union {
+    int64_t i;
+    uint64_t u;
+    double d;
+    const void *p;
+} hal_log_arg_t;
+
+/*
+    Enregistrement binaire (128 octets).
+
+    Le format n'est pas copié : fmt doit être une chaîne statique
+    (littéral), ce qui est le cas de tous les appels du driver.
+*/
+typedef struct {
+    const char *fmt;
+    uint8_t level;
+    uint8_t nargs;
+    uint8_t str_used;
+    uint8_t reserved;
+    hal_log_arg_t args[HAL_LOG_ASYNC_MAX_ARGS];
+    char str[HAL_LOG_ASYNC_STR_BYTES];
+} hal_log_record_t;
+
+/*
+    File d'un thread producteur.
+*/
+typedef struct {
+    _Atomic size_t head;  // écrit par le thread producteur
+    _Atomic size_t tail;  // écrit par le thread de fond
+    hal_log_record_t buf[HAL_LOG_ASYNC_RING_SIZE];
+} hal_log_async_ring_t;
+
+/*
+    Contexte du logger asynchrone.
+
+    rings       : une file par thread (allouée au premier log, recyclée
+                  quand le thread se termine)
+    flush_req   : demandes de flush (incrémenté par hal_log_async_flush)
+    flush_done  : dernière demande servie (files vidées + fflush)
+    dropped     : messages perdus (file pleine ou trop de threads)
+*/
+typedef struct {
+    hal_thread_slots_t rings;
+
+    FILE *out;   // INFO/WARN (NULL = stdout)
+    FILE *err;   // ERR (NULL = stderr)
+
+    pthread_t worker;
+    _Atomic int running;
+    _Atomic uint64_t flush_req;
+    _Atomic uint64_t flush_done;
+    _Atomic uint64_t dropped;
+} hal_log_async_ctx_t;
+
+/*
+    Initialise le logger et démarre le thread de fond.
+
+    - out / err : flux de sortie (NULL = stdout / stderr, comme hal_log_stdio)
+
+    Renvoie -1 si le thread n'a pas pu être créé, 0 sinon.
+*/
+int hal_log_async_init(
+    hal_log_async_ctx_t *ctx,
+    hal_log_t *log,
+    FILE *out,
+    FILE *err
+);
+
+/*
+    Attend que tous les messages déjà loggés soient écrits
+    (décodés et passés à fflush par le thread de fond).
+*/
+void hal_log_async_flush(hal_log_async_ctx_t *ctx);
+
+/*
+    Vide les files, arrête le thread de fond et libère les files.
+*/
+void hal_log_async_deinit(hal_log_async_ctx_t *ctx);
+
+/*
+    Nombre de messages perdus depuis l'init.
+*/
+uint64_t hal_log_async_dropped(hal_log_async_ctx_t *ctx);
+
+/*
+    Décode un enregistrement en texte (sans préfixe ni retour ligne).
+
+    Utilisé par le thread de fond ; exposé pour un décodeur hors ligne
+    (le binaire qui relit doit être celui qui a loggé : fmt est un pointeur).
+
+    Renvoie la longueur écrite (tronquée à size - 1).
+*/
+size_t hal_log_async_format(
+    const hal_log_record_t *rec,
+    char *buf,
+    size_t size
+);
@@ -18,3 +18,10 @@
     - log : structure HAL log à remplir
 */
 void hal_log_stdio_init(hal_log_t *log);
+
+/*
+    Fonction de log stdio (celle installée dans log->log).
+
+    Exposée pour la liaison statique (hal_bind_host.h).
+*/
+void hal_log_stdio_log(void *ctx, hal_log_level_t level, const char *fmt, ...);
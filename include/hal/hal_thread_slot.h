@@ -0,0 +1,83 @@
+#pragma once
+/*
+    hal_thread_slot.h
+
+    Table d'objets "un par thread" partagée par les backends host
+    (log asynchrone, statistiques de bus, bus partagé).
+
+    Principe :
+    - chaque thread obtient son objet au premier appel (chemin lent,
+      sous verrou), puis le retrouve par un cache thread-local
+    - l'objet d'un thread terminé est recyclé pour un nouveau thread
+      (destructeur pthread_key) : la table ne se remplit pas avec un
+      pool de threads qui tourne
+    - les objets ne sont jamais libérés avant deinit : un lecteur
+      peut parcourir la table sans verrou (hal_thread_slots_at)
+
+    Un objet recyclé n'est PAS remis à zéro : son contenu (compteurs,
+    index de file...) continue pour le nouveau propriétaire.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define HAL_THREAD_SLOTS_MAX 16
+
+/*
+    Table de slots.
+
+    obj[]      : objets alloués (alignés sur 64 octets, mis à zéro)
+    state[]    : libre / utilisé / thread terminé
+    n          : nombre d'objets alloués (obj[0..n) valides)
+    reusable   : vrai si l'objet d'un thread terminé peut être repris
+                 (NULL = tout de suite ; ex: log = file vidée)
+*/
+typedef struct {
+    void *obj[HAL_THREAD_SLOTS_MAX];
+    _Atomic uint32_t state[HAL_THREAD_SLOTS_MAX];
+    _Atomic size_t n;
+
+    pthread_mutex_t lock;
+    pthread_key_t key;
+    uint32_t generation;  // distingue deux tables successives à la même adresse
+
+    size_t obj_size;
+    int (*reusable)(const void *obj);
+} hal_thread_slots_t;
+
+/*
+    Initialise une table d'objets de obj_size octets.
+
+    Renvoie -1 si la clé pthread n'a pas pu être créée, 0 sinon.
+*/
+int hal_thread_slots_init(
+    hal_thread_slots_t *slots,
+    size_t obj_size,
+    int (*reusable)(const void *obj)
+);
+
+/*
+    Libère tous les objets (plus aucun thread ne doit utiliser la table).
+*/
+void hal_thread_slots_deinit(hal_thread_slots_t *slots);
+
+/*
+    Objet du thread courant (créé ou recyclé au premier appel).
+    NULL si les HAL_THREAD_SLOTS_MAX objets sont pris par des threads vivants.
+*/
+void *hal_thread_slots_get(hal_thread_slots_t *slots);
+
+/*
+    Parcours sans verrou : objets 0..count-1 (vivants ou en attente de recyclage).
+*/
+static inline size_t hal_thread_slots_count(hal_thread_slots_t *slots)
+{
+    return atomic_load_explicit(&slots->n, memory_order_acquire);
+}
+
+static inline void *hal_thread_slots_at(const hal_thread_slots_t *slots, size_t i)
+{
+    return slots->obj[i];
+}
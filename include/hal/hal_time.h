@@ -4,7 +4,7 @@
 
     Interface HAL pour la gestion du temps.
 
-    Permet au driver d'utiliser des délais
+    Permet au driver d'utiliser des délais et une horloge monotone
     sans dépendre d'une plateforme spécifique.
 */
 
@@ -37,4 +37,32 @@ typedef struct {
         uint32_t ms
     );
 
+    /*
+        Horloge monotone en nanosecondes (origine quelconque).
+
+        Sert à horodater les échantillons et à mesurer des durées.
+        Peut être NULL si la plateforme n'a pas d'horloge :
+        utiliser alors hal_time_now_ns() / hal_time_now_us() qui renvoient 0.
+
+        Champ ajouté après delay_ms : le driver ne le lit que sur une
+        horloge donnée par sensor_set_clock(). Un hal_time_t existant
+        qui ne remplit que ctx et delay_ms reste valide pour sensor_init().
+    */
+    uint64_t (*now_ns)(
+        void *ctx
+    );
+
 } hal_time_t;
+
+/*
+    Lecture de l'horloge (0 si time ou now_ns absent).
+*/
+static inline uint64_t hal_time_now_ns(const hal_time_t *time)
+{
+    return (time && time->now_ns) ? time->now_ns(time->ctx) : 0;
+}
+
+static inline uint64_t hal_time_now_us(const hal_time_t *time)
+{
+    return hal_time_now_ns(time) / 1000u;
+}
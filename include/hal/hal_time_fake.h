@@ -6,9 +6,14 @@
 
     Objectif :
     - fournir une fonction delay_ms() utilisable par le driver
+    - fournir une horloge monotone now_ns()
     - sans dépendre d'un microcontrôleur
 
-    Sur macOS, on utilise usleep() (microsecondes).
+    Sur macOS, on utilise usleep() (microsecondes)
+    et clock_gettime(CLOCK_MONOTONIC).
+
+    Pour les tests et les simulations de flotte, préférer hal_time_sim
+    (temps virtuel, aucun sommeil réel).
 */
 
 #include "hal/hal_time.h"
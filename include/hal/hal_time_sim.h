@@ -0,0 +1,41 @@
+#pragma once
+/*
+    hal_time_sim.h
+
+    Implémentation "temps simulé" de la HAL time.
+
+    Principe :
+    - une horloge virtuelle (en nanosecondes) remplace l'horloge réelle
+    - delay_ms() avance l'horloge immédiatement, sans dormir
+    - now_ns() lit l'horloge virtuelle
+
+    -> Les tests et les simulations de flotte tournent aussi vite que
+       le CPU le permet, avec des horodatages déterministes.
+
+    Pas de synchronisation : un contexte par thread de simulation.
+*/
+
+#include "hal/hal_time.h"
+
+/*
+    Contexte : temps virtuel courant.
+*/
+typedef struct {
+    uint64_t now_ns;
+} hal_time_sim_ctx_t;
+
+/*
+    Initialise le temps simulé.
+
+    Paramètres :
+    - ctx      : contexte (alloué par l'utilisateur)
+    - time     : structure HAL time à remplir
+    - start_ns : valeur initiale de l'horloge
+*/
+void hal_time_sim_init(hal_time_sim_ctx_t *ctx, hal_time_t *time, uint64_t start_ns);
+
+/*
+    Avance l'horloge virtuelle (ex: pour simuler le temps qui passe
+    entre deux itérations d'un ordonnanceur).
+*/
+void hal_time_sim_advance_ns(hal_time_sim_ctx_t *ctx, uint64_t ns);
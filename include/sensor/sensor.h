@@ -12,19 +12,70 @@
 */
 
 #include <stdint.h>
+#include <stddef.h>
 #include "hal/hal_bus.h"
 #include "hal/hal_time.h"
 #include "hal/hal_log.h"
+#include "sensor/sensor_regmap.h"
 
 /*
     Codes de retour du driver capteur.
 */
 typedef enum {
+    SENSOR_PENDING = 1,  // Opération non bloquante en cours (voir sensor_op.h)
     SENSOR_OK = 0,       // Succès
     SENSOR_ERR = -1,     // Erreur générique
     SENSOR_BAD_ID = -2   // Mauvais capteur détecté
 } sensor_status_t;
 
+/*
+    ID attendu dans WHO_AM_I.
+
+    Permet de vérifier qu'on parle
+    au bon composant.
+*/
+#define SENSOR_EXPECTED_ID 0x42
+
+/*
+    Délai de stabilisation après l'init (datasheet), en millisecondes.
+*/
+#define SENSOR_INIT_DELAY_MS 10
+
+/*
+    Profondeur de la FIFO matérielle du capteur (en échantillons).
+
+    sensor_read_samples() ne lit jamais plus que cela
+    en une seule rafale.
+*/
+#define SENSOR_FIFO_DEPTH 32
+
+/*
+    Fenêtre de registres couverte par le cache "shadow" (0x00..0x3F).
+
+    Les registres non volatils de cette fenêtre (ID, configuration)
+    sont gardés en mémoire : une relecture ne passe pas par le bus,
+    une écriture est différée jusqu'à sensor_flush().
+*/
+#define SENSOR_SHADOW_SIZE 64
+
+/*
+    Écart maximal (en registres propres) comblé par sensor_flush()
+    pour fusionner deux plages sales en une seule rafale.
+*/
+#define SENSOR_FLUSH_MAX_GAP 2
+
+/*
+    Lecture groupée de champs (sensor_read_fields) :
+    - au plus SENSOR_READ_FIELDS_MAX champs par appel
+    - deux champs séparés d'au plus SENSOR_COALESCE_MAX_GAP octets
+      non demandés sont lus dans la même rafale
+*/
+#define SENSOR_READ_FIELDS_MAX  16
+#define SENSOR_COALESCE_MAX_GAP 4
+
+/* Calibration (voir sensor_cal.h) */
+struct sensor_cal;
+
 /*
     Structure contexte du capteur.
 
@@ -46,13 +97,74 @@ typedef struct {
     const hal_time_t *time;
     const hal_log_t  *log;
 
+    /*
+        Horloge d'horodatage (sensor_set_clock), NULL = pas d'horloge.
+        Seule HAL time dont le driver lit now_ns.
+    */
+    const hal_time_t *clock;
+
+    /*
+        Transfert vectorisé du bus (sensor_set_bus_xfer),
+        NULL = un reg_read par rafale.
+    */
+    hal_status_t (*xfer)(void *ctx, const hal_bus_seg_t *segs, size_t n);
+
+    /*
+        Nombre d'overruns FIFO constatés depuis l'init
+        (échantillons perdus côté capteur).
+    */
+    uint32_t fifo_overruns;
+
+    /*
+        Cache shadow des registres non volatils.
+
+        shadow_valid : bit à 1 = shadow[reg] reflète le capteur
+        shadow_dirty : bit à 1 = écrit localement, pas encore envoyé
+    */
+    uint8_t shadow[SENSOR_SHADOW_SIZE];
+    uint8_t shadow_valid[SENSOR_SHADOW_SIZE / 8];
+    uint8_t shadow_dirty[SENSOR_SHADOW_SIZE / 8];
+
+    /*
+        Correction appliquée aux mesures (NULL = valeurs brutes).
+        Non possédée : peut pointer vers une table en flash.
+    */
+    const struct sensor_cal *cal;
+
+    /*
+        Limiteur des logs d'erreur bus de ce capteur
+        (partagé par ses sites d'appel, voir hal_log.h).
+    */
+    hal_log_ratelimit_t log_rl;
+
 } sensor_t;
 
+/*
+    Lie la structure à ses HAL, sans accès bus
+    (cache vidé ; calibration, horloge, transfert vectorisé
+    et compteurs remis à zéro).
+
+    Appelé par sensor_init() et sensor_init_start() : un driver
+    n'en a normalement pas besoin directement.
+    SENSOR_ERR si s est NULL ou si le bus ne sait pas lire/écrire.
+*/
+sensor_status_t sensor_bind(
+    sensor_t *s,
+    uint8_t dev_addr,
+    const hal_bus_t *bus,
+    const hal_time_t *time,
+    const hal_log_t *log
+);
+
 /*
     Initialise le capteur.
 
     Vérifie l'ID du capteur et prépare
     la structure sensor_t.
+
+    Seuls bus->ctx / reg_read / reg_write sont lus (bus->xfer n'est
+    utilisé qu'après sensor_set_bus_xfer). En liaison dynamique,
+    SENSOR_ERR si reg_read ou reg_write est NULL.
 */
 sensor_status_t sensor_init(
     sensor_t *s,
@@ -83,3 +195,133 @@ sensor_status_t sensor_read_temperature_centi(
     sensor_t *s,
     int16_t *temp_centi_out
 );
+
+/*
+    Donne au capteur son horloge monotone (NULL = aucune).
+
+    Optionnel : sans appel, le driver ne lit jamais time->now_ns
+    (horodatage à 0, limitation des logs comptée en messages).
+    clock peut être la même HAL time que celle de sensor_init().
+    À refaire après sensor_init().
+*/
+sensor_status_t sensor_set_clock(sensor_t *s, const hal_time_t *clock);
+
+/*
+    Active le transfert vectorisé natif du bus (NULL = désactivé).
+
+    Optionnel : sans appel, sensor_read_fields() enchaîne un reg_read
+    par rafale et le driver ne lit jamais bus->xfer. xfer est appelé
+    avec le ctx du bus du capteur ; typiquement bus.xfer d'un backend
+    qui le renseigne. À refaire après sensor_init().
+*/
+sensor_status_t sensor_set_bus_xfer(
+    sensor_t *s,
+    hal_status_t (*xfer)(void *ctx, const hal_bus_seg_t *segs, size_t n)
+);
+
+/*
+    Horodatage courant en microsecondes, lu sur l'horloge du capteur.
+
+    Renvoie 0 si aucune horloge (sensor_set_clock non appelé,
+    ou clock->now_ns NULL).
+*/
+uint64_t sensor_timestamp_us(const sensor_t *s);
+
+/*
+    Règle le seuil (watermark) de la FIFO, en échantillons.
+
+    0 désactive le drapeau watermark.
+*/
+sensor_status_t sensor_fifo_set_watermark(
+    sensor_t *s,
+    uint8_t watermark
+);
+
+/*
+    Lit jusqu'à max_samples échantillons depuis la FIFO du capteur.
+
+    Les échantillons sont vidés en UNE seule lecture en rafale
+    (reg_read de 2 * n octets sur FIFO_DATA), précédée d'une lecture
+    de FIFO_STATUS pour connaître le niveau.
+
+    - samples_out : tableau de sortie (centi-degrés)
+    - max_samples : capacité de samples_out
+    - n_read_out  : nombre d'échantillons réellement lus (0 si FIFO vide)
+
+    Un overrun FIFO est compté dans s->fifo_overruns,
+    les échantillons restants sont quand même renvoyés.
+*/
+sensor_status_t sensor_read_samples(
+    sensor_t *s,
+    int16_t *samples_out,
+    size_t max_samples,
+    size_t *n_read_out
+);
+
+/*
+    Lecture de registres via le cache shadow.
+
+    Si tous les registres demandés sont en cache, aucun accès bus.
+    Sinon une seule lecture bus, qui remplit le cache ; les valeurs
+    écrites mais pas encore flushées restent prioritaires.
+*/
+sensor_status_t sensor_reg_read(
+    sensor_t *s,
+    uint8_t reg,
+    uint8_t *data,
+    size_t len
+);
+
+/*
+    Écriture de registres.
+
+    - plage entièrement cacheable : écriture différée (write-back),
+      envoyée au prochain sensor_flush()
+    - sinon : écriture immédiate sur le bus (write-through)
+
+    SENSOR_ERR sans rien écrire si la plage contient un registre non
+    inscriptible (sans SENSOR_REG_W dans sensor_regmap.h, ou hors carte).
+*/
+sensor_status_t sensor_reg_write(
+    sensor_t *s,
+    uint8_t reg,
+    const uint8_t *data,
+    size_t len
+);
+
+/*
+    Envoie les registres modifiés au capteur.
+
+    Les registres sales adjacents (ou séparés de SENSOR_FLUSH_MAX_GAP
+    registres propres au plus) sont fusionnés en une seule rafale reg_write
+    (le trou ne contient que des registres inscriptibles).
+*/
+sensor_status_t sensor_flush(sensor_t *s);
+
+/*
+    Oublie le contenu du cache (ex: après un reset capteur).
+    Les écritures non flushées sont perdues.
+*/
+void sensor_cache_invalidate(sensor_t *s);
+
+/*
+    Lecture d'un ensemble de champs de la carte (sensor_regmap.h)
+    en un minimum de transactions.
+
+    - les champs sont triés par adresse puis fusionnés en rafales
+      contiguës ; un trou n'est comblé que s'il ne contient aucun
+      registre à effet de bord (FIFO_STATUS, FIFO_DATA)
+    - un champ FIFO (adresse fixe) est toujours lu seul
+    - passe par le cache shadow : les champs statiques déjà connus
+      ne coûtent aucun accès bus
+    - les rafales restantes partent en un seul transfert vectorisé
+      (hal_bus_t::xfer, ou repli générique)
+    - values_out[i] reçoit la valeur décodée de fields[i]
+      (largeur, endianness et signe selon la carte)
+*/
+sensor_status_t sensor_read_fields(
+    sensor_t *s,
+    const sensor_field_t *fields,
+    size_t n_fields,
+    int32_t *values_out
+);
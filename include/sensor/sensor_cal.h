@@ -0,0 +1,125 @@
+#pragma once
+/*
+    sensor_cal.h
+
+    Calibration par capteur, en arithmétique entière uniquement
+    (utilisable sur cible sans FPU).
+
+    Deux modèles :
+
+    - POLY : polynôme de degré <= 3
+        y = c0 + c1*x + c2*x^2 + c3*x^3
+        chaque degré a son format : ck en Q(16 + 15k)
+        (SENSOR_CAL_UNIT(k) = 1.0), ce qui revient à un polynôme
+        en Q16 de la variable normalisée u = x / 32768 ;
+        évalué par Horner sur u, sans débordement sur tout int16
+        (vérifié à l'init)
+
+    - LUT : table linéaire par morceaux (x croissants)
+        interpolation entre deux points, extrapolation par
+        le premier / dernier segment ; pentes précalculées
+        à l'init (aucune division à la mesure)
+
+    x et y sont en centi-degrés ; le résultat est saturé sur int16.
+
+    Une calibration est attachée à un capteur par
+    sensor_set_calibration() : sensor_read_temperature_centi()
+    et sensor_read_samples() rendent alors des valeurs corrigées.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor/sensor.h"
+
+#define SENSOR_CAL_POLY_MAX_COEF 4
+#define SENSOR_CAL_LUT_MAX       16
+
+/*
+    Virgule fixe des coefficients du polynôme :
+    - SENSOR_CAL_FRAC   : bits fractionnaires du résultat (centi-degrés)
+    - SENSOR_CAL_X_FRAC : x est vu comme un Q15 de la pleine échelle
+    ck = SENSOR_CAL_UNIT(k) * (coefficient réel, x et y en centi-degrés)
+
+    ex: c2 = 2e-6 -> 2^46 * 2e-6 ~ 1.4e8 (un LSB de c2 pèse 1.5e-5
+        centi-degré à pleine échelle)
+*/
+#define SENSOR_CAL_FRAC    16
+#define SENSOR_CAL_X_FRAC  15
+#define SENSOR_CAL_UNIT(k) ((int64_t)1 << (SENSOR_CAL_FRAC + SENSOR_CAL_X_FRAC * (k)))
+
+/*
+    Borne de sum(|ck|) : l'accumulateur de Horner reste < 2^47 + n,
+    son produit par x (|x| <= 2^15) tient dans un int64.
+*/
+#define SENSOR_CAL_COEF_SUM_MAX ((int64_t)1 << 47)
+
+/*
+    Virgule fixe des pentes de la LUT.
+*/
+#define SENSOR_CAL_SLOPE_FRAC 16
+
+typedef enum {
+    SENSOR_CAL_POLY = 1,
+    SENSOR_CAL_LUT
+} sensor_cal_kind_t;
+
+typedef struct sensor_cal {
+    sensor_cal_kind_t kind;
+
+    // POLY
+    uint8_t n_coef;
+    int64_t coef[SENSOR_CAL_POLY_MAX_COEF];   // coef[k] = ck en Q(16 + 15k)
+
+    // LUT
+    uint8_t n_points;
+    int16_t lut_x[SENSOR_CAL_LUT_MAX];
+    int16_t lut_y[SENSOR_CAL_LUT_MAX];
+    int32_t lut_slope[SENSOR_CAL_LUT_MAX - 1]; // Q16, segment i = [x[i], x[i+1]]
+} sensor_cal_t;
+
+/*
+    Polynôme : coef[k] = ck * SENSOR_CAL_UNIT(k), 1 <= n_coef <= 4.
+    ex: gain 1.01 et offset -0.50°C :
+        coef = { -50 * SENSOR_CAL_UNIT(0), SENSOR_CAL_UNIT(1) * 101 / 100 }
+
+    SENSOR_ERR si sum(|ck|) > SENSOR_CAL_COEF_SUM_MAX (débordement
+    possible sur la plage int16 ; ~2^31 centi-degrés, hors de toute
+    calibration réelle).
+*/
+sensor_status_t sensor_cal_init_poly(
+    sensor_cal_t *cal,
+    const int64_t *coef,
+    size_t n_coef
+);
+
+/*
+    Table : 2 <= n <= SENSOR_CAL_LUT_MAX points, x strictement croissants.
+*/
+sensor_status_t sensor_cal_init_lut(
+    sensor_cal_t *cal,
+    const int16_t *x,
+    const int16_t *y,
+    size_t n
+);
+
+/*
+    Applique la calibration à une valeur (cal NULL : identité).
+*/
+int16_t sensor_cal_apply(const sensor_cal_t *cal, int16_t raw);
+
+/*
+    Version par lot ; in == out autorisé.
+*/
+void sensor_cal_apply_batch(
+    const sensor_cal_t *cal,
+    const int16_t *in,
+    int16_t *out,
+    size_t n
+);
+
+/*
+    Attache (ou détache avec NULL) une calibration au capteur.
+    À appeler après sensor_init() (qui repart sans calibration).
+    La table doit rester valide tant qu'elle est attachée.
+*/
+sensor_status_t sensor_set_calibration(sensor_t *s, const sensor_cal_t *cal);
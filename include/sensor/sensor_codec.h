@@ -0,0 +1,133 @@
+#pragma once
+/*
+    sensor_codec.h
+
+    Compression d'un flux d'échantillons (valeur int16 + horodatage us).
+
+    Format : suite de blocs autonomes (décodables seuls -> accès aléatoire).
+
+    En-tête de bloc (SENSOR_CODEC_HEADER_SIZE octets, little-endian) :
+        0   u8   magic (SENSOR_CODEC_MAGIC)
+        1   u8   value_bits : largeur des deltas de valeur
+        2   u8   ts_bits    : largeur des delta-of-delta d'horodatage
+        3   u8   réservé (0)
+        4   u16  n          : nombre d'échantillons
+        6   i16  v0         : première valeur
+        8   u64  t0_us      : premier horodatage
+        16  u32  dt1_us     : t1 - t0 (0 si n == 1)
+        20  u32  payload    : taille des données qui suivent (octets)
+
+    Données (bit-packing LSB d'abord, largeur fixe dans le bloc) :
+    - n-1 deltas de valeur     v[i] - v[i-1], zigzag, value_bits chacun
+    - n-2 delta-of-delta temps (t[i]-t[i-1]) - (t[i-1]-t[i-2]), zigzag, ts_bits
+
+    Flux régulier (période fixe, valeur lente) : ts_bits = 0 et
+    quelques bits par valeur au lieu de 10 octets par échantillon.
+
+    Contraintes : horodatages croissants (ou égaux), écart <= UINT32_MAX us.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor/sensor.h"
+
+#define SENSOR_CODEC_MAGIC        0xC5
+#define SENSOR_CODEC_HEADER_SIZE  24
+#define SENSOR_CODEC_BLOCK_MAX    256
+
+/*
+    Taille maximale d'un bloc de n échantillons
+    (deltas sur 17 bits, delta-of-delta sur 33 bits).
+*/
+#define SENSOR_CODEC_BLOCK_BOUND(n) \
+    (SENSOR_CODEC_HEADER_SIZE + ((size_t)(n) * (17 + 33) + 7) / 8)
+
+typedef struct {
+    uint16_t n;
+    uint8_t value_bits;
+    uint8_t ts_bits;
+    int16_t v0;
+    uint64_t t0_us;
+    uint32_t size;   // en-tête + données
+} sensor_codec_block_info_t;
+
+/*
+    Encode n (1..SENSOR_CODEC_BLOCK_MAX) échantillons en un bloc.
+*/
+sensor_status_t sensor_codec_encode_block(
+    const int16_t *values,
+    const uint64_t *t_us,
+    size_t n,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+);
+
+/*
+    Lit et valide l'en-tête du bloc en tête de buf.
+*/
+sensor_status_t sensor_codec_block_info(
+    const uint8_t *buf,
+    size_t len,
+    sensor_codec_block_info_t *info
+);
+
+/*
+    Décode un bloc entier. t_us peut être NULL (valeurs seules).
+*/
+sensor_status_t sensor_codec_decode_block(
+    const uint8_t *buf,
+    size_t len,
+    int16_t *values,
+    uint64_t *t_us,
+    size_t max,
+    size_t *n_out
+);
+
+/*
+    Recherche dans une suite de blocs le dernier bloc dont t0_us <= t_us
+    (saut d'en-tête en en-tête, sans décoder). *offset = début du bloc.
+*/
+sensor_status_t sensor_codec_seek(
+    const uint8_t *stream,
+    size_t len,
+    uint64_t t_us,
+    size_t *offset
+);
+
+/*
+    Encodeur en flux : accumule les échantillons, émet un bloc
+    quand block_len est atteint (ou au flush).
+*/
+typedef struct {
+    int16_t values[SENSOR_CODEC_BLOCK_MAX];
+    uint64_t t_us[SENSOR_CODEC_BLOCK_MAX];
+    uint16_t n;
+    uint16_t block_len;
+} sensor_encoder_t;
+
+sensor_status_t sensor_encoder_init(sensor_encoder_t *enc, uint16_t block_len);
+
+/*
+    Ajoute un échantillon. Si un bloc est complété, il est écrit dans
+    out et *written reçoit sa taille (0 sinon). cap doit pouvoir contenir
+    SENSOR_CODEC_BLOCK_BOUND(block_len) ; sinon SENSOR_ERR et rien n'est ajouté.
+*/
+sensor_status_t sensor_encoder_push(
+    sensor_encoder_t *enc,
+    int16_t value,
+    uint64_t t_us,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+);
+
+/*
+    Émet le bloc partiel en cours (*written = 0 s'il est vide).
+*/
+sensor_status_t sensor_encoder_flush(
+    sensor_encoder_t *enc,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+);
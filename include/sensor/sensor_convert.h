@@ -0,0 +1,82 @@
+#pragma once
+/*
+    sensor_convert.h
+
+    Conversion par lots des échantillons bruts (int16 big-endian,
+    tels que lus en rafale dans FIFO_DATA) vers des unités utiles :
+
+    - centi-degrés (int16)   : simple inversion d'octets
+    - flottant               : raw * scale + offset
+    - virgule fixe (int32)   : raw * gain + offset, exact
+
+    Implémentations :
+    - SCALAR : C portable, toujours disponible
+    - SSE2   : x86-64 (toujours présent sur cette architecture)
+    - AVX2   : x86, choisi à l'exécution si le CPU le supporte
+    - NEON   : ARM (AArch64 / ARMv7 avec NEON)
+
+    La meilleure implémentation est choisie au premier appel ;
+    sensor_convert_select() permet de forcer un choix (tests, bench).
+    Résultats identiques entre implémentations (au dernier bit
+    d'arrondi près pour les flottants, selon la contraction FMA).
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor/sensor.h"
+
+typedef enum {
+    SENSOR_CONVERT_AUTO = 0,   // meilleure disponible
+    SENSOR_CONVERT_SCALAR,
+    SENSOR_CONVERT_SSE2,
+    SENSOR_CONVERT_AVX2,
+    SENSOR_CONVERT_NEON
+} sensor_convert_isa_t;
+
+/*
+    raw : 2 * n octets big-endian
+    out : n valeurs (raw et out ne doivent pas se chevaucher)
+*/
+void sensor_convert_be16_to_centi(
+    const uint8_t *raw,
+    int16_t *out,
+    size_t n
+);
+
+/*
+    out[i] = (float)raw[i] * scale + offset
+    ex: scale = 0.01f convertit des centi-degrés en degrés.
+*/
+void sensor_convert_be16_to_float(
+    const uint8_t *raw,
+    float *out,
+    size_t n,
+    float scale,
+    float offset
+);
+
+/*
+    out[i] = (int32_t)raw[i] * gain + offset
+
+    Calcul exact (|raw * gain| < 2^30) : le format virgule fixe
+    est celui choisi par l'appelant (ex: gain en Q8 -> out en Q8).
+*/
+void sensor_convert_be16_to_fixed(
+    const uint8_t *raw,
+    int32_t *out,
+    size_t n,
+    int16_t gain,
+    int32_t offset
+);
+
+/*
+    Force une implémentation.
+    SENSOR_ERR si elle n'est pas disponible sur cette machine.
+*/
+sensor_status_t sensor_convert_select(sensor_convert_isa_t isa);
+
+/*
+    Implémentation active (jamais AUTO) et son nom ("avx2", ...).
+*/
+sensor_convert_isa_t sensor_convert_active(void);
+const char *sensor_convert_isa_name(sensor_convert_isa_t isa);
@@ -0,0 +1,128 @@
+#pragma once
+/*
+    sensor_filter.h
+
+    Filtres en flux sur des blocs d'échantillons int16
+    (sortie de sensor_read_samples) : aucune allocation,
+    arithmétique entière uniquement.
+
+    Étages disponibles :
+    - MA     : moyenne glissante sur len échantillons (somme courante)
+    - CIC    : décimation CIC d'ordre N, facteur R (puissance de 2),
+               gain R^N compensé par décalage
+    - IIR1   : passe-bas du 1er ordre y += (x - y) / 2^shift (état Q16)
+    - MEDIAN : médiane glissante (fenêtre impaire 3..7) ;
+               la fenêtre de 3 a un chemin SIMD (min/max SSE2 / NEON)
+
+    Au premier échantillon, l'historique est rempli avec sa valeur
+    (pas de transitoire vers 0).
+
+    Les étages se composent dans un sensor_pipeline_t qui traite un
+    bloc EN PLACE : chaque étage rend au plus autant d'échantillons
+    qu'il en reçoit (moins pour la décimation).
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor/sensor.h"
+
+#define SENSOR_FILTER_MA_MAX        32
+#define SENSOR_FILTER_MEDIAN_MAX    7
+#define SENSOR_FILTER_CIC_MAX_ORDER 4
+#define SENSOR_FILTER_CIC_MAX_BITS  32  // N * log2(R) au plus
+
+typedef enum {
+    SENSOR_FILTER_MA = 1,
+    SENSOR_FILTER_CIC,
+    SENSOR_FILTER_IIR1,
+    SENSOR_FILTER_MEDIAN
+} sensor_filter_kind_t;
+
+/*
+    Un étage : type + état. Taille fixe, copiable, sans pointeur interne.
+*/
+typedef struct {
+    sensor_filter_kind_t kind;
+    uint8_t primed;  // historique initialisé
+
+    union {
+        struct {
+            int16_t hist[SENSOR_FILTER_MA_MAX];
+            int32_t sum;
+            uint8_t len;
+            uint8_t pos;
+        } ma;
+
+        struct {
+            uint64_t integ[SENSOR_FILTER_CIC_MAX_ORDER]; // arithmétique modulo 2^64
+            uint64_t comb[SENSOR_FILTER_CIC_MAX_ORDER];  // dernière entrée de chaque peigne
+            uint8_t order;
+            uint8_t shift;   // N * log2(R)
+            uint16_t ratio;
+            uint16_t phase;
+        } cic;
+
+        struct {
+            int32_t state;   // Q16
+            uint8_t shift;
+        } iir;
+
+        struct {
+            int16_t win[SENSOR_FILTER_MEDIAN_MAX];
+            uint8_t len;
+            uint8_t pos;
+        } med;
+    } u;
+} sensor_filter_t;
+
+/*
+    Initialisation des étages (SENSOR_ERR si paramètre hors bornes).
+
+    ma     : 1 <= len <= SENSOR_FILTER_MA_MAX
+    cic    : 1 <= order <= 4, ratio puissance de 2 >= 2,
+             order * log2(ratio) <= SENSOR_FILTER_CIC_MAX_BITS
+    iir1   : 1 <= shift <= 15 (alpha = 1 / 2^shift)
+    median : len impaire, 3 <= len <= SENSOR_FILTER_MEDIAN_MAX
+*/
+sensor_status_t sensor_filter_init_ma(sensor_filter_t *f, uint8_t len);
+sensor_status_t sensor_filter_init_cic(sensor_filter_t *f, uint8_t order, uint16_t ratio);
+sensor_status_t sensor_filter_init_iir1(sensor_filter_t *f, uint8_t shift);
+sensor_status_t sensor_filter_init_median(sensor_filter_t *f, uint8_t len);
+
+/*
+    Oublie l'historique (garde les paramètres).
+*/
+void sensor_filter_reset(sensor_filter_t *f);
+
+/*
+    Filtre n échantillons de in vers out (in == out autorisé).
+    Retourne le nombre d'échantillons écrits dans out.
+*/
+size_t sensor_filter_process(
+    sensor_filter_t *f,
+    const int16_t *in,
+    int16_t *out,
+    size_t n
+);
+
+/*
+    Chaîne d'étages (tableau fourni par l'appelant, non possédé).
+*/
+typedef struct {
+    sensor_filter_t *stages;
+    size_t n_stages;
+} sensor_pipeline_t;
+
+sensor_status_t sensor_pipeline_init(
+    sensor_pipeline_t *p,
+    sensor_filter_t *stages,
+    size_t n_stages
+);
+
+/*
+    Traite buf en place à travers tous les étages.
+    Retourne le nombre d'échantillons restant dans buf.
+*/
+size_t sensor_pipeline_process(sensor_pipeline_t *p, int16_t *buf, size_t n);
+
+void sensor_pipeline_reset(sensor_pipeline_t *p);
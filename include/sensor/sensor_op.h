@@ -0,0 +1,82 @@
+#pragma once
+/*
+    sensor_op.h
+
+    API non bloquante (reprenable) du driver capteur.
+
+    Chaque opération est une petite machine à états :
+    - sensor_xxx_start() prépare l'opération (aucun accès bus)
+    - sensor_op_step() la fait avancer au temps now_us :
+        * SENSOR_PENDING : revenir quand now_us >= op->wake_at_us
+        * autre code     : opération terminée (résultat dans op)
+
+    Aucun appel à delay_ms() : l'attente est rendue à l'appelant.
+    -> Un seul ordonnanceur coopératif peut piloter des milliers de
+       capteurs et recouvrir toutes leurs attentes.
+*/
+
+#include <stdint.h>
+#include "sensor/sensor.h"
+
+/*
+    Type d'opération en cours.
+*/
+typedef enum {
+    SENSOR_OP_NONE = 0,
+    SENSOR_OP_INIT,
+    SENSOR_OP_GET_ID,
+    SENSOR_OP_READ_TEMP
+} sensor_op_kind_t;
+
+/*
+    Opération reprenable (allouée par l'appelant, une par capteur).
+
+    wake_at_us : instant de reprise quand step() renvoie SENSOR_PENDING
+    result     : statut final (SENSOR_PENDING tant que non terminé)
+    id         : WHO_AM_I lu (INIT, GET_ID)
+    temp_centi : température lue (READ_TEMP)
+*/
+typedef struct {
+    sensor_t *s;
+    sensor_op_kind_t kind;
+    uint8_t state;
+
+    uint64_t wake_at_us;
+    sensor_status_t result;
+
+    uint8_t id;
+    int16_t temp_centi;
+} sensor_op_t;
+
+/*
+    Démarre l'init non bloquante (équivalent de sensor_init()).
+
+    Le délai de stabilisation devient un SENSOR_PENDING
+    de SENSOR_INIT_DELAY_MS.
+*/
+sensor_status_t sensor_init_start(
+    sensor_op_t *op,
+    sensor_t *s,
+    uint8_t dev_addr,
+    const hal_bus_t *bus,
+    const hal_time_t *time,
+    const hal_log_t *log
+);
+
+/*
+    Démarre la lecture de WHO_AM_I.
+*/
+sensor_status_t sensor_get_id_start(sensor_op_t *op, sensor_t *s);
+
+/*
+    Démarre une lecture de température.
+*/
+sensor_status_t sensor_read_temperature_start(sensor_op_t *op, sensor_t *s);
+
+/*
+    Fait avancer l'opération au temps now_us.
+
+    Renvoie SENSOR_PENDING (reprendre à op->wake_at_us) ou le statut final.
+    Appeler step() sur une opération terminée renvoie son résultat.
+*/
+sensor_status_t sensor_op_step(sensor_op_t *op, uint64_t now_us);
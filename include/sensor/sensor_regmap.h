@@ -0,0 +1,155 @@
+#pragma once
+/*
+    sensor_regmap.h
+
+    Carte des registres du capteur : SOURCE UNIQUE partagée par
+    le driver (sensor.c), le capteur simulé (hal_bus_fake*.c) et les tests.
+
+    Chaque champ est décrit une seule fois dans SENSOR_REGMAP :
+    - nom
+    - adresse du premier registre
+    - largeur en octets
+    - drapeaux (accès, volatilité, endianness, effets de bord)
+
+    On en déduit :
+    - les adresses SENSOR_REG_<NOM>
+    - l'énumération sensor_field_t (SENSOR_FIELD_<NOM>)
+    - sensor_reg_desc() : descripteur d'un champ
+    - sensor_regmap_is_volatile() / sensor_regmap_is_writable()
+      / sensor_regmap_has_read_side_effect()
+
+    Ajouter un registre = ajouter une ligne ici.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+    Drapeaux de registre.
+*/
+#define SENSOR_REG_R          0x01  // lisible
+#define SENSOR_REG_W          0x02  // inscriptible
+#define SENSOR_REG_VOLATILE   0x04  // change sans écriture du driver : jamais en cache
+#define SENSOR_REG_BE         0x08  // multi-octets big-endian (sinon little-endian)
+#define SENSOR_REG_SIGNED     0x10  // valeur signée (complément à 2)
+#define SENSOR_REG_READ_CLEAR 0x20  // la lecture a un effet de bord (efface un drapeau)
+#define SENSOR_REG_STREAM     0x40  // adresse fixe, chaque lecture dépile (FIFO)
+
+#define SENSOR_REG_RO  SENSOR_REG_R
+#define SENSOR_REG_RW  (SENSOR_REG_R | SENSOR_REG_W)
+
+/*
+    Carte des registres.
+
+    X(nom, adresse, largeur, drapeaux)
+
+    STATUS      : [0] donnée prête
+    CTRL        : configuration (mode, fréquence)
+    TEMP        : température en centi-degrés, 16 bits signés big-endian
+    FIFO_CTRL   : watermark FIFO (en échantillons)
+    FIFO_STATUS : [7] overrun, [6] watermark atteint, [5:0] niveau
+                  (l'overrun est effacé à la lecture)
+    FIFO_DATA   : échantillons 16 bits big-endian, lus en rafale
+    USER        : zone utilisateur non volatile, libre pour l'application
+
+    Un registre hors carte n'est pas inscriptible (ni par le driver,
+    ni sur le capteur simulé).
+*/
+#define SENSOR_REGMAP(X)                                                                     \
+    X(WHO_AM_I,    0x00, 1, SENSOR_REG_RO)                                                   \
+    X(CTRL,        0x01, 1, SENSOR_REG_RW)                                                   \
+    X(STATUS,      0x0F, 1, SENSOR_REG_RO | SENSOR_REG_VOLATILE)                             \
+    X(TEMP,        0x10, 2, SENSOR_REG_RO | SENSOR_REG_VOLATILE | SENSOR_REG_BE              \
+                            | SENSOR_REG_SIGNED)                                             \
+    X(FIFO_CTRL,   0x20, 1, SENSOR_REG_RW)                                                   \
+    X(FIFO_STATUS, 0x21, 1, SENSOR_REG_RO | SENSOR_REG_VOLATILE | SENSOR_REG_READ_CLEAR)     \
+    X(FIFO_DATA,   0x22, 2, SENSOR_REG_RO | SENSOR_REG_VOLATILE | SENSOR_REG_BE              \
+                            | SENSOR_REG_SIGNED | SENSOR_REG_READ_CLEAR | SENSOR_REG_STREAM) \
+    X(USER,        0x30, 16, SENSOR_REG_RW)
+
+/*
+    Adresses : SENSOR_REG_WHO_AM_I, SENSOR_REG_TEMP, ...
+*/
+#define SENSOR_REGMAP_ADDR_(name, addr, width, flags) SENSOR_REG_##name = (addr),
+enum {
+    SENSOR_REGMAP(SENSOR_REGMAP_ADDR_)
+};
+#undef SENSOR_REGMAP_ADDR_
+
+/* Octets individuels de TEMP (le fake les écrit séparément) */
+#define SENSOR_REG_TEMP_MSB  (SENSOR_REG_TEMP)
+#define SENSOR_REG_TEMP_LSB  (SENSOR_REG_TEMP + 1)
+
+/*
+    Bits des registres d'état.
+*/
+#define SENSOR_STATUS_DRDY       0x01
+#define SENSOR_FIFO_STATUS_OVR   0x80
+#define SENSOR_FIFO_STATUS_WTM   0x40
+#define SENSOR_FIFO_STATUS_LVL   0x3F
+
+/*
+    Champs : SENSOR_FIELD_WHO_AM_I, ..., SENSOR_FIELD_COUNT
+*/
+#define SENSOR_REGMAP_FIELD_(name, addr, width, flags) SENSOR_FIELD_##name,
+typedef enum {
+    SENSOR_REGMAP(SENSOR_REGMAP_FIELD_)
+    SENSOR_FIELD_COUNT
+} sensor_field_t;
+#undef SENSOR_REGMAP_FIELD_
+
+/*
+    Descripteur d'un champ.
+*/
+typedef struct {
+    const char *name;
+    uint8_t addr;
+    uint8_t width;
+    uint8_t flags;
+} sensor_reg_desc_t;
+
+/*
+    Descripteur du champ f (NULL si hors carte).
+*/
+static inline const sensor_reg_desc_t *sensor_reg_desc(sensor_field_t f)
+{
+#define SENSOR_REGMAP_DESC_(name, addr, width, flags) { #name, (addr), (width), (flags) },
+    static const sensor_reg_desc_t table[SENSOR_FIELD_COUNT] = {
+        SENSOR_REGMAP(SENSOR_REGMAP_DESC_)
+    };
+#undef SENSOR_REGMAP_DESC_
+
+    return ((unsigned)f < SENSOR_FIELD_COUNT) ? &table[f] : NULL;
+}
+
+/*
+    Vrai si l'octet à l'adresse reg appartient à un champ dont les
+    drapeaux contiennent mask. Chaîne de comparaisons constantes :
+    le compilateur la réduit à quelques tests.
+*/
+static inline int sensor_regmap_test(uint8_t reg, uint8_t mask)
+{
+#define SENSOR_REGMAP_TEST_(name, addr, width, flags)                       \
+    if (((flags) & mask) && (unsigned)(reg - (addr)) < (unsigned)(width)) {  \
+        return 1;                                                           \
+    }
+    SENSOR_REGMAP(SENSOR_REGMAP_TEST_)
+#undef SENSOR_REGMAP_TEST_
+
+    return 0;
+}
+
+static inline int sensor_regmap_is_volatile(uint8_t reg)
+{
+    return sensor_regmap_test(reg, SENSOR_REG_VOLATILE);
+}
+
+static inline int sensor_regmap_is_writable(uint8_t reg)
+{
+    return sensor_regmap_test(reg, SENSOR_REG_W);
+}
+
+static inline int sensor_regmap_has_read_side_effect(uint8_t reg)
+{
+    return sensor_regmap_test(reg, SENSOR_REG_READ_CLEAR | SENSOR_REG_STREAM);
+}
@@ -0,0 +1,118 @@
+#pragma once
+/*
+    sensor_ring.h
+
+    File circulaire lock-free SPSC (un producteur, un consommateur)
+    d'échantillons horodatés.
+
+    Usage typique :
+    - le thread d'acquisition lit le capteur et pousse (push)
+    - un thread consommateur vide la file par lots (pop_batch)
+
+    -> Un consommateur lent ne retarde jamais l'acquisition :
+       si la file est pleine, l'échantillon est perdu et compté.
+
+    Aucune allocation, aucun verrou : seulement des atomiques C11.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "sensor/sensor.h"
+
+/*
+    Taille supposée d'une ligne de cache (évite le faux partage
+    entre les index producteur et consommateur).
+*/
+#define SENSOR_RING_CACHE_LINE 64
+
+/*
+    Échantillon horodaté (16 octets).
+
+    t_us      : horodatage en microsecondes (horloge monotone)
+    sensor_id : identifiant applicatif du capteur
+    value     : valeur en centi-degrés
+*/
+typedef struct {
+    uint64_t t_us;
+    uint32_t sensor_id;
+    int16_t value;
+    uint16_t flags;
+} sensor_sample_t;
+
+/*
+    File SPSC.
+
+    head : prochain emplacement écrit (modifié par le producteur seul)
+    tail : prochain emplacement lu (modifié par le consommateur seul)
+
+    Chaque côté garde une copie locale de l'index de l'autre
+    (tail_cache / head_cache) pour éviter de relire la ligne de cache
+    distante à chaque opération.
+*/
+typedef struct {
+    sensor_sample_t *buf;
+    size_t mask;
+
+    // Côté producteur
+    _Alignas(SENSOR_RING_CACHE_LINE) _Atomic size_t head;
+    size_t tail_cache;
+    _Atomic uint64_t dropped;
+
+    // Côté consommateur
+    _Alignas(SENSOR_RING_CACHE_LINE) _Atomic size_t tail;
+    size_t head_cache;
+} sensor_ring_t;
+
+/*
+    Initialise la file sur un buffer fourni par l'utilisateur.
+
+    capacity doit être une puissance de 2.
+*/
+sensor_status_t sensor_ring_init(
+    sensor_ring_t *ring,
+    sensor_sample_t *buf,
+    size_t capacity
+);
+
+/*
+    Pousse un échantillon (producteur uniquement).
+
+    Renvoie SENSOR_ERR si la file est pleine : l'échantillon est perdu
+    et compté dans sensor_ring_dropped().
+*/
+sensor_status_t sensor_ring_push(
+    sensor_ring_t *ring,
+    const sensor_sample_t *sample
+);
+
+/*
+    Retire jusqu'à max échantillons (consommateur uniquement).
+
+    Renvoie le nombre d'échantillons copiés dans out[].
+*/
+size_t sensor_ring_pop_batch(
+    sensor_ring_t *ring,
+    sensor_sample_t *out,
+    size_t max
+);
+
+/*
+    Nombre d'échantillons perdus (file pleine) depuis l'init.
+*/
+uint64_t sensor_ring_dropped(const sensor_ring_t *ring);
+
+/*
+    Lit une température et la pousse dans la file.
+
+    - sensor_id : identifiant mis dans l'échantillon
+    - t_us      : horodatage de l'échantillon
+
+    Renvoie SENSOR_ERR si la lecture échoue ou si la file est pleine.
+*/
+sensor_status_t sensor_read_to_ring(
+    sensor_t *s,
+    sensor_ring_t *ring,
+    uint32_t sensor_id,
+    uint64_t t_us
+);
@@ -0,0 +1,127 @@
+#pragma once
+/*
+    sensor_rollup.h
+
+    Agrégats multi-résolution (min / max / somme / nombre) d'un capteur,
+    mis à jour à chaque échantillon en O(1) et en mémoire fixe.
+
+    Un niveau (tier) = une résolution (ex: 1 s, 1 min, 1 h) et un
+    tableau de buckets fourni par l'appelant (aucune allocation).
+    Le bucket d'un instant t est à l'index (t / res) % cap :
+    - même intervalle      -> mise à jour
+    - intervalle plus récent -> le bucket est recyclé
+    - intervalle plus ancien -> échantillon trop vieux pour ce niveau (compté)
+
+    Rétention d'un niveau = res * cap ; mémoire = cap * sizeof(sensor_bucket_t).
+    ex: 1 s x 3600 + 1 min x 1440 + 1 h x 720 ~ 140 Ko par capteur
+        pour 1 h / 1 jour / 30 jours d'historique.
+
+    Une requête sur une longue plage lit quelques buckets précalculés
+    du niveau adapté au lieu des échantillons bruts.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor/sensor.h"
+#include "sensor/sensor_ring.h" // sensor_sample_t
+
+#define SENSOR_ROLLUP_MAX_TIERS 4
+
+/*
+    Nombre minimal de buckets visé par une requête
+    (choix du niveau, voir sensor_rollup_query).
+*/
+#define SENSOR_ROLLUP_QUERY_MIN_BUCKETS 8
+
+/*
+    Bucket : agrégat d'un intervalle [t_start_us, t_start_us + res).
+    count == 0 : vide.
+*/
+typedef struct {
+    uint64_t t_start_us;
+    int64_t sum;
+    uint32_t count;
+    int16_t min;
+    int16_t max;
+} sensor_bucket_t;
+
+typedef struct {
+    uint64_t res_us;
+    sensor_bucket_t *buckets;
+    uint32_t cap;
+} sensor_rollup_tier_t;
+
+typedef struct {
+    sensor_rollup_tier_t tiers[SENSOR_ROLLUP_MAX_TIERS]; // résolutions croissantes
+    uint8_t n_tiers;
+    uint64_t t_last_us;     // plus récent échantillon vu
+    uint64_t late_drops;    // (échantillon, niveau) rejetés car trop anciens
+} sensor_rollup_t;
+
+/*
+    Résultat d'une requête.
+*/
+typedef struct {
+    uint64_t count;
+    int64_t sum;
+    int16_t min;
+    int16_t max;
+    int16_t mean;           // arrondie, 0 si count == 0
+    uint8_t tier;           // niveau utilisé
+    uint64_t t_begin_us;    // plage réellement couverte (alignée sur le niveau)
+    uint64_t t_end_us;      // exclu
+} sensor_rollup_stat_t;
+
+sensor_status_t sensor_rollup_init(sensor_rollup_t *r);
+
+/*
+    Ajoute un niveau. res_us doit être strictement supérieure à celle
+    du niveau précédent. buckets[cap] est remis à zéro.
+*/
+sensor_status_t sensor_rollup_add_tier(
+    sensor_rollup_t *r,
+    uint64_t res_us,
+    sensor_bucket_t *buckets,
+    uint32_t cap
+);
+
+/*
+    Ajoute un échantillon à tous les niveaux : O(nombre de niveaux).
+*/
+void sensor_rollup_add(sensor_rollup_t *r, uint64_t t_us, int16_t value);
+
+/*
+    Aiguille un lot d'échantillons (ex: sensor_ring_pop_batch) vers
+    by_id[sample.sensor_id] ; les identifiants >= n_ids sont ignorés.
+*/
+void sensor_rollup_feed(
+    sensor_rollup_t *by_id,
+    size_t n_ids,
+    const sensor_sample_t *samples,
+    size_t n
+);
+
+/*
+    Bucket du niveau tier contenant t_us (SENSOR_ERR si absent ou recyclé).
+*/
+sensor_status_t sensor_rollup_bucket(
+    const sensor_rollup_t *r,
+    uint8_t tier,
+    uint64_t t_us,
+    sensor_bucket_t *out
+);
+
+/*
+    Agrégat de [t_begin_us, t_end_us) à partir des buckets.
+
+    Niveau choisi : le plus grossier qui couvre encore t_begin_us et
+    donne au moins SENSOR_ROLLUP_QUERY_MIN_BUCKETS buckets sur la plage ;
+    à défaut le plus fin qui couvre t_begin_us (ou le plus grossier).
+    Les bords sont arrondis à la résolution du niveau (out->t_begin_us/t_end_us).
+*/
+sensor_status_t sensor_rollup_query(
+    const sensor_rollup_t *r,
+    uint64_t t_begin_us,
+    uint64_t t_end_us,
+    sensor_rollup_stat_t *out
+);
@@ -0,0 +1,172 @@
+#pragma once
+/*
+    store.h
+
+    Stockage sur disque des échantillons (sensor_sample_t),
+    en segments mappés en mémoire (mmap), en ajout seul.
+
+    Segment = un fichier de taille fixe :
+
+        [ en-tête     ]  1 page : magic, capacité, compteur, bornes temps
+        [ index creux ]  1 entrée (t_min, t_max) par bloc de
+                         STORE_INDEX_STRIDE enregistrements
+        [ enregistrements ]  capacity * sizeof(sensor_sample_t)
+
+    Écriture :
+    - append = une copie en mémoire mappée + mise à jour de l'index
+      et du compteur : AUCUN appel système par échantillon
+    - un seul écrivain par segment
+    - store_segment_sync() force l'écriture disque (msync)
+
+    Lecture :
+    - les lecteurs (même d'un autre processus) voient les enregistrements
+      publiés par le compteur (atomique, release / acquire)
+    - store_iter_t rend des pointeurs DANS le mapping (zéro copie) ;
+      l'index creux saute les blocs hors de la plage de temps
+
+    Les enregistrements n'ont pas besoin d'être triés : l'index garde
+    le min et le max de chaque bloc.
+
+    store_t enchaîne les segments d'un dossier (seg-000000.tss, ...) :
+    un nouveau segment est créé quand le courant est plein.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "sensor/sensor.h"
+#include "sensor/sensor_ring.h" // sensor_sample_t
+
+#define STORE_MAGIC          "SNSSEG01"
+#define STORE_VERSION        1
+#define STORE_INDEX_STRIDE   256   // enregistrements par entrée d'index
+#define STORE_PATH_MAX       512
+
+/*
+    Entrée de l'index creux (bornes temps d'un bloc).
+*/
+typedef struct {
+    _Atomic uint64_t t_min;
+    _Atomic uint64_t t_max;
+} store_index_entry_t;
+
+/*
+    En-tête de segment (début du fichier).
+*/
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t capacity;       // enregistrements
+    uint32_t index_stride;
+    uint32_t reserved;
+    uint64_t index_offset;   // octets depuis le début du fichier
+    uint64_t records_offset;
+    _Atomic uint64_t count;  // enregistrements publiés
+    _Atomic uint64_t t_min;  // bornes du segment (UINT64_MAX / 0 si vide)
+    _Atomic uint64_t t_max;
+} store_header_t;
+
+typedef struct {
+    int fd;
+    int writable;
+    uint8_t *map;
+    size_t map_size;
+    store_header_t *hdr;
+    store_index_entry_t *index;
+    sensor_sample_t *records;
+} store_segment_t;
+
+/*
+    Crée un segment vide (échoue si le fichier existe).
+*/
+sensor_status_t store_segment_create(
+    store_segment_t *seg,
+    const char *path,
+    uint64_t capacity
+);
+
+/*
+    Ouvre un segment existant, en lecture seule ou en ajout.
+*/
+sensor_status_t store_segment_open(
+    store_segment_t *seg,
+    const char *path,
+    int writable
+);
+
+void store_segment_close(store_segment_t *seg);
+
+/*
+    Ajoute un enregistrement. SENSOR_ERR si plein ou lecture seule.
+*/
+sensor_status_t store_segment_append(
+    store_segment_t *seg,
+    const sensor_sample_t *sample
+);
+
+sensor_status_t store_segment_sync(store_segment_t *seg);
+
+uint64_t store_segment_count(const store_segment_t *seg);
+
+/*
+    Itérateur sur [t_begin, t_end] (inclus), zéro copie.
+*/
+typedef struct {
+    const store_segment_t *seg;
+    uint64_t t_begin;
+    uint64_t t_end;
+    uint64_t pos;
+    uint64_t count;   // instantané du compteur au début
+} store_iter_t;
+
+void store_iter_init(
+    store_iter_t *it,
+    const store_segment_t *seg,
+    uint64_t t_begin,
+    uint64_t t_end
+);
+
+/*
+    Prochain enregistrement de la plage (NULL à la fin).
+    Le pointeur reste valide tant que le segment est ouvert.
+*/
+const sensor_sample_t *store_iter_next(store_iter_t *it);
+
+/*
+    Dossier de segments avec bascule automatique.
+*/
+typedef struct {
+    char dir[STORE_PATH_MAX];
+    uint64_t seg_capacity;
+    uint32_t seg_no;
+    store_segment_t cur;
+} store_t;
+
+/*
+    Ouvre (ou démarre) le dossier : reprend l'ajout dans le dernier segment.
+    Un dernier segment dont la création a été interrompue (sans magic ni
+    enregistrement) est effacé et l'ajout reprend dans le précédent.
+
+    store_append() garde le segment plein ouvert tant que le suivant n'a
+    pas pu être créé : un échec de bascule est retenté à l'ajout suivant.
+*/
+sensor_status_t store_open(store_t *st, const char *dir, uint64_t seg_capacity);
+sensor_status_t store_append(store_t *st, const sensor_sample_t *sample);
+sensor_status_t store_sync(store_t *st);
+void store_close(store_t *st);
+
+/*
+    Parcourt tous les segments du dossier sur [t_begin, t_end].
+    Les segments hors plage sont sautés sur leur en-tête.
+    Le callback retourne 0 pour arrêter. Retourne le nombre visité.
+*/
+typedef int (*store_visit_fn)(const sensor_sample_t *sample, void *user);
+
+uint64_t store_scan(
+    const char *dir,
+    uint64_t t_begin,
+    uint64_t t_end,
+    store_visit_fn fn,
+    void *user
+);
@@ -0,0 +1,266 @@
+/*
+    hal_bus_async_fake.c
+
+    Bus asynchrone "host" basé sur un thread worker.
+
+    - submit() ajoute le descripteur en file de soumission et réveille le worker
+    - le worker exécute reg_read/reg_write sur le bus bloquant (hors verrou)
+    - la fin est signalée par callback, ou via la file de complétion (poll)
+*/
+
+#include "hal/hal_bus_async_fake.h"
+#include <string.h> // memset
+#include <time.h>   // clock_gettime
+
+/*
+    Ajoute x en fin de file (head/tail). Appelé sous verrou.
+*/
+static void queue_push(hal_bus_xfer_t **head, hal_bus_xfer_t **tail, hal_bus_xfer_t *x)
+{
+    x->next = NULL;
+    if (*tail) {
+        (*tail)->next = x;
+    } else {
+        *head = x;
+    }
+    *tail = x;
+}
+
+/*
+    Retire le premier élément de la file (NULL si vide). Appelé sous verrou.
+*/
+static hal_bus_xfer_t *queue_pop(hal_bus_xfer_t **head, hal_bus_xfer_t **tail)
+{
+    hal_bus_xfer_t *x = *head;
+    if (x) {
+        *head = x->next;
+        if (!*head) {
+            *tail = NULL;
+        }
+        x->next = NULL;
+    }
+    return x;
+}
+
+/*
+    Exécute une transaction sur le bus bloquant.
+*/
+static hal_status_t run_xfer(const hal_bus_t *bus, hal_bus_xfer_t *x)
+{
+    if (x->dir == HAL_XFER_READ) {
+        if (!bus->reg_read) {
+            return HAL_ERR;
+        }
+        return bus->reg_read(bus->ctx, x->dev_addr, x->reg, x->data, x->len);
+    }
+
+    if (!bus->reg_write) {
+        return HAL_ERR;
+    }
+    return bus->reg_write(bus->ctx, x->dev_addr, x->reg, x->data, x->len);
+}
+
+/*
+    Boucle du thread worker.
+
+    Tourne jusqu'à running == 0 ET file de soumission vide :
+    deinit() n'abandonne jamais une transaction déjà soumise.
+*/
+static void *worker_main(void *arg)
+{
+    hal_bus_async_fake_ctx_t *ctx = (hal_bus_async_fake_ctx_t *)arg;
+
+    pthread_mutex_lock(&ctx->lock);
+    for (;;) {
+        hal_bus_xfer_t *x = queue_pop(&ctx->sq_head, &ctx->sq_tail);
+
+        if (!x) {
+            if (!ctx->running) {
+                break;
+            }
+            pthread_cond_wait(&ctx->sq_cond, &ctx->lock);
+            continue;
+        }
+
+        // Transfert hors verrou : submit() reste possible pendant ce temps
+        pthread_mutex_unlock(&ctx->lock);
+        x->status = run_xfer(ctx->backend, x);
+
+        if (x->on_done) {
+            x->on_done(x);
+            pthread_mutex_lock(&ctx->lock);
+            continue;
+        }
+
+        pthread_mutex_lock(&ctx->lock);
+        queue_push(&ctx->cq_head, &ctx->cq_tail, x);
+        pthread_cond_broadcast(&ctx->cq_cond);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    return NULL;
+}
+
+static hal_bus_xfer_t *async_xfer_alloc(void *context)
+{
+    hal_bus_async_fake_ctx_t *ctx = (hal_bus_async_fake_ctx_t *)context;
+
+    pthread_mutex_lock(&ctx->lock);
+    hal_bus_xfer_t *x = ctx->free_list;
+    if (x) {
+        ctx->free_list = x->next;
+        memset(x, 0, sizeof(*x));
+    }
+    pthread_mutex_unlock(&ctx->lock);
+
+    return x;
+}
+
+static void async_xfer_free(void *context, hal_bus_xfer_t *x)
+{
+    hal_bus_async_fake_ctx_t *ctx = (hal_bus_async_fake_ctx_t *)context;
+
+    if (!x) {
+        return;
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    x->next = ctx->free_list;
+    ctx->free_list = x;
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+static hal_status_t async_submit(void *context, hal_bus_xfer_t *x)
+{
+    hal_bus_async_fake_ctx_t *ctx = (hal_bus_async_fake_ctx_t *)context;
+
+    if (!ctx || !x || (!x->data && x->len > 0)) {
+        return HAL_ERR;
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    if (!ctx->running) {
+        pthread_mutex_unlock(&ctx->lock);
+        return HAL_ERR;
+    }
+    queue_push(&ctx->sq_head, &ctx->sq_tail, x);
+    pthread_cond_signal(&ctx->sq_cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    return HAL_OK;
+}
+
+static size_t async_poll(
+    void *context,
+    hal_bus_xfer_t **done,
+    size_t max,
+    uint32_t timeout_ms
+)
+{
+    hal_bus_async_fake_ctx_t *ctx = (hal_bus_async_fake_ctx_t *)context;
+    size_t n = 0;
+
+    if (!ctx || !done || max == 0) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+
+    if (!ctx->cq_head && timeout_ms > 0) {
+        // Échéance absolue (pthread_cond_timedwait utilise CLOCK_REALTIME)
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout_ms / 1000u;
+        deadline.tv_nsec += (long)(timeout_ms % 1000u) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        while (!ctx->cq_head) {
+            if (pthread_cond_timedwait(&ctx->cq_cond, &ctx->lock, &deadline) != 0) {
+                break;
+            }
+        }
+    }
+
+    while (n < max) {
+        hal_bus_xfer_t *x = queue_pop(&ctx->cq_head, &ctx->cq_tail);
+        if (!x) {
+            break;
+        }
+        done[n++] = x;
+    }
+
+    pthread_mutex_unlock(&ctx->lock);
+
+    return n;
+}
+
+/*
+    Fonction publique d'initialisation.
+*/
+hal_status_t hal_bus_async_fake_init(
+    hal_bus_async_fake_ctx_t *ctx,
+    hal_bus_async_t *async,
+    const hal_bus_t *backend
+)
+{
+    if (!ctx || !async || !backend) {
+        return HAL_ERR;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->backend = backend;
+
+    // Tous les descripteurs dans la liste libre
+    for (size_t i = 0; i < HAL_BUS_ASYNC_FAKE_POOL_SIZE; i++) {
+        ctx->pool[i].next = ctx->free_list;
+        ctx->free_list = &ctx->pool[i];
+    }
+
+    pthread_mutex_init(&ctx->lock, NULL);
+    pthread_cond_init(&ctx->sq_cond, NULL);
+    pthread_cond_init(&ctx->cq_cond, NULL);
+
+    ctx->running = 1;
+    atomic_init(&ctx->alive, 1);
+    if (pthread_create(&ctx->worker, NULL, worker_main, ctx) != 0) {
+        ctx->running = 0;
+        atomic_store(&ctx->alive, 0);
+        pthread_cond_destroy(&ctx->cq_cond);
+        pthread_cond_destroy(&ctx->sq_cond);
+        pthread_mutex_destroy(&ctx->lock);
+        return HAL_ERR;
+    }
+
+    async->ctx = ctx;
+    async->xfer_alloc = async_xfer_alloc;
+    async->xfer_free = async_xfer_free;
+    async->submit = async_submit;
+    async->poll = async_poll;
+
+    return HAL_OK;
+}
+
+/*
+    Arrêt du worker (vide d'abord la file de soumission).
+*/
+void hal_bus_async_fake_deinit(hal_bus_async_fake_ctx_t *ctx)
+{
+    // Le mutex n'existe plus après le premier appel : on teste avant
+    if (!ctx || !atomic_exchange(&ctx->alive, 0)) {
+        return;
+    }
+
+    pthread_mutex_lock(&ctx->lock);
+    ctx->running = 0;
+    pthread_cond_signal(&ctx->sq_cond);
+    pthread_mutex_unlock(&ctx->lock);
+
+    pthread_join(ctx->worker, NULL);
+
+    pthread_cond_destroy(&ctx->cq_cond);
+    pthread_cond_destroy(&ctx->sq_cond);
+    pthread_mutex_destroy(&ctx->lock);
+}
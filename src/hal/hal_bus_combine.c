@@ -0,0 +1,198 @@
+/*
+    hal_bus_combine.c
+
+    Bus partagé arbitré par combinaison (flat combining).
+
+    Appelant (combine_run) :
+    - trouve son enregistrement (hal_thread_slots, pas de verrou)
+    - y publie ses segments (REQ)
+    - boucle : fait ? -> terminé ; verrou libre ? -> le prend et combine ;
+      sinon attente active courte puis sched_yield
+
+    Combineur (combine_pass) :
+    - balaie les enregistrements depuis un départ tournant, exécute
+      chaque requête REQ sur le bus enveloppé et la marque DONE
+    - recommence tant qu'il trouve du travail (au plus
+      HAL_BUS_COMBINE_PASSES passes), puis rend le verrou
+*/
+
+#include "hal/hal_bus_combine.h"
+#include <sched.h>   // sched_yield
+#include <string.h>  // memset
+
+#define REC_EMPTY 0u
+#define REC_REQ   1u
+#define REC_DONE  2u
+
+/* Tours d'attente active avant de céder le CPU */
+#define SPIN_ITERS 64
+
+static int try_lock(hal_bus_combine_ctx_t *ctx)
+{
+    uint32_t expected = 0;
+    return atomic_load_explicit(&ctx->lock, memory_order_relaxed) == 0 &&
+           atomic_compare_exchange_strong_explicit(&ctx->lock, &expected, 1,
+                                                   memory_order_acquire, memory_order_relaxed);
+}
+
+static void unlock(hal_bus_combine_ctx_t *ctx)
+{
+    atomic_store_explicit(&ctx->lock, 0, memory_order_release);
+}
+
+/*
+    Un passage du combineur (verrou tenu). Renvoie le nombre servi.
+*/
+static unsigned combine_pass(hal_bus_combine_ctx_t *ctx)
+{
+    size_t n = hal_thread_slots_count(&ctx->recs);
+    unsigned served = 0;
+
+    for (size_t k = 0; k < n; k++) {
+        hal_bus_combine_rec_t *rec = hal_thread_slots_at(&ctx->recs, (ctx->next_scan + k) % n);
+
+        if (atomic_load_explicit(&rec->state, memory_order_acquire) != REC_REQ) {
+            continue;
+        }
+
+        rec->status = hal_bus_vectored(&ctx->inner, rec->segs, rec->n);
+        atomic_store_explicit(&rec->state, REC_DONE, memory_order_release);
+        served++;
+    }
+
+    // Le prochain combineur commence plus loin : personne n'est toujours servi en dernier
+    if (n) {
+        ctx->next_scan = (ctx->next_scan + 1) % (unsigned)n;
+    }
+    return served;
+}
+
+static void combine(hal_bus_combine_ctx_t *ctx)
+{
+    uint64_t served = 0;
+
+    for (int p = 0; p < HAL_BUS_COMBINE_PASSES; p++) {
+        unsigned s = combine_pass(ctx);
+        if (!s) {
+            break;
+        }
+        served += s;
+    }
+
+    // Requête déjà servie par le combineur précédent : pas de lot
+    if (!served) {
+        return;
+    }
+
+    // Compteurs écrits par le seul détenteur du verrou
+    atomic_store_explicit(&ctx->requests,
+                          atomic_load_explicit(&ctx->requests, memory_order_relaxed) + served,
+                          memory_order_relaxed);
+    atomic_store_explicit(&ctx->batches,
+                          atomic_load_explicit(&ctx->batches, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+}
+
+static hal_status_t combine_run(hal_bus_combine_ctx_t *ctx, const hal_bus_seg_t *segs, size_t n)
+{
+    hal_bus_combine_rec_t *rec = hal_thread_slots_get(&ctx->recs);
+    int spins = 0;
+
+    // Table pleine : exécution directe sous le verrou, sans combinaison
+    if (!rec) {
+        while (!try_lock(ctx)) {
+            if (++spins >= SPIN_ITERS) {
+                sched_yield();
+                spins = 0;
+            }
+        }
+        hal_status_t st = hal_bus_vectored(&ctx->inner, segs, n);
+        unlock(ctx);
+        return st;
+    }
+
+    rec->segs = segs;
+    rec->n = n;
+    atomic_store_explicit(&rec->state, REC_REQ, memory_order_release);
+
+    for (;;) {
+        if (atomic_load_explicit(&rec->state, memory_order_acquire) == REC_DONE) {
+            break;
+        }
+
+        if (try_lock(ctx)) {
+            combine(ctx);
+            unlock(ctx);
+            // Notre requête était publiée avant la prise du verrou : elle est servie
+            if (atomic_load_explicit(&rec->state, memory_order_acquire) == REC_DONE) {
+                break;
+            }
+            continue;
+        }
+
+        if (++spins >= SPIN_ITERS) {
+            sched_yield();
+            spins = 0;
+        }
+    }
+
+    hal_status_t st = rec->status;
+    atomic_store_explicit(&rec->state, REC_EMPTY, memory_order_relaxed);
+    return st;
+}
+
+static hal_status_t combine_read(void *context, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    hal_bus_seg_t sg = { dev_addr, reg, HAL_BUS_SEG_READ, data, len };
+    return combine_run((hal_bus_combine_ctx_t *)context, &sg, 1);
+}
+
+static hal_status_t combine_write(void *context, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    // Segment en écriture : data n'est que lu
+    hal_bus_seg_t sg = { dev_addr, reg, HAL_BUS_SEG_WRITE, (uint8_t *)(uintptr_t)data, len };
+    return combine_run((hal_bus_combine_ctx_t *)context, &sg, 1);
+}
+
+static hal_status_t combine_xfer(void *context, const hal_bus_seg_t *segs, size_t n)
+{
+    return combine_run((hal_bus_combine_ctx_t *)context, segs, n);
+}
+
+hal_status_t hal_bus_combine_init(
+    hal_bus_combine_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner)
+{
+    if (!ctx || !bus || !inner || !inner->reg_read || !inner->reg_write) {
+        return HAL_ERR;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->inner = *inner;
+    atomic_init(&ctx->lock, 0);
+    atomic_init(&ctx->requests, 0);
+    atomic_init(&ctx->batches, 0);
+
+    // Enregistrement libéré par un thread terminé : état vide, reprise immédiate
+    if (hal_thread_slots_init(&ctx->recs, sizeof(hal_bus_combine_rec_t), NULL) != 0) {
+        return HAL_ERR;
+    }
+
+    hal_bus_init(bus);
+    bus->ctx = ctx;
+    bus->reg_read = combine_read;
+    bus->reg_write = combine_write;
+    bus->xfer = combine_xfer;
+
+    return HAL_OK;
+}
+
+void hal_bus_combine_deinit(hal_bus_combine_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    hal_thread_slots_deinit(&ctx->recs);
+}
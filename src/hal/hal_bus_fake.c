@@ -7,18 +7,30 @@
     - stocke des registres dans ctx->regs
     - permet au driver de lire/écrire des registres comme s'il parlait à un vrai capteur
     - met à jour la température à chaque lecture pour "faire vivant"
+    - modélise une FIFO d'échantillons (niveau, watermark, overrun)
+      vidée en rafale par une lecture de FIFO_DATA
+    - en mode multi-capteurs, aiguille dev_addr vers le bon capteur simulé
 */
 
 #include "hal/hal_bus_fake.h"
+#include "sensor/sensor_regmap.h"
 #include <string.h> // memset
 
 /*
-    IMPORTANT :
-    Ces adresses doivent correspondre à celles utilisées dans sensor.c
+    Registres : carte partagée avec le driver (sensor/sensor_regmap.h).
 */
-#define REG_WHO_AM_I  0x00
-#define REG_TEMP_MSB  0x10
-#define REG_TEMP_LSB  0x11
+#define REG_WHO_AM_I     SENSOR_REG_WHO_AM_I
+#define REG_STATUS       SENSOR_REG_STATUS
+#define REG_TEMP_MSB     SENSOR_REG_TEMP_MSB
+#define REG_TEMP_LSB     SENSOR_REG_TEMP_LSB
+
+#define REG_FIFO_CTRL    SENSOR_REG_FIFO_CTRL
+#define REG_FIFO_STATUS  SENSOR_REG_FIFO_STATUS
+#define REG_FIFO_DATA    SENSOR_REG_FIFO_DATA
+
+#define FIFO_STATUS_OVR  SENSOR_FIFO_STATUS_OVR
+#define FIFO_STATUS_WTM  SENSOR_FIFO_STATUS_WTM
+#define FIFO_STATUS_LVL  SENSOR_FIFO_STATUS_LVL
 
 /*
     ID capteur simulé : doit correspondre à EXPECTED_ID du driver (sensor.c)
@@ -43,7 +55,126 @@ static void fake_update_temperature(hal_bus_fake_ctx_t *ctx)
 }
 
 /*
-    Lecture de registres simulée.
+    Recalcule le registre FIFO_STATUS à partir de l'état de la FIFO.
+
+    Appelé après chaque modification (remplissage, vidage, config).
+*/
+static void fake_fifo_refresh_status(hal_bus_fake_ctx_t *ctx)
+{
+    uint8_t status = (uint8_t)(ctx->fifo_count & FIFO_STATUS_LVL);
+    uint8_t wtm = ctx->regs[REG_FIFO_CTRL];
+
+    if (wtm != 0 && ctx->fifo_count >= wtm) {
+        status |= FIFO_STATUS_WTM;
+    }
+    if (ctx->fifo_overrun) {
+        status |= FIFO_STATUS_OVR;
+    }
+
+    ctx->regs[REG_FIFO_STATUS] = status;
+}
+
+/*
+    Vide la FIFO vers data[] (lecture en rafale de FIFO_DATA).
+
+    Comme sur un vrai capteur, l'adresse n'auto-incrémente pas :
+    chaque paire d'octets lue dépile un échantillon (MSB puis LSB).
+    Si la FIFO est vide, on renvoie des zéros.
+*/
+static void fake_fifo_drain(hal_bus_fake_ctx_t *ctx, uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    for (; i + 1 < len; i += 2) {
+        int16_t sample = 0;
+
+        if (ctx->fifo_count > 0) {
+            sample = ctx->fifo[ctx->fifo_head];
+            ctx->fifo_head = (uint8_t)((ctx->fifo_head + 1) % HAL_BUS_FAKE_FIFO_DEPTH);
+            ctx->fifo_count--;
+        }
+
+        data[i]     = (uint8_t)(((uint16_t)sample >> 8) & 0xFF);
+        data[i + 1] = (uint8_t)((uint16_t)sample & 0xFF);
+    }
+
+    // Octet isolé (len impair) : pas d'échantillon partiel
+    if (i < len) {
+        data[i] = 0;
+    }
+
+    fake_fifo_refresh_status(ctx);
+}
+
+/*
+    Lecture de registres dans UN capteur simulé.
+
+    Partagée par le bus mono-capteur et le bus multi-capteurs.
+*/
+static hal_status_t fake_dev_read(
+    hal_bus_fake_ctx_t *ctx,
+    uint8_t reg,
+    uint8_t *data,
+    size_t len
+)
+{
+    // Lecture FIFO : rafale d'échantillons, pas de registres consécutifs
+    if (reg == REG_FIFO_DATA) {
+        fake_fifo_drain(ctx, data, len);
+        return HAL_OK;
+    }
+
+    // On met à jour la température AVANT de répondre,
+    // pour que chaque lecture renvoie une valeur qui évolue.
+    fake_update_temperature(ctx);
+
+    // Copie des registres vers data[]
+    for (size_t i = 0; i < len; i++) {
+        data[i] = ctx->regs[(uint8_t)(reg + i)];
+    }
+
+    // Le drapeau d'overrun est effacé par la lecture de FIFO_STATUS
+    if ((uint8_t)(REG_FIFO_STATUS - reg) < len && ctx->fifo_overrun) {
+        ctx->fifo_overrun = 0;
+        fake_fifo_refresh_status(ctx);
+    }
+
+    return HAL_OK;
+}
+
+/*
+    Écriture de registres dans UN capteur simulé.
+*/
+static hal_status_t fake_dev_write(
+    hal_bus_fake_ctx_t *ctx,
+    uint8_t reg,
+    const uint8_t *data,
+    size_t len
+)
+{
+    // Copier data[] vers les registres
+    for (size_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+
+        // Registres en lecture seule (WHO_AM_I, STATUS, TEMP, FIFO) ou hors carte : ignorés
+        if (!sensor_regmap_is_writable(r)) {
+            continue;
+        }
+
+        ctx->regs[r] = data[i];
+    }
+
+    // Le watermark a pu changer
+    fake_fifo_refresh_status(ctx);
+
+    return HAL_OK;
+}
+
+/*
+    Lecture de registres simulée (bus mono-capteur).
+
+    Publique pour la liaison statique (hal_bind_host.h) ;
+    sinon, passer par bus->reg_read.
 
     Paramètres (mêmes que l'interface HAL) :
     - context : pointeur vers hal_bus_fake_ctx_t
@@ -52,7 +183,7 @@ static void fake_update_temperature(hal_bus_fake_ctx_t *ctx)
     - data : buffer où écrire les octets lus
     - len : nombre d'octets à lire
 */
-static hal_status_t fake_reg_read(
+hal_status_t hal_bus_fake_reg_read(
     void *context,
     uint8_t dev_addr,
     uint8_t reg,
@@ -67,50 +198,173 @@ static hal_status_t fake_reg_read(
         return HAL_ERR;
     }
 
-    hal_bus_fake_ctx_t *ctx = (hal_bus_fake_ctx_t *)context;
+    return fake_dev_read((hal_bus_fake_ctx_t *)context, reg, data, len);
+}
 
-    // On met à jour la température AVANT de répondre,
-    // pour que chaque lecture renvoie une valeur qui évolue.
-    fake_update_temperature(ctx);
+/*
+    Écriture de registres simulée (bus mono-capteur).
 
-    // Copie des registres vers data[]
-    for (size_t i = 0; i < len; i++) {
-        data[i] = ctx->regs[(uint8_t)(reg + i)];
+    Permet au driver d'écrire dans des registres de config, etc.
+*/
+hal_status_t hal_bus_fake_reg_write(
+    void *context,
+    uint8_t dev_addr,
+    uint8_t reg,
+    const uint8_t *data,
+    size_t len
+)
+{
+    (void)dev_addr; // pas utilisé
+
+    // Vérifications basiques
+    if (!context || !data) {
+        return HAL_ERR;
     }
 
+    return fake_dev_write((hal_bus_fake_ctx_t *)context, reg, data, len);
+}
+
+/*
+    Transfert vectorisé simulé (bus mono-capteur) : les segments
+    s'enchaînent comme des restarts, arrêt au premier échec.
+*/
+hal_status_t hal_bus_fake_xfer(
+    void *context,
+    const hal_bus_seg_t *segs,
+    size_t n
+)
+{
+    if (!context || (n && !segs)) {
+        return HAL_ERR;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const hal_bus_seg_t *sg = &segs[i];
+        hal_status_t st = (sg->dir == HAL_BUS_SEG_WRITE)
+            ? hal_bus_fake_reg_write(context, sg->dev_addr, sg->reg, sg->data, sg->len)
+            : hal_bus_fake_reg_read(context, sg->dev_addr, sg->reg, sg->data, sg->len);
+        if (st != HAL_OK) {
+            return st;
+        }
+    }
     return HAL_OK;
 }
 
 /*
-    Écriture de registres simulée.
+    Résout l'adresse vers le capteur simulé (O(1), table directe).
 
-    Permet au driver d'écrire dans des registres de config, etc.
+    Renvoie NULL si aucun capteur ne répond (NACK) et le compte.
+*/
+static hal_bus_fake_ctx_t *multi_lookup(hal_bus_fake_multi_ctx_t *ctx, uint8_t dev_addr)
+{
+    hal_bus_fake_ctx_t *dev = NULL;
+
+    if (dev_addr < HAL_BUS_FAKE_MAX_DEVICES) {
+        dev = ctx->devices[dev_addr];
+    }
+    if (!dev) {
+        ctx->nack_count++;
+    }
+
+    return dev;
+}
+
+/*
+    Lecture de registres simulée (bus multi-capteurs).
 */
-static hal_status_t fake_reg_write(
+static hal_status_t fake_multi_reg_read(
     void *context,
     uint8_t dev_addr,
     uint8_t reg,
-    const uint8_t *data,
+    uint8_t *data,
     size_t len
 )
 {
-    (void)dev_addr; // pas utilisé
+    if (!context || !data) {
+        return HAL_ERR;
+    }
 
-    // Vérifications basiques
+    hal_bus_fake_ctx_t *dev = multi_lookup((hal_bus_fake_multi_ctx_t *)context, dev_addr);
+    if (!dev) {
+        return HAL_ERR; // NACK : personne à cette adresse
+    }
+
+    return fake_dev_read(dev, reg, data, len);
+}
+
+/*
+    Écriture de registres simulée (bus multi-capteurs).
+*/
+static hal_status_t fake_multi_reg_write(
+    void *context,
+    uint8_t dev_addr,
+    uint8_t reg,
+    const uint8_t *data,
+    size_t len
+)
+{
     if (!context || !data) {
         return HAL_ERR;
     }
 
-    hal_bus_fake_ctx_t *ctx = (hal_bus_fake_ctx_t *)context;
+    hal_bus_fake_ctx_t *dev = multi_lookup((hal_bus_fake_multi_ctx_t *)context, dev_addr);
+    if (!dev) {
+        return HAL_ERR;
+    }
 
-    // Copier data[] vers les registres
-    for (size_t i = 0; i < len; i++) {
-        ctx->regs[(uint8_t)(reg + i)] = data[i];
+    return fake_dev_write(dev, reg, data, len);
+}
+
+/*
+    Transfert vectorisé (bus multi-capteurs) : appels directs, sans
+    passer par les pointeurs de fonction.
+*/
+static hal_status_t fake_multi_xfer(void *context, const hal_bus_seg_t *segs, size_t n)
+{
+    if (!context || (n && !segs)) {
+        return HAL_ERR;
     }
 
+    for (size_t i = 0; i < n; i++) {
+        const hal_bus_seg_t *sg = &segs[i];
+        hal_status_t st = (sg->dir == HAL_BUS_SEG_WRITE)
+            ? fake_multi_reg_write(context, sg->dev_addr, sg->reg, sg->data, sg->len)
+            : fake_multi_reg_read(context, sg->dev_addr, sg->reg, sg->data, sg->len);
+        if (st != HAL_OK) {
+            return st;
+        }
+    }
     return HAL_OK;
 }
 
+/*
+    Production de n échantillons dans la FIFO (voir hal_bus_fake.h).
+*/
+void hal_bus_fake_fifo_fill(hal_bus_fake_ctx_t *ctx, size_t n)
+{
+    if (!ctx) {
+        return;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        // Nouvel échantillon : même modèle que la lecture directe
+        fake_update_temperature(ctx);
+
+        if (ctx->fifo_count == HAL_BUS_FAKE_FIFO_DEPTH) {
+            // FIFO pleine : on écrase le plus ancien
+            ctx->fifo_head = (uint8_t)((ctx->fifo_head + 1) % HAL_BUS_FAKE_FIFO_DEPTH);
+            ctx->fifo_count--;
+            ctx->fifo_overrun = 1;
+        }
+
+        uint8_t tail = (uint8_t)((ctx->fifo_head + ctx->fifo_count) % HAL_BUS_FAKE_FIFO_DEPTH);
+        ctx->fifo[tail] = ctx->fake_temp_centi;
+        ctx->fifo_count++;
+    }
+
+    fake_fifo_refresh_status(ctx);
+}
+
 /*
     Fonction publique d'initialisation.
 
@@ -123,6 +377,25 @@ void hal_bus_fake_init(hal_bus_fake_ctx_t *ctx, hal_bus_t *bus)
         return;
     }
 
+    hal_bus_fake_dev_init(ctx);
+
+    // Configurer l'interface HAL bus
+    hal_bus_init(bus);
+    bus->ctx = ctx;
+    bus->reg_read = hal_bus_fake_reg_read;
+    bus->reg_write = hal_bus_fake_reg_write;
+    bus->xfer = hal_bus_fake_xfer;
+}
+
+/*
+    Remise à zéro d'un capteur simulé (sans bus).
+*/
+void hal_bus_fake_dev_init(hal_bus_fake_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
     // Reset complet des registres et de la température
     memset(ctx, 0, sizeof(*ctx));
 
@@ -132,12 +405,45 @@ void hal_bus_fake_init(hal_bus_fake_ctx_t *ctx, hal_bus_t *bus)
     // Régler WHO_AM_I pour que sensor_init() réussisse
     ctx->regs[REG_WHO_AM_I] = FAKE_SENSOR_ID;
 
+    // Une mesure est toujours prête
+    ctx->regs[REG_STATUS] = SENSOR_STATUS_DRDY;
+
     // Régler les registres temp au départ
     ctx->regs[REG_TEMP_MSB] = (uint8_t)((ctx->fake_temp_centi >> 8) & 0xFF);
     ctx->regs[REG_TEMP_LSB] = (uint8_t)(ctx->fake_temp_centi & 0xFF);
+}
 
-    // Configurer l'interface HAL bus
+/*
+    Initialisation du bus multi-capteurs : aucune adresse ne répond.
+*/
+void hal_bus_fake_multi_init(hal_bus_fake_multi_ctx_t *ctx, hal_bus_t *bus)
+{
+    if (!ctx || !bus) {
+        return;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+
+    hal_bus_init(bus);
     bus->ctx = ctx;
-    bus->reg_read = fake_reg_read;
-    bus->reg_write = fake_reg_write;
+    bus->reg_read = fake_multi_reg_read;
+    bus->reg_write = fake_multi_reg_write;
+    bus->xfer = fake_multi_xfer;
+}
+
+/*
+    Branche (ou débranche avec dev == NULL) un capteur à une adresse.
+*/
+hal_status_t hal_bus_fake_multi_attach(
+    hal_bus_fake_multi_ctx_t *ctx,
+    uint8_t dev_addr,
+    hal_bus_fake_ctx_t *dev
+)
+{
+    if (!ctx || dev_addr >= HAL_BUS_FAKE_MAX_DEVICES) {
+        return HAL_ERR;
+    }
+
+    ctx->devices[dev_addr] = dev;
+    return HAL_OK;
 }
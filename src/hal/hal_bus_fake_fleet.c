@@ -0,0 +1,373 @@
+/*
+    hal_bus_fake_fleet.c
+
+    Flotte de capteurs simulés à registres creux (copy-on-write).
+
+    Lecture d'un registre, par ordre de priorité :
+    1. registre volatil -> généré (température, FIFO vide)
+    2. page privée du capteur si elle existe
+    3. entrée inline si le registre a été écrit
+    4. page modèle partagée
+*/
+
+#include "hal/hal_bus_fake_fleet.h"
+#include "sensor/sensor_regmap.h"
+#include <stdlib.h> // calloc, realloc, free
+#include <string.h> // memset, memcpy
+
+/*
+    Registres : carte partagée avec le driver (sensor/sensor_regmap.h).
+*/
+#define REG_WHO_AM_I     SENSOR_REG_WHO_AM_I
+#define REG_STATUS       SENSOR_REG_STATUS
+#define REG_TEMP_MSB     SENSOR_REG_TEMP_MSB
+#define REG_TEMP_LSB     SENSOR_REG_TEMP_LSB
+#define REG_FIFO_DATA    SENSOR_REG_FIFO_DATA
+
+#define FAKE_SENSOR_ID 0x42
+
+static int is_volatile(const hal_fake_model_t *m, uint8_t reg)
+{
+    return (m->volatile_map[reg >> 3] >> (reg & 7)) & 1;
+}
+
+static void set_volatile(hal_fake_model_t *m, uint8_t reg)
+{
+    m->volatile_map[reg >> 3] |= (uint8_t)(1u << (reg & 7));
+}
+
+/*
+    Génère la valeur d'un registre volatil.
+
+    temp a déjà été mis à jour pour la transaction en cours.
+*/
+static uint8_t volatile_value(int16_t temp, uint8_t reg)
+{
+    switch (reg) {
+        case REG_TEMP_MSB: return (uint8_t)(((uint16_t)temp >> 8) & 0xFF);
+        case REG_TEMP_LSB: return (uint8_t)((uint16_t)temp & 0xFF);
+        case REG_STATUS:   return SENSOR_STATUS_DRDY;
+        default:           return 0; // FIFO absente : vide
+    }
+}
+
+/*
+    Lecture d'un registre non volatil.
+*/
+static uint8_t sparse_get(
+    const hal_bus_fake_fleet_t *fleet,
+    const hal_fake_sparse_dev_t *dev,
+    uint8_t reg
+)
+{
+    if (dev->page) {
+        return fleet->pages[dev->page - 1][reg];
+    }
+
+    for (uint8_t i = 0; i < dev->n_inline; i++) {
+        if (dev->inline_reg[i] == reg) {
+            return dev->inline_val[i];
+        }
+    }
+
+    return fleet->model->regs[reg];
+}
+
+/*
+    Copie le capteur dans une nouvelle page privée (copy-on-write).
+
+    La page part du modèle, puis reçoit les entrées inline.
+*/
+static hal_status_t sparse_promote(hal_bus_fake_fleet_t *fleet, hal_fake_sparse_dev_t *dev)
+{
+    if (fleet->n_pages == fleet->cap_pages) {
+        uint32_t cap = fleet->cap_pages ? fleet->cap_pages * 2 : 64;
+        uint8_t (*pages)[256] = realloc(fleet->pages, (size_t)cap * sizeof(*pages));
+        if (!pages) {
+            return HAL_ERR;
+        }
+        fleet->pages = pages;
+        fleet->cap_pages = cap;
+    }
+
+    uint8_t *page = fleet->pages[fleet->n_pages];
+    memcpy(page, fleet->model->regs, 256);
+    for (uint8_t i = 0; i < dev->n_inline; i++) {
+        page[dev->inline_reg[i]] = dev->inline_val[i];
+    }
+
+    fleet->n_pages++;
+    dev->page = fleet->n_pages; // index 1-based
+    dev->n_inline = 0;
+
+    return HAL_OK;
+}
+
+/*
+    Écriture d'un registre non volatil.
+*/
+static hal_status_t sparse_set(
+    hal_bus_fake_fleet_t *fleet,
+    hal_fake_sparse_dev_t *dev,
+    uint8_t reg,
+    uint8_t value
+)
+{
+    if (!dev->page) {
+        for (uint8_t i = 0; i < dev->n_inline; i++) {
+            if (dev->inline_reg[i] == reg) {
+                dev->inline_val[i] = value;
+                return HAL_OK;
+            }
+        }
+
+        if (dev->n_inline < HAL_FAKE_SPARSE_INLINE) {
+            dev->inline_reg[dev->n_inline] = reg;
+            dev->inline_val[dev->n_inline] = value;
+            dev->n_inline++;
+            return HAL_OK;
+        }
+
+        // Plus de place inline : page privée
+        if (sparse_promote(fleet, dev) != HAL_OK) {
+            return HAL_ERR;
+        }
+    }
+
+    fleet->pages[dev->page - 1][reg] = value;
+    return HAL_OK;
+}
+
+/*
+    Résout (port, adresse) vers le capteur. Compte les NACK.
+*/
+static hal_fake_sparse_dev_t *port_lookup(hal_bus_fake_fleet_port_t *port, uint8_t dev_addr)
+{
+    hal_bus_fake_fleet_t *fleet = port->fleet;
+    hal_fake_sparse_dev_t *dev = hal_bus_fake_fleet_dev(fleet, port->bus_index, dev_addr);
+
+    if (!dev) {
+        fleet->nack_count++;
+    }
+    return dev;
+}
+
+static hal_status_t fleet_reg_read(
+    void *context,
+    uint8_t dev_addr,
+    uint8_t reg,
+    uint8_t *data,
+    size_t len
+)
+{
+    if (!context || !data) {
+        return HAL_ERR;
+    }
+
+    hal_bus_fake_fleet_port_t *port = (hal_bus_fake_fleet_port_t *)context;
+    hal_fake_sparse_dev_t *dev = port_lookup(port, dev_addr);
+    if (!dev) {
+        return HAL_ERR; // NACK
+    }
+
+    const hal_bus_fake_fleet_t *fleet = port->fleet;
+    const hal_fake_model_t *model = fleet->model;
+
+    // Même modèle que hal_bus_fake : la température avance à chaque lecture
+    dev->temp_centi = (int16_t)(dev->temp_centi + model->temp_step_centi);
+
+    if (reg == REG_FIFO_DATA) {
+        memset(data, 0, len);
+        return HAL_OK;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+        data[i] = is_volatile(model, r) ? volatile_value(dev->temp_centi, r)
+                                        : sparse_get(fleet, dev, r);
+    }
+
+    return HAL_OK;
+}
+
+static hal_status_t fleet_reg_write(
+    void *context,
+    uint8_t dev_addr,
+    uint8_t reg,
+    const uint8_t *data,
+    size_t len
+)
+{
+    if (!context || !data) {
+        return HAL_ERR;
+    }
+
+    hal_bus_fake_fleet_port_t *port = (hal_bus_fake_fleet_port_t *)context;
+    hal_fake_sparse_dev_t *dev = port_lookup(port, dev_addr);
+    if (!dev) {
+        return HAL_ERR;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+
+        // Registres volatils : en lecture seule
+        if (is_volatile(port->fleet->model, r)) {
+            continue;
+        }
+        if (sparse_set(port->fleet, dev, r, data[i]) != HAL_OK) {
+            return HAL_ERR;
+        }
+    }
+
+    return HAL_OK;
+}
+
+/*
+    Modèle par défaut : équivalent à hal_bus_fake_init().
+*/
+void hal_fake_model_init_default(hal_fake_model_t *model)
+{
+    if (!model) {
+        return;
+    }
+
+    memset(model, 0, sizeof(*model));
+
+    model->regs[REG_WHO_AM_I] = FAKE_SENSOR_ID;
+    model->temp_start_centi = 2500;
+    model->temp_step_centi = 5;
+
+    // Registres volatils : ceux marqués comme tels dans la carte
+    for (unsigned r = 0; r < 256; r++) {
+        if (sensor_regmap_is_volatile((uint8_t)r)) {
+            set_volatile(model, (uint8_t)r);
+        }
+    }
+}
+
+hal_status_t hal_bus_fake_fleet_init(
+    hal_bus_fake_fleet_t *fleet,
+    const hal_fake_model_t *model,
+    uint32_t n_buses,
+    uint16_t devs_per_bus,
+    uint8_t addr_base
+)
+{
+    if (!fleet || !model || n_buses == 0 || devs_per_bus == 0 ||
+        (uint32_t)addr_base + devs_per_bus > 128u) {
+        return HAL_ERR;
+    }
+
+    memset(fleet, 0, sizeof(*fleet));
+    fleet->model = model;
+    fleet->n_buses = n_buses;
+    fleet->devs_per_bus = devs_per_bus;
+    fleet->addr_base = addr_base;
+
+    fleet->devs = calloc((size_t)n_buses * devs_per_bus, sizeof(*fleet->devs));
+    fleet->ports = calloc(n_buses, sizeof(*fleet->ports));
+    if (!fleet->devs || !fleet->ports) {
+        hal_bus_fake_fleet_deinit(fleet);
+        return HAL_ERR;
+    }
+
+    // calloc : pas de page, pas d'entrée inline ; reste la température
+    size_t n = (size_t)n_buses * devs_per_bus;
+    for (size_t i = 0; i < n; i++) {
+        fleet->devs[i].temp_centi = model->temp_start_centi;
+    }
+
+    for (uint32_t b = 0; b < n_buses; b++) {
+        fleet->ports[b].fleet = fleet;
+        fleet->ports[b].bus_index = b;
+    }
+
+    return HAL_OK;
+}
+
+void hal_bus_fake_fleet_deinit(hal_bus_fake_fleet_t *fleet)
+{
+    if (!fleet) {
+        return;
+    }
+
+    free(fleet->devs);
+    free(fleet->ports);
+    free(fleet->pages);
+    memset(fleet, 0, sizeof(*fleet));
+}
+
+/*
+    Transfert vectorisé : appels directs, sans pointeur de fonction.
+*/
+static hal_status_t fleet_xfer(void *context, const hal_bus_seg_t *segs, size_t n)
+{
+    if (!context || (n && !segs)) {
+        return HAL_ERR;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        const hal_bus_seg_t *sg = &segs[i];
+        hal_status_t st = (sg->dir == HAL_BUS_SEG_WRITE)
+            ? fleet_reg_write(context, sg->dev_addr, sg->reg, sg->data, sg->len)
+            : fleet_reg_read(context, sg->dev_addr, sg->reg, sg->data, sg->len);
+        if (st != HAL_OK) {
+            return st;
+        }
+    }
+    return HAL_OK;
+}
+
+hal_status_t hal_bus_fake_fleet_bus(
+    hal_bus_fake_fleet_t *fleet,
+    uint32_t bus_index,
+    hal_bus_t *bus
+)
+{
+    if (!fleet || !bus || bus_index >= fleet->n_buses) {
+        return HAL_ERR;
+    }
+
+    hal_bus_init(bus);
+    bus->ctx = &fleet->ports[bus_index];
+    bus->reg_read = fleet_reg_read;
+    bus->reg_write = fleet_reg_write;
+    bus->xfer = fleet_xfer;
+
+    return HAL_OK;
+}
+
+hal_fake_sparse_dev_t *hal_bus_fake_fleet_dev(
+    hal_bus_fake_fleet_t *fleet,
+    uint32_t bus_index,
+    uint8_t dev_addr
+)
+{
+    if (!fleet || bus_index >= fleet->n_buses) {
+        return NULL;
+    }
+
+    if (dev_addr < fleet->addr_base) {
+        return NULL;
+    }
+
+    uint32_t slot = (uint32_t)(dev_addr - fleet->addr_base);
+    if (slot >= fleet->devs_per_bus) {
+        return NULL;
+    }
+
+    return &fleet->devs[(size_t)bus_index * fleet->devs_per_bus + slot];
+}
+
+size_t hal_bus_fake_fleet_memory(const hal_bus_fake_fleet_t *fleet)
+{
+    if (!fleet) {
+        return 0;
+    }
+
+    return sizeof(*fleet)
+         + (size_t)fleet->n_buses * fleet->devs_per_bus * sizeof(*fleet->devs)
+         + (size_t)fleet->n_buses * sizeof(*fleet->ports)
+         + (size_t)fleet->cap_pages * 256u;
+}
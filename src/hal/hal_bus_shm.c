@@ -0,0 +1,575 @@
+/*
+    hal_bus_shm.c
+
+    Bus vers un simulateur hors processus, par mémoire partagée.
+
+    Client (shm_run_chain) :
+    - prend des emplacements libres (CAS FREE -> CLAIMED), un par segment,
+      chaînés par next ; une transaction simple est une chaîne de 1
+    - copie les requêtes, publie la tête (POSTED), réveille le serveur s'il dort
+    - attend DONE sur la tête : attente active courte, puis futex sur
+      l'état (le bit WAITER indique au serveur qu'il doit réveiller)
+
+    Serveur (hal_bus_shm_serve) :
+    - au démarrage, reprend les chaînes laissées par un serveur mort
+      (TAKEN / ORPHAN : il n'y a qu'un serveur par région)
+    - balaie les emplacements, exécute chaque chaîne POSTED dans l'ordre
+      sur le modèle local (op et len revalidés : l'autre processus peut
+      être bogué), publie DONE sur la tête
+    - rien à faire : attente active courte, puis futex sur req_seq
+*/
+
+#define _GNU_SOURCE
+
+#include "hal/hal_bus_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+/* États d'un emplacement (octet bas) + bit "client endormi" */
+#define SLOT_FREE     0u
+#define SLOT_CLAIMED  1u
+#define SLOT_POSTED   2u
+#define SLOT_TAKEN    3u
+#define SLOT_DONE     4u
+#define SLOT_ORPHAN   5u   // client reparti sur timeout : le serveur libère
+#define SLOT_MASK     0xFFu
+#define SLOT_WAITER   0x100u
+
+#define OP_READ  0u
+#define OP_WRITE 1u
+
+/* Tours d'attente active avant de dormir */
+#define SPIN_ITERS 200
+
+/* Le serveur se réveille au moins à cette période (stop manqué, client mort) */
+#define SERVER_IDLE_NS 100000000L
+
+/* Sans futex : période de scrutation */
+#define POLL_NS 50000L
+
+/* ---------------- Attente / réveil ---------------- */
+
+/*
+    Dort tant que *addr == val (au plus rel_ns, 0 = pas de limite).
+*/
+static void wait_on(_Atomic uint32_t *addr, uint32_t val, long rel_ns)
+{
+#ifdef __linux__
+    struct timespec ts = { rel_ns / 1000000000L, rel_ns % 1000000000L };
+    // Futex partagé (pas FUTEX_PRIVATE) : la région est vue par deux processus
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAIT, val, rel_ns ? &ts : NULL, NULL, 0);
+#else
+    if (atomic_load(addr) == val) {
+        long ns = (rel_ns && rel_ns < POLL_NS) ? rel_ns : POLL_NS;
+        struct timespec ts = { 0, ns };
+        nanosleep(&ts, NULL);
+    }
+#endif
+}
+
+static void wake_all(_Atomic uint32_t *addr)
+{
+#ifdef __linux__
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#else
+    (void)addr;
+#endif
+}
+
+static uint64_t mono_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* ---------------- Région ---------------- */
+
+static void region_init(hal_bus_shm_region_t *r)
+{
+    memset(r, 0, sizeof(*r));
+    atomic_init(&r->req_seq, 0);
+    atomic_init(&r->server_waiting, 0);
+    atomic_init(&r->stop, 0);
+    for (unsigned i = 0; i < HAL_BUS_SHM_SLOTS; i++) {
+        atomic_init(&r->slots[i].state, SLOT_FREE);
+    }
+    r->version = HAL_BUS_SHM_VERSION;
+
+    // Magic en dernier : une région incomplète n'est jamais reconnue
+    atomic_thread_fence(memory_order_release);
+    r->magic = HAL_BUS_SHM_MAGIC;
+}
+
+static void shm_reset(hal_bus_shm_t *shm)
+{
+    memset(shm, 0, sizeof(*shm));
+    shm->timeout_ms = HAL_BUS_SHM_TIMEOUT_MS;
+}
+
+hal_status_t hal_bus_shm_create(hal_bus_shm_t *shm, const char *name)
+{
+    if (!shm) {
+        return HAL_ERR;
+    }
+    shm_reset(shm);
+
+    void *map;
+    if (name) {
+        if (strlen(name) >= sizeof(shm->name)) {
+            return HAL_ERR;
+        }
+
+        int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            return HAL_ERR;
+        }
+        if (ftruncate(fd, (off_t)sizeof(hal_bus_shm_region_t)) != 0) {
+            close(fd);
+            shm_unlink(name);
+            return HAL_ERR;
+        }
+
+        map = mmap(NULL, sizeof(hal_bus_shm_region_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            shm_unlink(name);
+            return HAL_ERR;
+        }
+        strcpy(shm->name, name);
+    } else {
+        map = mmap(NULL, sizeof(hal_bus_shm_region_t), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED) {
+            return HAL_ERR;
+        }
+    }
+
+    shm->region = (hal_bus_shm_region_t *)map;
+    shm->owner = 1;
+    region_init(shm->region);
+    return HAL_OK;
+}
+
+hal_status_t hal_bus_shm_attach(hal_bus_shm_t *shm, const char *name)
+{
+    if (!shm || !name) {
+        return HAL_ERR;
+    }
+    shm_reset(shm);
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return HAL_ERR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(hal_bus_shm_region_t)) {
+        close(fd);
+        return HAL_ERR;
+    }
+
+    void *map = mmap(NULL, sizeof(hal_bus_shm_region_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return HAL_ERR;
+    }
+
+    hal_bus_shm_region_t *r = (hal_bus_shm_region_t *)map;
+    if (r->magic != HAL_BUS_SHM_MAGIC || r->version != HAL_BUS_SHM_VERSION) {
+        munmap(map, sizeof(hal_bus_shm_region_t));
+        return HAL_ERR;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    shm->region = r;
+    return HAL_OK;
+}
+
+void hal_bus_shm_detach(hal_bus_shm_t *shm)
+{
+    if (!shm || !shm->region) {
+        return;
+    }
+
+    munmap(shm->region, sizeof(hal_bus_shm_region_t));
+    if (shm->owner && shm->name[0]) {
+        shm_unlink(shm->name);
+    }
+    shm->region = NULL;
+}
+
+void hal_bus_shm_shutdown(hal_bus_shm_t *shm)
+{
+    if (!shm || !shm->region) {
+        return;
+    }
+
+    atomic_store(&shm->region->stop, 1);
+    atomic_fetch_add(&shm->region->req_seq, 1);
+    wake_all(&shm->region->req_seq);
+}
+
+/* ---------------- Client ---------------- */
+
+/* Premier emplacement essayé par ce thread (évite que tous se battent pour le 0) */
+static _Thread_local unsigned t_slot_hint;
+
+static hal_bus_shm_slot_t *claim_slot(hal_bus_shm_region_t *r)
+{
+    for (unsigned k = 0; k < HAL_BUS_SHM_SLOTS; k++) {
+        unsigned i = (t_slot_hint + k) % HAL_BUS_SHM_SLOTS;
+        uint32_t expected = SLOT_FREE;
+        if (atomic_compare_exchange_strong_explicit(&r->slots[i].state, &expected, SLOT_CLAIMED,
+                                                    memory_order_acquire, memory_order_relaxed)) {
+            t_slot_hint = i;
+            return &r->slots[i];
+        }
+    }
+    return NULL;
+}
+
+/*
+    Prend un emplacement, en laissant tourner le serveur si tous sont occupés.
+*/
+static hal_bus_shm_slot_t *claim_slot_wait(hal_bus_shm_region_t *r, uint64_t timeout_ns)
+{
+    hal_bus_shm_slot_t *slot = claim_slot(r);
+    if (slot) {
+        return slot;
+    }
+
+    uint64_t deadline = mono_ns() + timeout_ns;
+    while (!(slot = claim_slot(r))) {
+        if (mono_ns() >= deadline) {
+            return NULL;
+        }
+        struct timespec ts = { 0, POLL_NS };
+        nanosleep(&ts, NULL);
+    }
+    return slot;
+}
+
+/*
+    Attend DONE sur la tête de chaîne.
+
+    Renvoie 0, ou si le délai expire :
+    -1 : jamais prise par le serveur, la tête est rendue (FREE)
+    -2 : en cours d'exécution, le serveur libérera la chaîne (ORPHAN)
+*/
+static int wait_done(hal_bus_shm_slot_t *slot, uint64_t timeout_ns)
+{
+    for (int i = 0; i < SPIN_ITERS; i++) {
+        if ((atomic_load_explicit(&slot->state, memory_order_acquire) & SLOT_MASK) == SLOT_DONE) {
+            return 0;
+        }
+    }
+
+    uint64_t deadline = mono_ns() + timeout_ns;
+
+    for (;;) {
+        uint32_t s = atomic_fetch_or_explicit(&slot->state, SLOT_WAITER, memory_order_acq_rel);
+        if ((s & SLOT_MASK) == SLOT_DONE) {
+            return 0;
+        }
+
+        uint64_t now = mono_ns();
+        if (now >= deadline) {
+            s |= SLOT_WAITER;
+            int posted = (s & SLOT_MASK) == SLOT_POSTED;
+            if (atomic_compare_exchange_strong(&slot->state, &s, posted ? SLOT_FREE : SLOT_ORPHAN)) {
+                return posted ? -1 : -2;
+            }
+            continue;   // l'état vient de changer (DONE probablement)
+        }
+
+        wait_on(&slot->state, s | SLOT_WAITER, (long)(deadline - now));
+    }
+}
+
+/*
+    Envoie les premiers segments de segs[0..n-1] en une chaîne :
+    autant d'emplacements libres que possible (au moins un), un seul
+    publié (la tête), un seul réveil du serveur, une seule attente.
+    *n_sent : nombre de segments envoyés.
+*/
+static hal_status_t shm_run_chain(hal_bus_shm_t *shm, const hal_bus_seg_t *segs, size_t n, size_t *n_sent)
+{
+    hal_bus_shm_region_t *r = shm->region;
+    uint64_t timeout_ns = (uint64_t)shm->timeout_ms * 1000000u;
+    hal_bus_shm_slot_t *chain[HAL_BUS_SHM_SLOTS];
+    size_t k = 0;
+
+    *n_sent = 0;
+
+    chain[k] = claim_slot_wait(r, timeout_ns);
+    if (!chain[k]) {
+        return HAL_TIMEOUT;
+    }
+    k++;
+    while (k < n && k < HAL_BUS_SHM_SLOTS && (chain[k] = claim_slot(r)) != NULL) {
+        k++;
+    }
+
+    for (size_t j = 0; j < k; j++) {
+        hal_bus_shm_slot_t *slot = chain[j];
+        const hal_bus_seg_t *sg = &segs[j];
+
+        slot->op = (sg->dir == HAL_BUS_SEG_WRITE) ? OP_WRITE : OP_READ;
+        slot->dev_addr = sg->dev_addr;
+        slot->reg = sg->reg;
+        slot->len = (uint32_t)sg->len;
+        slot->status = (int8_t)HAL_ERR;   // non exécuté tant que le serveur n'y est pas passé
+        slot->next = (j + 1 < k) ? (uint8_t)(chain[j + 1] - r->slots) : HAL_BUS_SHM_END;
+        if (slot->op == OP_WRITE) {
+            memcpy(slot->data, sg->data, sg->len);
+        }
+    }
+    *n_sent = k;
+
+    hal_bus_shm_slot_t *head = chain[0];
+    atomic_store_explicit(&head->state, SLOT_POSTED, memory_order_release);
+
+    // Dekker avec le serveur : publier puis lire server_waiting (seq_cst des deux côtés)
+    atomic_fetch_add(&r->req_seq, 1);
+    if (atomic_load(&r->server_waiting)) {
+        wake_all(&r->req_seq);
+    }
+
+    int w = wait_done(head, timeout_ns);
+    if (w != 0) {
+        // Tête rendue : les autres maillons n'ont jamais été vus par le serveur
+        if (w == -1) {
+            for (size_t j = 1; j < k; j++) {
+                atomic_store_explicit(&chain[j]->state, SLOT_FREE, memory_order_release);
+            }
+        }
+        return HAL_TIMEOUT;
+    }
+
+    hal_status_t st = HAL_OK;
+    for (size_t j = 0; j < k; j++) {
+        hal_bus_shm_slot_t *slot = chain[j];
+        hal_status_t seg_st = (hal_status_t)slot->status;
+
+        if (st == HAL_OK) {
+            st = seg_st;
+        }
+        if (seg_st == HAL_OK && slot->op == OP_READ) {
+            memcpy(segs[j].data, slot->data, segs[j].len);
+        }
+    }
+    for (size_t j = k; j-- > 0;) {
+        atomic_store_explicit(&chain[j]->state, SLOT_FREE, memory_order_release);
+    }
+    return st;
+}
+
+static hal_status_t shm_xfer(void *ctx, const hal_bus_seg_t *segs, size_t n)
+{
+    hal_bus_shm_t *shm = (hal_bus_shm_t *)ctx;
+
+    for (size_t i = 0; i < n; i++) {
+        if (segs[i].len > HAL_BUS_SHM_MAX_LEN) {
+            return HAL_ERR;
+        }
+    }
+
+    // Plus de segments que d'emplacements libres : chaînes successives
+    size_t done = 0;
+    while (done < n) {
+        size_t sent;
+        hal_status_t st = shm_run_chain(shm, segs + done, n - done, &sent);
+        if (st != HAL_OK) {
+            return st;
+        }
+        done += sent;
+    }
+    return HAL_OK;
+}
+
+static hal_status_t shm_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    hal_bus_seg_t sg = { dev_addr, reg, HAL_BUS_SEG_READ, data, len };
+    return shm_xfer(ctx, &sg, 1);
+}
+
+static hal_status_t shm_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    // Segment en écriture : data n'est que lu
+    hal_bus_seg_t sg = { dev_addr, reg, HAL_BUS_SEG_WRITE, (uint8_t *)(uintptr_t)data, len };
+    return shm_xfer(ctx, &sg, 1);
+}
+
+hal_status_t hal_bus_shm_client_init(hal_bus_shm_t *shm, hal_bus_t *bus)
+{
+    if (!shm || !shm->region || !bus) {
+        return HAL_ERR;
+    }
+
+    hal_bus_init(bus);
+    bus->ctx = shm;
+    bus->reg_read = shm_read;
+    bus->reg_write = shm_write;
+    bus->xfer = shm_xfer;
+
+    return HAL_OK;
+}
+
+/* ---------------- Serveur ---------------- */
+
+/*
+    Exécute une chaîne dans l'ordre, arrêt au premier échec.
+*/
+static void run_chain(hal_bus_shm_region_t *r, hal_bus_shm_slot_t *head, const hal_bus_t *model)
+{
+    hal_bus_shm_slot_t *slot = head;
+
+    for (unsigned k = 0; k < HAL_BUS_SHM_SLOTS; k++) {
+        // Relus une fois : un len hors borne déborderait sur l'emplacement suivant
+        uint8_t op = slot->op;
+        uint32_t len = slot->len;
+        hal_status_t st = HAL_ERR;
+
+        // Données lues / écrites sur place dans l'emplacement
+        if (len <= HAL_BUS_SHM_MAX_LEN && op == OP_WRITE) {
+            st = model->reg_write(model->ctx, slot->dev_addr, slot->reg, slot->data, len);
+        } else if (len <= HAL_BUS_SHM_MAX_LEN && op == OP_READ) {
+            st = model->reg_read(model->ctx, slot->dev_addr, slot->reg, slot->data, len);
+        }
+        slot->status = (int8_t)st;
+
+        if (st != HAL_OK || slot->next >= HAL_BUS_SHM_SLOTS) {
+            break;
+        }
+        slot = &r->slots[slot->next];
+    }
+}
+
+/*
+    Client parti sur timeout : libère la chaîne (next relu avant de libérer).
+*/
+static void free_chain(hal_bus_shm_region_t *r, hal_bus_shm_slot_t *head)
+{
+    hal_bus_shm_slot_t *slot = head;
+
+    for (unsigned k = 0; k < HAL_BUS_SHM_SLOTS && slot; k++) {
+        uint8_t next = slot->next;
+        atomic_store_explicit(&slot->state, SLOT_FREE, memory_order_release);
+        slot = (next < HAL_BUS_SHM_SLOTS) ? &r->slots[next] : NULL;
+    }
+}
+
+/*
+    Termine une chaîne prise (TAKEN) : DONE pour le client, ou libération
+    s'il est reparti entre-temps (ORPHAN).
+*/
+static void finish_chain(hal_bus_shm_region_t *r, hal_bus_shm_slot_t *head)
+{
+    uint32_t old = atomic_exchange_explicit(&head->state, SLOT_DONE, memory_order_acq_rel);
+    if ((old & SLOT_MASK) == SLOT_ORPHAN) {
+        free_chain(r, head);
+    } else if (old & SLOT_WAITER) {
+        wake_all(&head->state);
+    }
+}
+
+/*
+    Démarrage du serveur : une tête TAKEN ou ORPHAN a été prise par un
+    serveur précédent, mort en pleine chaîne. Sans reprise, ces
+    emplacements seraient perdus pour toujours.
+    - TAKEN  : le client attend encore ; DONE, les segments non exécutés
+               gardent le HAL_ERR posé par le client
+    - ORPHAN : le client est reparti ; chaîne libérée
+*/
+static unsigned reclaim_stale(hal_bus_shm_region_t *r)
+{
+    unsigned reclaimed = 0;
+
+    for (unsigned i = 0; i < HAL_BUS_SHM_SLOTS; i++) {
+        hal_bus_shm_slot_t *slot = &r->slots[i];
+        uint32_t s = atomic_load_explicit(&slot->state, memory_order_acquire) & SLOT_MASK;
+
+        if (s == SLOT_TAKEN || s == SLOT_ORPHAN) {
+            finish_chain(r, slot);
+            reclaimed++;
+        }
+    }
+    return reclaimed;
+}
+
+/*
+    Un passage sur tous les emplacements. Renvoie le nombre de chaînes servies.
+*/
+static unsigned serve_pass(hal_bus_shm_region_t *r, const hal_bus_t *model)
+{
+    unsigned served = 0;
+
+    for (unsigned i = 0; i < HAL_BUS_SHM_SLOTS; i++) {
+        hal_bus_shm_slot_t *slot = &r->slots[i];
+        uint32_t s = atomic_load_explicit(&slot->state, memory_order_acquire);
+
+        if ((s & SLOT_MASK) != SLOT_POSTED) {
+            continue;
+        }
+        if (!atomic_compare_exchange_strong_explicit(&slot->state, &s, (s & SLOT_WAITER) | SLOT_TAKEN,
+                                                     memory_order_acquire, memory_order_relaxed)) {
+            continue;   // repris par son client (timeout)
+        }
+
+        run_chain(r, slot, model);
+        finish_chain(r, slot);
+        served++;
+    }
+    return served;
+}
+
+uint64_t hal_bus_shm_serve(hal_bus_shm_t *shm, const hal_bus_t *model)
+{
+    if (!shm || !shm->region || !model || !model->reg_read || !model->reg_write) {
+        return 0;
+    }
+
+    hal_bus_shm_region_t *r = shm->region;
+    uint64_t served = 0;
+    int idle = 0;
+
+    reclaim_stale(r);
+
+    while (!atomic_load(&r->stop)) {
+        unsigned n = serve_pass(r, model);
+        if (n) {
+            served += n;
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPIN_ITERS) {
+            continue;
+        }
+
+        // Annonce le sommeil, puis revérifie : un client qui a publié
+        // avant l'annonce est vu ici, un client qui publie après réveille
+        uint32_t seq = atomic_load(&r->req_seq);
+        atomic_store(&r->server_waiting, 1);
+        n = serve_pass(r, model);
+        if (!n && !atomic_load(&r->stop)) {
+            wait_on(&r->req_seq, seq, SERVER_IDLE_NS);
+        }
+        atomic_store(&r->server_waiting, 0);
+        served += n;
+        idle = 0;
+    }
+    return served;
+}
@@ -0,0 +1,320 @@
+/*
+    hal_bus_stats.c
+
+    Décorateur d'instrumentation pour hal_bus_t.
+
+    Chemin chaud (stats_read / stats_write) :
+    - trouve les compteurs du thread (hal_thread_slots, pas de verrou)
+    - horodate avant/après l'appel au bus enveloppé
+    - incrémente ses compteurs : un seul écrivain par compteur, donc
+      load + store relaxés (pas d'instruction atomique verrouillée)
+
+    L'instantané relit tous les compteurs en relaxé et les additionne.
+*/
+
+#include "hal/hal_bus_stats.h"
+#include <string.h>  // memset
+
+enum { C_READS, C_WRITES, C_BYTES_READ, C_BYTES_WRITTEN, C_ERRORS, C_TIMEOUTS };
+enum { R_READS, R_WRITES, R_BYTES };
+
+/*
+    Incrément par l'unique écrivain : pas besoin de fetch_add.
+*/
+static inline void bump(_Atomic uint64_t *c, uint64_t v)
+{
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + v,
+                          memory_order_relaxed);
+}
+
+/*
+    Bucket log2 d'une latence : 0 -> 0, [2^(k-1), 2^k) -> k.
+*/
+static inline unsigned hist_bucket(uint64_t ns)
+{
+    unsigned k = ns ? 64u - (unsigned)__builtin_clzll(ns) : 0u;
+    return k < HAL_BUS_STATS_HIST_BUCKETS ? k : HAL_BUS_STATS_HIST_BUCKETS - 1;
+}
+
+static void account(
+    hal_bus_stats_ctx_t *ctx,
+    uint8_t dev_addr,
+    uint8_t reg,
+    size_t len,
+    int is_write,
+    hal_status_t st,
+    uint64_t lat_ns)
+{
+    hal_bus_stats_shard_t *shard = hal_thread_slots_get(&ctx->shards);
+    if (!shard) {
+        atomic_fetch_add_explicit(&ctx->uncounted, 1, memory_order_relaxed);
+        return;
+    }
+
+    hal_bus_stats_dev_shard_t *d = &shard->dev[dev_addr];
+    hal_bus_stats_reg_shard_t *r = &shard->reg[reg];
+
+    bump(&d->c[is_write ? C_WRITES : C_READS], 1);
+    bump(&r->c[is_write ? R_WRITES : R_READS], 1);
+
+    if (st == HAL_OK) {
+        bump(&d->c[is_write ? C_BYTES_WRITTEN : C_BYTES_READ], len);
+        bump(&r->c[R_BYTES], len);
+    } else {
+        bump(&d->c[st == HAL_TIMEOUT ? C_TIMEOUTS : C_ERRORS], 1);
+    }
+
+    if (ctx->time) {
+        bump(&d->lat_total_ns, lat_ns);
+        bump(&d->hist[hist_bucket(lat_ns)], 1);
+        if (lat_ns > atomic_load_explicit(&d->lat_max_ns, memory_order_relaxed)) {
+            atomic_store_explicit(&d->lat_max_ns, lat_ns, memory_order_relaxed);
+        }
+    }
+}
+
+static inline uint64_t stamp(const hal_bus_stats_ctx_t *ctx)
+{
+    return hal_time_now_ns(ctx->time);
+}
+
+static hal_status_t stats_read(void *context, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    hal_bus_stats_ctx_t *ctx = context;
+
+    uint64_t t0 = stamp(ctx);
+    hal_status_t st = ctx->inner.reg_read(ctx->inner.ctx, dev_addr, reg, data, len);
+    uint64_t t1 = stamp(ctx);
+
+    account(ctx, dev_addr, reg, len, 0, st, t1 - t0);
+    return st;
+}
+
+static hal_status_t stats_write(void *context, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    hal_bus_stats_ctx_t *ctx = context;
+
+    uint64_t t0 = stamp(ctx);
+    hal_status_t st = ctx->inner.reg_write(ctx->inner.ctx, dev_addr, reg, data, len);
+    uint64_t t1 = stamp(ctx);
+
+    account(ctx, dev_addr, reg, len, 1, st, t1 - t0);
+    return st;
+}
+
+hal_status_t hal_bus_stats_init(
+    hal_bus_stats_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner,
+    const hal_time_t *time)
+{
+    if (!ctx || !bus || !inner || !inner->reg_read || !inner->reg_write) {
+        return HAL_ERR;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->inner = *inner;
+    ctx->time = (time && time->now_ns) ? time : NULL;
+    atomic_init(&ctx->uncounted, 0);
+    if (hal_thread_slots_init(&ctx->shards, sizeof(hal_bus_stats_shard_t), NULL) != 0) {
+        return HAL_ERR;
+    }
+
+    hal_bus_init(bus);
+    bus->ctx = ctx;
+    bus->reg_read = stats_read;
+    bus->reg_write = stats_write;
+    bus->xfer = NULL;   // repli générique : chaque segment compté comme une transaction
+
+    return HAL_OK;
+}
+
+void hal_bus_stats_deinit(hal_bus_stats_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    hal_thread_slots_deinit(&ctx->shards);
+}
+
+static void dev_add(hal_bus_stats_dev_t *dst, const hal_bus_stats_dev_t *src)
+{
+    dst->reads += src->reads;
+    dst->writes += src->writes;
+    dst->bytes_read += src->bytes_read;
+    dst->bytes_written += src->bytes_written;
+    dst->errors += src->errors;
+    dst->timeouts += src->timeouts;
+    dst->lat_total_ns += src->lat_total_ns;
+    if (src->lat_max_ns > dst->lat_max_ns) {
+        dst->lat_max_ns = src->lat_max_ns;
+    }
+    for (unsigned k = 0; k < HAL_BUS_STATS_HIST_BUCKETS; k++) {
+        dst->hist[k] += src->hist[k];
+    }
+}
+
+void hal_bus_stats_snapshot(hal_bus_stats_ctx_t *ctx, hal_bus_stats_snapshot_t *snap)
+{
+    if (!snap) {
+        return;
+    }
+    memset(snap, 0, sizeof(*snap));
+    if (!ctx) {
+        return;
+    }
+
+    size_t n = hal_thread_slots_count(&ctx->shards);
+    for (size_t i = 0; i < n; i++) {
+        const hal_bus_stats_shard_t *shard = hal_thread_slots_at(&ctx->shards, i);
+
+        for (unsigned a = 0; a < HAL_BUS_STATS_DEVICES; a++) {
+            const hal_bus_stats_dev_shard_t *s = &shard->dev[a];
+            hal_bus_stats_dev_t *d = &snap->dev[a];
+
+            // Capteur jamais adressé par ce thread : rien à relire
+            uint64_t reads = atomic_load_explicit(&s->c[C_READS], memory_order_relaxed);
+            uint64_t writes = atomic_load_explicit(&s->c[C_WRITES], memory_order_relaxed);
+            if (!reads && !writes) {
+                continue;
+            }
+
+            d->reads += reads;
+            d->writes += writes;
+            d->bytes_read += atomic_load_explicit(&s->c[C_BYTES_READ], memory_order_relaxed);
+            d->bytes_written += atomic_load_explicit(&s->c[C_BYTES_WRITTEN], memory_order_relaxed);
+            d->errors += atomic_load_explicit(&s->c[C_ERRORS], memory_order_relaxed);
+            d->timeouts += atomic_load_explicit(&s->c[C_TIMEOUTS], memory_order_relaxed);
+            d->lat_total_ns += atomic_load_explicit(&s->lat_total_ns, memory_order_relaxed);
+
+            uint64_t max = atomic_load_explicit(&s->lat_max_ns, memory_order_relaxed);
+            if (max > d->lat_max_ns) {
+                d->lat_max_ns = max;
+            }
+            for (unsigned k = 0; k < HAL_BUS_STATS_HIST_BUCKETS; k++) {
+                d->hist[k] += atomic_load_explicit(&s->hist[k], memory_order_relaxed);
+            }
+        }
+
+        for (unsigned r = 0; r < HAL_BUS_STATS_REGS; r++) {
+            const hal_bus_stats_reg_shard_t *s = &shard->reg[r];
+            snap->reg[r].reads += atomic_load_explicit(&s->c[R_READS], memory_order_relaxed);
+            snap->reg[r].writes += atomic_load_explicit(&s->c[R_WRITES], memory_order_relaxed);
+            snap->reg[r].bytes += atomic_load_explicit(&s->c[R_BYTES], memory_order_relaxed);
+        }
+    }
+
+    for (unsigned a = 0; a < HAL_BUS_STATS_DEVICES; a++) {
+        dev_add(&snap->total, &snap->dev[a]);
+    }
+    snap->uncounted = atomic_load_explicit(&ctx->uncounted, memory_order_relaxed);
+}
+
+uint64_t hal_bus_stats_percentile_ns(const hal_bus_stats_dev_t *dev, unsigned pct)
+{
+    if (!dev) {
+        return 0;
+    }
+
+    uint64_t total = 0;
+    for (unsigned k = 0; k < HAL_BUS_STATS_HIST_BUCKETS; k++) {
+        total += dev->hist[k];
+    }
+    if (!total) {
+        return 0;
+    }
+    if (pct > 100) {
+        pct = 100;
+    }
+
+    // Rang visé (arrondi supérieur, au moins 1)
+    uint64_t rank = (total * pct + 99) / 100;
+    if (!rank) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned k = 0; k < HAL_BUS_STATS_HIST_BUCKETS; k++) {
+        seen += dev->hist[k];
+        if (seen >= rank) {
+            // Bucket ouvert : la borne connue est le max observé
+            if (k == 0) {
+                return 0;
+            }
+            if (k == HAL_BUS_STATS_HIST_BUCKETS - 1) {
+                return dev->lat_max_ns;
+            }
+            uint64_t upper = (1ull << k) - 1;
+            return upper < dev->lat_max_ns ? upper : dev->lat_max_ns;
+        }
+    }
+    return dev->lat_max_ns;
+}
+
+/*
+    Sélection des n meilleurs par insertion (n petit, 256 candidats).
+*/
+static size_t top_n(const uint64_t *score, const uint64_t *weight, unsigned count, uint8_t *out, size_t n)
+{
+    uint64_t best[HAL_BUS_STATS_DEVICES];
+    size_t used = 0;
+
+    if (n > HAL_BUS_STATS_DEVICES) {
+        n = HAL_BUS_STATS_DEVICES;
+    }
+
+    for (unsigned i = 0; i < count; i++) {
+        if (!weight[i]) {
+            continue;
+        }
+        size_t pos = used;
+        while (pos > 0 && best[pos - 1] < score[i]) {
+            pos--;
+        }
+        if (pos >= n) {
+            continue;
+        }
+        size_t end = used < n ? used : n - 1;
+        for (size_t j = end; j > pos; j--) {
+            best[j] = best[j - 1];
+            out[j] = out[j - 1];
+        }
+        best[pos] = score[i];
+        out[pos] = (uint8_t)i;
+        if (used < n) {
+            used++;
+        }
+    }
+    return used;
+}
+
+size_t hal_bus_stats_slowest_devices(const hal_bus_stats_snapshot_t *snap, uint8_t *out, size_t n)
+{
+    uint64_t mean[HAL_BUS_STATS_DEVICES];
+    uint64_t txn[HAL_BUS_STATS_DEVICES];
+
+    if (!snap || !out) {
+        return 0;
+    }
+
+    for (unsigned a = 0; a < HAL_BUS_STATS_DEVICES; a++) {
+        txn[a] = snap->dev[a].reads + snap->dev[a].writes;
+        mean[a] = txn[a] ? snap->dev[a].lat_total_ns / txn[a] : 0;
+    }
+    return top_n(mean, txn, HAL_BUS_STATS_DEVICES, out, n);
+}
+
+size_t hal_bus_stats_hottest_regs(const hal_bus_stats_snapshot_t *snap, uint8_t *out, size_t n)
+{
+    uint64_t txn[HAL_BUS_STATS_REGS];
+
+    if (!snap || !out) {
+        return 0;
+    }
+
+    for (unsigned r = 0; r < HAL_BUS_STATS_REGS; r++) {
+        txn[r] = snap->reg[r].reads + snap->reg[r].writes;
+    }
+    return top_n(txn, txn, HAL_BUS_STATS_REGS, out, n);
+}
@@ -0,0 +1,219 @@
+/*
+    hal_bus_timing.c
+
+    Modèle de temps de fil I2C / SPI (voir hal_bus_timing.h pour le
+    détail des périodes facturées).
+
+    Un transfert vectorisé compte comme une seule transaction : en I2C,
+    un restart (1 période) remplace STOP + tBUF + START entre segments.
+*/
+
+#include "hal/hal_bus_timing.h"
+#include <string.h>
+
+/* Périodes d'horloge bus d'une transaction */
+static uint64_t wire_periods(hal_bus_wire_t wire, int is_write, size_t len, hal_status_t status)
+{
+    if (wire == HAL_BUS_WIRE_SPI) {
+        return 8u + 8u * (uint64_t)len;
+    }
+
+    // I2C : capteur absent, la transaction s'arrête sur le NACK d'adresse
+    if (status == HAL_ERR) {
+        return 1u + 9u + 1u;
+    }
+    return (is_write ? 20u : 30u) + 9u * (uint64_t)len;
+}
+
+uint64_t hal_bus_timing_cost_ns(
+    const hal_bus_timing_cfg_t *cfg,
+    int is_write,
+    size_t len,
+    hal_status_t status)
+{
+    if (!cfg || cfg->clock_hz == 0) {
+        return 0;
+    }
+
+    // Arrondi supérieur : une période entamée est due
+    uint64_t periods = wire_periods(cfg->wire, is_write, len, status);
+    return (periods * 1000000000u + cfg->clock_hz - 1) / cfg->clock_hz + cfg->gap_ns;
+}
+
+uint64_t hal_bus_timing_xfer_cost_ns(
+    const hal_bus_timing_cfg_t *cfg,
+    const hal_bus_seg_t *segs,
+    size_t n)
+{
+    if (!cfg || cfg->clock_hz == 0 || !segs || n == 0) {
+        return 0;
+    }
+
+    uint64_t periods = 0;
+    uint64_t gaps = 0;
+
+    if (cfg->wire == HAL_BUS_WIRE_SPI) {
+        // Une trame CS par segment
+        for (size_t i = 0; i < n; i++) {
+            periods += 8u + 8u * (uint64_t)segs[i].len;
+        }
+        gaps = n;
+    } else {
+        // S, puis par segment adr/W + reg (+ Sr + adr/R) + données, Sr entre segments, P
+        periods = 1u + (n - 1u) + 1u;
+        for (size_t i = 0; i < n; i++) {
+            periods += 18u + (segs[i].dir == HAL_BUS_SEG_WRITE ? 0u : 10u) + 9u * (uint64_t)segs[i].len;
+        }
+        gaps = 1;
+    }
+
+    return (periods * 1000000000u + cfg->clock_hz - 1) / cfg->clock_hz + gaps * cfg->gap_ns;
+}
+
+/*
+    Place la transaction sur la ligne de temps du bus.
+*/
+static void charge_ns(hal_bus_timing_ctx_t *ctx, uint64_t cost, uint64_t transactions, uint64_t bytes)
+{
+    uint64_t now = ctx->clock->now_ns;
+    uint64_t start = now;
+
+    if (ctx->bus_free_ns > now) {
+        start = ctx->bus_free_ns;
+        ctx->wait_ns += start - now;
+    }
+
+    ctx->bus_free_ns = start + cost;
+    ctx->busy_ns += cost;
+    ctx->transactions += transactions;
+    ctx->bytes += bytes;
+
+    // Appelant bloquant : rend la main à la fin du transfert
+    if (ctx->advance_clock) {
+        ctx->clock->now_ns = ctx->bus_free_ns;
+    }
+}
+
+static void charge(hal_bus_timing_ctx_t *ctx, int is_write, size_t len, hal_status_t st)
+{
+    charge_ns(ctx, hal_bus_timing_cost_ns(&ctx->cfg, is_write, len, st), 1, st == HAL_OK ? len : 0);
+}
+
+static hal_status_t timing_read(void *context, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    hal_bus_timing_ctx_t *ctx = context;
+
+    hal_status_t st = ctx->inner.reg_read(ctx->inner.ctx, dev_addr, reg, data, len);
+    charge(ctx, 0, len, st);
+    return st;
+}
+
+static hal_status_t timing_write(void *context, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    hal_bus_timing_ctx_t *ctx = context;
+
+    hal_status_t st = ctx->inner.reg_write(ctx->inner.ctx, dev_addr, reg, data, len);
+    charge(ctx, 1, len, st);
+    return st;
+}
+
+/*
+    Transfert vectorisé : une seule transaction sur le fil (restarts).
+    En cas d'échec, toute la chaîne est facturée.
+*/
+static hal_status_t timing_xfer(void *context, const hal_bus_seg_t *segs, size_t n)
+{
+    hal_bus_timing_ctx_t *ctx = context;
+
+    hal_status_t st = hal_bus_vectored(&ctx->inner, segs, n);
+
+    uint64_t bytes = 0;
+    if (st == HAL_OK) {
+        for (size_t i = 0; i < n; i++) {
+            bytes += segs[i].len;
+        }
+    }
+    charge_ns(ctx, hal_bus_timing_xfer_cost_ns(&ctx->cfg, segs, n), n ? 1 : 0, bytes);
+    return st;
+}
+
+hal_status_t hal_bus_timing_init(
+    hal_bus_timing_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner,
+    const hal_bus_timing_cfg_t *cfg,
+    hal_time_sim_ctx_t *clock,
+    int advance_clock)
+{
+    if (!ctx || !bus || !inner || !inner->reg_read || !inner->reg_write ||
+        !cfg || cfg->clock_hz == 0 || !clock) {
+        return HAL_ERR;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->inner = *inner;
+    ctx->cfg = *cfg;
+    ctx->clock = clock;
+    ctx->advance_clock = advance_clock;
+    hal_bus_timing_reset(ctx);
+
+    hal_bus_init(bus);
+    bus->ctx = ctx;
+    bus->reg_read = timing_read;
+    bus->reg_write = timing_write;
+    bus->xfer = timing_xfer;
+
+    return HAL_OK;
+}
+
+/*
+    busy / elapsed en millionièmes. busy * 10^6 déborde au-delà de
+    ~5,1 h de fil : on divise alors elapsed (>= busy, donc >= 5,1 h)
+    par 10^6, erreur relative < 10^-7.
+*/
+static uint32_t utilization_ppm(uint64_t busy_ns, uint64_t elapsed_ns)
+{
+    if (elapsed_ns == 0) {
+        return 0;
+    }
+    if (busy_ns <= UINT64_MAX / 1000000u) {
+        return (uint32_t)(busy_ns * 1000000u / elapsed_ns);
+    }
+    return (uint32_t)(busy_ns / (elapsed_ns / 1000000u));
+}
+
+void hal_bus_timing_report(const hal_bus_timing_ctx_t *ctx, hal_bus_timing_report_t *out)
+{
+    if (!ctx || !out) {
+        return;
+    }
+
+    // Un transfert en cours compte jusqu'à sa fin
+    uint64_t end = ctx->clock->now_ns;
+    if (ctx->bus_free_ns > end) {
+        end = ctx->bus_free_ns;
+    }
+
+    out->elapsed_ns = end - ctx->t_start_ns;
+    out->busy_ns = ctx->busy_ns;
+    out->wait_ns = ctx->wait_ns;
+    out->transactions = ctx->transactions;
+    out->bytes = ctx->bytes;
+    out->utilization_ppm = utilization_ppm(ctx->busy_ns, out->elapsed_ns);
+}
+
+void hal_bus_timing_reset(hal_bus_timing_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    uint64_t now = ctx->clock->now_ns;
+
+    // Le transfert en cours appartient à l'ancienne fenêtre
+    ctx->t_start_ns = (ctx->bus_free_ns > now) ? ctx->bus_free_ns : now;
+    ctx->busy_ns = 0;
+    ctx->wait_ns = 0;
+    ctx->transactions = 0;
+    ctx->bytes = 0;
+}
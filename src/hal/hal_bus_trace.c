@@ -0,0 +1,491 @@
+/*
+    hal_bus_trace.c
+
+    Enregistrement / rejeu des transactions d'un hal_bus_t (POSIX).
+
+    Enregistreur : chaque transaction est transmise au bus enveloppé puis
+    copiée à la fin du mapping ; hdr->used n'avance qu'une fois
+    l'enregistrement complet, donc une trace interrompue reste lisible
+    jusqu'au dernier enregistrement entier.
+
+    Rejoueur : parcourt les enregistrements dans l'ordre ; une transaction
+    demandée par le driver est cherchée dans les HAL_BUS_TRACE_RESYNC_WINDOW
+    suivantes pour tolérer un driver qui saute ou ajoute des accès.
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "hal/hal_bus_trace.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ---------------- Format ---------------- */
+
+static void put_record_header(
+    uint8_t *p,
+    uint32_t dt_ns,
+    uint16_t len,
+    uint8_t dev,
+    uint8_t reg,
+    uint8_t op,
+    hal_status_t status)
+{
+    int8_t st = (int8_t)status;
+
+    memcpy(p, &dt_ns, 4);
+    memcpy(p + 4, &len, 2);
+    p[6] = dev;
+    p[7] = reg;
+    p[8] = op;
+    memcpy(p + 9, &st, 1);
+}
+
+/*
+    Décode l'enregistrement à pos (date cumulée dans *t_ns).
+    Renvoie la position suivante, 0 si l'enregistrement est tronqué.
+*/
+static size_t decode_at(
+    const uint8_t *base,
+    size_t used,
+    size_t pos,
+    uint64_t *t_ns,
+    hal_bus_trace_record_t *rec)
+{
+    if (used - pos < HAL_BUS_TRACE_RECORD_HEADER) {
+        return 0;
+    }
+
+    const uint8_t *p = base + pos;
+    uint32_t dt_ns;
+    int8_t st;
+
+    memcpy(&dt_ns, p, 4);
+    memcpy(&rec->len, p + 4, 2);
+    rec->dev_addr = p[6];
+    rec->reg = p[7];
+    rec->op = p[8];
+    memcpy(&st, p + 9, 1);
+    rec->status = (hal_status_t)st;
+
+    if (used - pos - HAL_BUS_TRACE_RECORD_HEADER < rec->len) {
+        return 0;
+    }
+    rec->data = p + HAL_BUS_TRACE_RECORD_HEADER;
+
+    if (rec->op == HAL_BUS_TRACE_OP_TIME && rec->len == sizeof(uint64_t)) {
+        memcpy(t_ns, rec->data, sizeof(uint64_t));
+    } else {
+        *t_ns += dt_ns;
+    }
+    rec->t_ns = *t_ns;
+
+    return pos + HAL_BUS_TRACE_RECORD_HEADER + rec->len;
+}
+
+/* ---------------- Enregistrement ---------------- */
+
+/*
+    Agrandit le fichier (doublement) pour accueillir need octets de plus.
+*/
+static int rec_reserve(hal_bus_trace_rec_ctx_t *ctx, size_t need)
+{
+    size_t end = sizeof(hal_bus_trace_header_t) + (size_t)ctx->hdr->used + need;
+    if (end <= ctx->map_size) {
+        return 0;
+    }
+
+    size_t size = ctx->map_size;
+    while (size < end) {
+        size *= 2;
+    }
+
+    if (ftruncate(ctx->fd, (off_t)size) != 0) {
+        return -1;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, ctx->fd, 0);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    munmap(ctx->map, ctx->map_size);
+    ctx->map = (uint8_t *)map;
+    ctx->map_size = size;
+    ctx->hdr = (hal_bus_trace_header_t *)map;
+    return 0;
+}
+
+static void rec_append(
+    hal_bus_trace_rec_ctx_t *ctx,
+    uint8_t op,
+    uint8_t dev_addr,
+    uint8_t reg,
+    hal_status_t status,
+    const uint8_t *data,
+    size_t len)
+{
+    if (len > HAL_BUS_TRACE_MAX_LEN) {
+        ctx->dropped++;
+        return;
+    }
+
+    uint64_t t = hal_time_now_ns(ctx->time);
+    if (ctx->hdr->used == 0) {
+        ctx->hdr->t0_ns = t;
+        ctx->last_ns = t;
+    }
+
+    uint64_t dt = (t > ctx->last_ns) ? t - ctx->last_ns : 0;
+    int resync = dt > UINT32_MAX;
+    size_t need = HAL_BUS_TRACE_RECORD_HEADER + len;
+    if (resync) {
+        need += HAL_BUS_TRACE_RECORD_HEADER + sizeof(uint64_t);
+    }
+
+    if (rec_reserve(ctx, need) != 0) {
+        ctx->dropped++;
+        return;
+    }
+
+    uint8_t *p = ctx->map + sizeof(hal_bus_trace_header_t) + ctx->hdr->used;
+
+    // Écart trop grand : date absolue d'abord
+    if (resync) {
+        put_record_header(p, 0, sizeof(uint64_t), 0, 0, HAL_BUS_TRACE_OP_TIME, HAL_OK);
+        memcpy(p + HAL_BUS_TRACE_RECORD_HEADER, &t, sizeof(uint64_t));
+        p += HAL_BUS_TRACE_RECORD_HEADER + sizeof(uint64_t);
+        dt = 0;
+    }
+
+    put_record_header(p, (uint32_t)dt, (uint16_t)len, dev_addr, reg, op, status);
+    if (data) {
+        memcpy(p + HAL_BUS_TRACE_RECORD_HEADER, data, len);
+    } else {
+        memset(p + HAL_BUS_TRACE_RECORD_HEADER, 0, len);
+    }
+
+    ctx->last_ns = t;
+    ctx->hdr->used += need;
+    ctx->hdr->count++;
+}
+
+static hal_status_t rec_read(void *context, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    hal_bus_trace_rec_ctx_t *ctx = context;
+
+    hal_status_t st = ctx->inner.reg_read(ctx->inner.ctx, dev_addr, reg, data, len);
+
+    // Lecture en échec : contenu du buffer indéfini, on enregistre des zéros
+    rec_append(ctx, HAL_BUS_TRACE_OP_READ, dev_addr, reg, st, st == HAL_OK ? data : NULL, len);
+    return st;
+}
+
+static hal_status_t rec_write(void *context, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    hal_bus_trace_rec_ctx_t *ctx = context;
+
+    hal_status_t st = ctx->inner.reg_write(ctx->inner.ctx, dev_addr, reg, data, len);
+
+    rec_append(ctx, HAL_BUS_TRACE_OP_WRITE, dev_addr, reg, st, data, len);
+    return st;
+}
+
+hal_status_t hal_bus_trace_rec_init(
+    hal_bus_trace_rec_ctx_t *ctx,
+    hal_bus_t *bus,
+    const hal_bus_t *inner,
+    const hal_time_t *time,
+    const char *path)
+{
+    if (!ctx || !bus || !inner || !inner->reg_read || !inner->reg_write || !path) {
+        return HAL_ERR;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->fd = -1;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return HAL_ERR;
+    }
+
+    size_t size = HAL_BUS_TRACE_INITIAL_SIZE;
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        unlink(path);
+        return HAL_ERR;
+    }
+
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        unlink(path);
+        return HAL_ERR;
+    }
+
+    ctx->inner = *inner;
+    ctx->time = time;
+    ctx->fd = fd;
+    ctx->map = (uint8_t *)map;
+    ctx->map_size = size;
+    ctx->hdr = (hal_bus_trace_header_t *)map;
+
+    ctx->hdr->version = HAL_BUS_TRACE_VERSION;
+    ctx->hdr->header_size = sizeof(hal_bus_trace_header_t);
+    memcpy(ctx->hdr->magic, HAL_BUS_TRACE_MAGIC, sizeof(ctx->hdr->magic));
+
+    hal_bus_init(bus);
+    bus->ctx = ctx;
+    bus->reg_read = rec_read;
+    bus->reg_write = rec_write;
+    bus->xfer = NULL;   // repli générique : un enregistrement par segment
+
+    return HAL_OK;
+}
+
+hal_status_t hal_bus_trace_rec_close(hal_bus_trace_rec_ctx_t *ctx)
+{
+    if (!ctx || ctx->fd < 0) {
+        return HAL_ERR;
+    }
+
+    off_t size = (off_t)(sizeof(hal_bus_trace_header_t) + ctx->hdr->used);
+    hal_status_t st = HAL_OK;
+
+    if (msync(ctx->map, ctx->map_size, MS_SYNC) != 0) {
+        st = HAL_ERR;
+    }
+    munmap(ctx->map, ctx->map_size);
+
+    // Retire la réserve non utilisée
+    if (ftruncate(ctx->fd, size) != 0 || fsync(ctx->fd) != 0) {
+        st = HAL_ERR;
+    }
+    close(ctx->fd);
+
+    ctx->fd = -1;
+    ctx->map = NULL;
+    ctx->map_size = 0;
+    ctx->hdr = NULL;
+    return st;
+}
+
+/* ---------------- Rejeu ---------------- */
+
+/*
+    Cherche la transaction (op, dev, reg, len) dans la fenêtre de resynchro.
+*/
+static const hal_bus_trace_record_t *play_match(
+    hal_bus_trace_play_ctx_t *ctx,
+    uint8_t op,
+    uint8_t dev_addr,
+    uint8_t reg,
+    size_t len,
+    hal_bus_trace_record_t *rec)
+{
+    const uint8_t *base = ctx->map + ctx->hdr->header_size;
+    size_t used = (size_t)ctx->hdr->used;
+    size_t pos = ctx->pos;
+    uint64_t t = ctx->pos_ns;
+    unsigned seen = 0;
+
+    while (seen < HAL_BUS_TRACE_RESYNC_WINDOW) {
+        size_t next = decode_at(base, used, pos, &t, rec);
+        if (!next) {
+            return NULL;
+        }
+        pos = next;
+
+        if (rec->op == HAL_BUS_TRACE_OP_TIME) {
+            continue;
+        }
+        if (rec->op == op && rec->dev_addr == dev_addr && rec->reg == reg && rec->len == len) {
+            ctx->skipped += seen;
+            ctx->pos = pos;
+            ctx->pos_ns = t;
+            ctx->now_ns = t;
+            ctx->matched++;
+            return rec;
+        }
+        seen++;
+    }
+    return NULL;
+}
+
+static hal_status_t play_read(void *context, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    hal_bus_trace_play_ctx_t *ctx = context;
+    hal_bus_trace_record_t rec;
+
+    if (!play_match(ctx, HAL_BUS_TRACE_OP_READ, dev_addr, reg, len, &rec)) {
+        ctx->mismatches++;
+        return HAL_ERR;
+    }
+
+    if (rec.status == HAL_OK) {
+        memcpy(data, rec.data, len);
+    }
+    return rec.status;
+}
+
+static hal_status_t play_write(void *context, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    hal_bus_trace_play_ctx_t *ctx = context;
+    hal_bus_trace_record_t rec;
+    (void)data;  // valeurs écrites non comparées : un driver modifié peut configurer autrement
+
+    if (!play_match(ctx, HAL_BUS_TRACE_OP_WRITE, dev_addr, reg, len, &rec)) {
+        ctx->mismatches++;
+        return HAL_ERR;
+    }
+    return rec.status;
+}
+
+/* Rejeu à vitesse maximale : les délais ne coûtent rien */
+static void play_delay_ms(void *context, uint32_t ms)
+{
+    (void)context;
+    (void)ms;
+}
+
+static uint64_t play_now_ns(void *context)
+{
+    const hal_bus_trace_play_ctx_t *ctx = context;
+    return ctx->now_ns;
+}
+
+hal_status_t hal_bus_trace_play_init(
+    hal_bus_trace_play_ctx_t *ctx,
+    hal_bus_t *bus,
+    hal_time_t *time,
+    const char *path)
+{
+    if (!ctx || !bus || !path) {
+        return HAL_ERR;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->fd = -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return HAL_ERR;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(hal_bus_trace_header_t)) {
+        close(fd);
+        return HAL_ERR;
+    }
+
+    void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return HAL_ERR;
+    }
+
+    const hal_bus_trace_header_t *h = (const hal_bus_trace_header_t *)map;
+    if (memcmp(h->magic, HAL_BUS_TRACE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != HAL_BUS_TRACE_VERSION ||
+        h->header_size < sizeof(hal_bus_trace_header_t) ||
+        h->header_size > (uint64_t)st.st_size ||
+        h->used > (uint64_t)st.st_size - h->header_size) {
+        munmap(map, (size_t)st.st_size);
+        close(fd);
+        return HAL_ERR;
+    }
+
+    ctx->fd = fd;
+    ctx->map = (const uint8_t *)map;
+    ctx->map_size = (size_t)st.st_size;
+    ctx->hdr = h;
+    hal_bus_trace_play_rewind(ctx);
+
+    hal_bus_init(bus);
+    bus->ctx = ctx;
+    bus->reg_read = play_read;
+    bus->reg_write = play_write;
+    bus->xfer = NULL;
+
+    if (time) {
+        time->ctx = ctx;
+        time->delay_ms = play_delay_ms;
+        time->now_ns = play_now_ns;
+    }
+
+    return HAL_OK;
+}
+
+void hal_bus_trace_play_rewind(hal_bus_trace_play_ctx_t *ctx)
+{
+    if (!ctx || !ctx->hdr) {
+        return;
+    }
+
+    ctx->pos = 0;
+    ctx->pos_ns = ctx->hdr->t0_ns;
+    ctx->now_ns = ctx->hdr->t0_ns;
+    ctx->matched = 0;
+    ctx->skipped = 0;
+    ctx->mismatches = 0;
+}
+
+int hal_bus_trace_play_done(const hal_bus_trace_play_ctx_t *ctx)
+{
+    if (!ctx || !ctx->hdr) {
+        return 1;
+    }
+
+    // Il peut rester des OP_TIME : seules les transactions comptent
+    size_t pos = ctx->pos;
+    uint64_t t = ctx->pos_ns;
+    hal_bus_trace_record_t rec;
+
+    while ((pos = decode_at(ctx->map + ctx->hdr->header_size, (size_t)ctx->hdr->used, pos, &t, &rec)) != 0) {
+        if (rec.op != HAL_BUS_TRACE_OP_TIME) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void hal_bus_trace_play_close(hal_bus_trace_play_ctx_t *ctx)
+{
+    if (!ctx || ctx->fd < 0) {
+        return;
+    }
+
+    munmap((void *)ctx->map, ctx->map_size);
+    close(ctx->fd);
+
+    ctx->fd = -1;
+    ctx->map = NULL;
+    ctx->map_size = 0;
+    ctx->hdr = NULL;
+}
+
+int hal_bus_trace_next(
+    const hal_bus_trace_play_ctx_t *ctx,
+    size_t *pos,
+    uint64_t *t_ns,
+    hal_bus_trace_record_t *rec)
+{
+    if (!ctx || !ctx->hdr || !pos || !t_ns || !rec) {
+        return 0;
+    }
+
+    if (*pos == 0) {
+        *t_ns = ctx->hdr->t0_ns;
+    }
+
+    size_t next = decode_at(ctx->map + ctx->hdr->header_size, (size_t)ctx->hdr->used, *pos, t_ns, rec);
+    if (!next) {
+        return 0;
+    }
+    *pos = next;
+    return 1;
+}
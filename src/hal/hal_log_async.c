@@ -0,0 +1,585 @@
+/*
+    hal_log_async.c
+
+    Logger asynchrone binaire.
+
+    Côté appelant (async_log) :
+    - trouve la file du thread (hal_thread_slots : cache thread-local,
+      pas de verrou)
+    - parcourt le format pour savoir quels arguments lire (va_arg)
+    - copie pointeur de format + arguments bruts dans la file
+
+    Côté thread de fond (worker_main) :
+    - parcourt les files, décode chaque enregistrement (snprintf par
+      spécificateur) et écrit la ligne
+    - quand tout est vide : fflush, puis acquitte la dernière demande
+      de flush vue avant le parcours
+*/
+
+#include "hal/hal_log_async.h"
+#include <stdarg.h>  // va_list
+#include <string.h>  // memset, memcpy
+#include <stddef.h>  // ptrdiff_t
+#include <limits.h>  // INT_MAX
+#include <time.h>    // nanosleep
+
+/* Marque d'une chaîne %s NULL ou qui ne tenait pas dans str[] */
+#define STR_NULL       0xFFFFu
+#define STR_TRUNCATED  0xFFFEu
+
+/* Pause du thread de fond quand toutes les files sont vides */
+#define WORKER_IDLE_NS 1000000L
+
+/*
+    Modificateurs de longueur printf.
+*/
+typedef enum {
+    LEN_NONE, LEN_HH, LEN_H, LEN_L, LEN_LL, LEN_J, LEN_Z, LEN_T, LEN_BIG_L
+} len_mod_t;
+
+/*
+    Spécificateur printf découpé.
+
+    flags    : début et longueur des drapeaux dans le format
+    width    : -1 absent, -2 '*', sinon valeur
+    prec     : -1 absente, -2 '*', sinon valeur
+*/
+typedef struct {
+    const char *flags;
+    size_t n_flags;
+    int width;
+    int prec;
+    len_mod_t len;
+    char conv;
+} fmt_spec_t;
+
+/*
+    Lit un nombre décimal ou '*'.
+*/
+static const char *parse_num(const char *p, int *out)
+{
+    if (*p == '*') {
+        *out = -2;
+        return p + 1;
+    }
+
+    int v = -1;
+    while (*p >= '0' && *p <= '9') {
+        v = (v < 0 ? 0 : v * 10) + (*p - '0');
+        p++;
+    }
+    *out = v;
+    return p;
+}
+
+/*
+    Découpe le spécificateur qui suit '%'.
+    Renvoie le pointeur juste après la conversion.
+*/
+static const char *parse_spec(const char *p, fmt_spec_t *spec)
+{
+    spec->flags = p;
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+    spec->n_flags = (size_t)(p - spec->flags);
+
+    p = parse_num(p, &spec->width);
+
+    spec->prec = -1;
+    if (*p == '.') {
+        p = parse_num(p + 1, &spec->prec);
+        if (spec->prec == -1) {
+            spec->prec = 0; // "%.f" : précision 0
+        }
+    }
+
+    spec->len = LEN_NONE;
+    switch (*p) {
+        case 'h': p++; spec->len = LEN_H; if (*p == 'h') { p++; spec->len = LEN_HH; } break;
+        case 'l': p++; spec->len = LEN_L; if (*p == 'l') { p++; spec->len = LEN_LL; } break;
+        case 'j': p++; spec->len = LEN_J; break;
+        case 'z': p++; spec->len = LEN_Z; break;
+        case 't': p++; spec->len = LEN_T; break;
+        case 'L': p++; spec->len = LEN_BIG_L; break;
+        default: break;
+    }
+
+    spec->conv = *p;
+    return (*p != '\0') ? p + 1 : p;
+}
+
+static int64_t read_signed(len_mod_t len, va_list *ap)
+{
+    switch (len) {
+        case LEN_HH: return (signed char)va_arg(*ap, int);
+        case LEN_H:  return (short)va_arg(*ap, int);
+        case LEN_L:  return va_arg(*ap, long);
+        case LEN_LL: return va_arg(*ap, long long);
+        case LEN_J:  return va_arg(*ap, intmax_t);
+        case LEN_Z:  return (int64_t)va_arg(*ap, size_t);
+        case LEN_T:  return va_arg(*ap, ptrdiff_t);
+        default:     return va_arg(*ap, int);
+    }
+}
+
+static uint64_t read_unsigned(len_mod_t len, va_list *ap)
+{
+    switch (len) {
+        case LEN_HH: return (unsigned char)va_arg(*ap, unsigned int);
+        case LEN_H:  return (unsigned short)va_arg(*ap, unsigned int);
+        case LEN_L:  return va_arg(*ap, unsigned long);
+        case LEN_LL: return va_arg(*ap, unsigned long long);
+        case LEN_J:  return va_arg(*ap, uintmax_t);
+        case LEN_Z:  return va_arg(*ap, size_t);
+        case LEN_T:  return (uint64_t)va_arg(*ap, ptrdiff_t);
+        default:     return va_arg(*ap, unsigned int);
+    }
+}
+
+/*
+    Ajoute un argument (ignoré si l'enregistrement est plein).
+*/
+static int rec_push(hal_log_record_t *rec, hal_log_arg_t arg)
+{
+    if (rec->nargs >= HAL_LOG_ASYNC_MAX_ARGS) {
+        return 0;
+    }
+    rec->args[rec->nargs++] = arg;
+    return 1;
+}
+
+/*
+    Copie une chaîne %s dans str[] et renvoie son offset (ou une marque).
+*/
+static uint64_t rec_copy_str(hal_log_record_t *rec, const char *s)
+{
+    if (!s) {
+        return STR_NULL;
+    }
+
+    size_t room = HAL_LOG_ASYNC_STR_BYTES - rec->str_used;
+    if (room == 0) {
+        return STR_TRUNCATED;
+    }
+
+    size_t off = rec->str_used;
+    size_t n = 0;
+    while (n + 1 < room && s[n] != '\0') {
+        rec->str[off + n] = s[n];
+        n++;
+    }
+    rec->str[off + n] = '\0';
+    rec->str_used = (uint8_t)(off + n + 1);
+
+    return off;
+}
+
+/*
+    Capture des arguments bruts, guidée par le format.
+*/
+static void capture_args(hal_log_record_t *rec, const char *fmt, va_list *ap)
+{
+    const char *p = fmt;
+
+    while (*p) {
+        if (*p++ != '%') {
+            continue;
+        }
+        if (*p == '%') {
+            p++;
+            continue;
+        }
+
+        fmt_spec_t spec;
+        p = parse_spec(p, &spec);
+
+        hal_log_arg_t a;
+        if (spec.width == -2) {
+            a.i = va_arg(*ap, int);
+            rec_push(rec, a);
+        }
+        if (spec.prec == -2) {
+            a.i = va_arg(*ap, int);
+            rec_push(rec, a);
+        }
+
+        switch (spec.conv) {
+            case 'd': case 'i':
+                a.i = read_signed(spec.len, ap);
+                break;
+            case 'u': case 'o': case 'x': case 'X':
+                a.u = read_unsigned(spec.len, ap);
+                break;
+            case 'c':
+                a.i = va_arg(*ap, int);
+                break;
+            case 'f': case 'F': case 'e': case 'E':
+            case 'g': case 'G': case 'a': case 'A':
+                a.d = (spec.len == LEN_BIG_L) ? (double)va_arg(*ap, long double)
+                                              : va_arg(*ap, double);
+                break;
+            case 's':
+                a.u = rec_copy_str(rec, va_arg(*ap, const char *));
+                break;
+            case 'p':
+                a.p = va_arg(*ap, void *);
+                break;
+            case 'n':
+                (void)va_arg(*ap, void *);
+                continue;
+            default:
+                return; // format invalide : on s'arrête là
+        }
+
+        if (!rec_push(rec, a)) {
+            return;
+        }
+    }
+}
+
+/*
+    Ajoute du texte au buffer de sortie (tronque proprement).
+*/
+static void out_append(char *buf, size_t size, size_t *pos, const char *s, size_t n)
+{
+    if (*pos + 1 >= size) {
+        return;
+    }
+    if (n > size - 1 - *pos) {
+        n = size - 1 - *pos;
+    }
+    memcpy(buf + *pos, s, n);
+    *pos += n;
+    buf[*pos] = '\0';
+}
+
+/*
+    Reconstruit "%<flags><width>.<prec><len><conv>" avec largeur/précision
+    résolues et longueur normalisée (ll pour les entiers).
+    left : ajoute '-' (largeur '*' négative).
+*/
+static void build_spec(char *out, size_t size, const fmt_spec_t *spec, int left, int width, int prec, const char *len)
+{
+    char flags[8];
+    size_t nf = spec->n_flags < sizeof(flags) - 2 ? spec->n_flags : sizeof(flags) - 2;
+    memcpy(flags, spec->flags, nf);
+    if (left) {
+        flags[nf++] = '-';
+    }
+    flags[nf] = '\0';
+
+    char w[16] = "";
+    char pr[16] = "";
+    if (width >= 0) {
+        snprintf(w, sizeof(w), "%d", width);
+    }
+    if (prec >= 0) {
+        snprintf(pr, sizeof(pr), ".%d", prec);
+    }
+
+    snprintf(out, size, "%%%s%s%s%s%c", flags, w, pr, len, spec->conv);
+}
+
+size_t hal_log_async_format(
+    const hal_log_record_t *rec,
+    char *buf,
+    size_t size
+)
+{
+    size_t pos = 0;
+    size_t next = 0;
+    const char *p = rec->fmt;
+
+    if (!buf || size == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+    if (!p) {
+        return 0;
+    }
+
+    while (*p) {
+        // Texte littéral jusqu'au prochain '%'
+        const char *lit = p;
+        while (*p && *p != '%') {
+            p++;
+        }
+        out_append(buf, size, &pos, lit, (size_t)(p - lit));
+        if (!*p) {
+            break;
+        }
+
+        p++;
+        if (*p == '%') {
+            out_append(buf, size, &pos, "%", 1);
+            p++;
+            continue;
+        }
+
+        fmt_spec_t spec;
+        p = parse_spec(p, &spec);
+        if (spec.conv == 'n') {
+            continue;
+        }
+
+        int width = spec.width;
+        int prec = spec.prec;
+        int left = 0;
+        if (width == -2) {
+            width = -1;
+            if (next < rec->nargs) {
+                // Largeur '*' négative = drapeau '-' + largeur positive (comme printf)
+                int64_t w = rec->args[next++].i;
+                left = (w < 0);
+                width = (int)(w < 0 ? (w < -INT_MAX ? INT_MAX : -w) : w);
+            }
+        }
+        if (prec == -2) {
+            prec = (next < rec->nargs) ? (int)rec->args[next++].i : -1;
+        }
+
+        if (next >= rec->nargs) {
+            out_append(buf, size, &pos, "?", 1);
+            continue;
+        }
+        hal_log_arg_t a = rec->args[next++];
+
+        char sp[48];
+        char tmp[128];
+        int n = 0;
+
+        switch (spec.conv) {
+            case 'd': case 'i':
+                build_spec(sp, sizeof(sp), &spec, left, width, prec, "ll");
+                n = snprintf(tmp, sizeof(tmp), sp, (long long)a.i);
+                break;
+            case 'u': case 'o': case 'x': case 'X':
+                build_spec(sp, sizeof(sp), &spec, left, width, prec, "ll");
+                n = snprintf(tmp, sizeof(tmp), sp, (unsigned long long)a.u);
+                break;
+            case 'c':
+                build_spec(sp, sizeof(sp), &spec, left, width, prec, "");
+                n = snprintf(tmp, sizeof(tmp), sp, (int)a.i);
+                break;
+            case 's': {
+                const char *str = "(null)";
+                if (a.u == STR_TRUNCATED) {
+                    str = "...";
+                } else if (a.u < HAL_LOG_ASYNC_STR_BYTES) {
+                    str = &rec->str[a.u];
+                }
+                build_spec(sp, sizeof(sp), &spec, left, width, prec, "");
+                n = snprintf(tmp, sizeof(tmp), sp, str);
+                break;
+            }
+            case 'p':
+                build_spec(sp, sizeof(sp), &spec, left, width, prec, "");
+                n = snprintf(tmp, sizeof(tmp), sp, a.p);
+                break;
+            default: // flottants
+                build_spec(sp, sizeof(sp), &spec, left, width, prec, "");
+                n = snprintf(tmp, sizeof(tmp), sp, a.d);
+                break;
+        }
+
+        if (n > 0) {
+            out_append(buf, size, &pos, tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+        }
+    }
+
+    return pos;
+}
+
+/*
+    Une file d'un thread terminé n'est reprise qu'une fois vidée :
+    ses derniers messages sont encore à écrire.
+*/
+static int ring_drained(const void *obj)
+{
+    hal_log_async_ring_t *ring = (hal_log_async_ring_t *)(uintptr_t)obj;
+    return atomic_load_explicit(&ring->tail, memory_order_acquire) ==
+           atomic_load_explicit(&ring->head, memory_order_relaxed);
+}
+
+/*
+    Fonction de log (chemin chaud).
+*/
+static void async_log(void *context, hal_log_level_t level, const char *fmt, ...)
+{
+    hal_log_async_ctx_t *ctx = (hal_log_async_ctx_t *)context;
+
+    if (!ctx || !fmt) {
+        return;
+    }
+
+    hal_log_async_ring_t *ring = hal_thread_slots_get(&ctx->rings);
+    if (!ring) {
+        atomic_fetch_add_explicit(&ctx->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= HAL_LOG_ASYNC_RING_SIZE) {
+        atomic_fetch_add_explicit(&ctx->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    hal_log_record_t *rec = &ring->buf[head & (HAL_LOG_ASYNC_RING_SIZE - 1)];
+    rec->fmt = fmt;
+    rec->level = (uint8_t)level;
+    rec->nargs = 0;
+    rec->str_used = 0;
+
+    va_list args;
+    va_start(args, fmt);
+    capture_args(rec, fmt, &args);
+    va_end(args);
+
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+static const char *level_to_str(hal_log_level_t level)
+{
+    switch (level) {
+        case HAL_LOG_INFO: return "INFO";
+        case HAL_LOG_WARN: return "WARN";
+        case HAL_LOG_ERR:  return "ERR";
+        default:           return "LOG";
+    }
+}
+
+/*
+    Vide toutes les files une fois. Renvoie le nombre de messages écrits.
+*/
+static size_t drain_once(hal_log_async_ctx_t *ctx)
+{
+    size_t written = 0;
+    size_t n = hal_thread_slots_count(&ctx->rings);
+    char line[256];
+
+    for (size_t i = 0; i < n; i++) {
+        hal_log_async_ring_t *ring = hal_thread_slots_at(&ctx->rings, i);
+        size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        for (; tail != head; tail++) {
+            const hal_log_record_t *rec = &ring->buf[tail & (HAL_LOG_ASYNC_RING_SIZE - 1)];
+            FILE *out = (rec->level == HAL_LOG_ERR) ? ctx->err : ctx->out;
+
+            hal_log_async_format(rec, line, sizeof(line));
+            fprintf(out, "[%s] %s\n", level_to_str((hal_log_level_t)rec->level), line);
+            written++;
+        }
+
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    return written;
+}
+
+static void idle_sleep(void)
+{
+    struct timespec ts = {0, WORKER_IDLE_NS};
+    nanosleep(&ts, NULL);
+}
+
+/*
+    Thread de fond : vide les files tant que le logger tourne,
+    puis une dernière fois à l'arrêt.
+*/
+static void *worker_main(void *arg)
+{
+    hal_log_async_ctx_t *ctx = (hal_log_async_ctx_t *)arg;
+
+    while (atomic_load(&ctx->running)) {
+        // Lue avant le parcours : tout message loggé avant la demande est vu
+        uint64_t req = atomic_load_explicit(&ctx->flush_req, memory_order_acquire);
+
+        if (drain_once(ctx) == 0) {
+            fflush(ctx->out);
+            fflush(ctx->err);
+            if (req != atomic_load_explicit(&ctx->flush_done, memory_order_relaxed)) {
+                atomic_store_explicit(&ctx->flush_done, req, memory_order_release);
+                continue;
+            }
+            idle_sleep();
+        }
+    }
+
+    drain_once(ctx);
+    fflush(ctx->out);
+    fflush(ctx->err);
+    atomic_store_explicit(&ctx->flush_done, atomic_load(&ctx->flush_req), memory_order_release);
+
+    return NULL;
+}
+
+int hal_log_async_init(
+    hal_log_async_ctx_t *ctx,
+    hal_log_t *log,
+    FILE *out,
+    FILE *err
+)
+{
+    if (!ctx || !log) {
+        return -1;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->out = out ? out : stdout;
+    ctx->err = err ? err : stderr;
+    atomic_init(&ctx->dropped, 0);
+    atomic_init(&ctx->flush_req, 0);
+    atomic_init(&ctx->flush_done, 0);
+    atomic_init(&ctx->running, 1);
+
+    if (hal_thread_slots_init(&ctx->rings, sizeof(hal_log_async_ring_t), ring_drained) != 0) {
+        atomic_store(&ctx->running, 0);
+        return -1;
+    }
+
+    if (pthread_create(&ctx->worker, NULL, worker_main, ctx) != 0) {
+        atomic_store(&ctx->running, 0);
+        hal_thread_slots_deinit(&ctx->rings);
+        return -1;
+    }
+
+    log->ctx = ctx;
+    log->log = async_log;
+
+    return 0;
+}
+
+void hal_log_async_flush(hal_log_async_ctx_t *ctx)
+{
+    if (!ctx) {
+        return;
+    }
+
+    // Le thread de fond acquitte une fois les files vides et les flux vidés
+    uint64_t ticket = atomic_fetch_add(&ctx->flush_req, 1) + 1;
+
+    while (atomic_load_explicit(&ctx->flush_done, memory_order_acquire) < ticket) {
+        if (!atomic_load(&ctx->running)) {
+            break;
+        }
+        idle_sleep();
+    }
+}
+
+void hal_log_async_deinit(hal_log_async_ctx_t *ctx)
+{
+    if (!ctx || !atomic_exchange(&ctx->running, 0)) {
+        return;
+    }
+
+    pthread_join(ctx->worker, NULL);
+    hal_thread_slots_deinit(&ctx->rings);
+}
+
+uint64_t hal_log_async_dropped(hal_log_async_ctx_t *ctx)
+{
+    return ctx ? atomic_load(&ctx->dropped) : 0;
+}
@@ -33,8 +33,10 @@ static const char *level_to_str(hal_log_level_t level)
     - ctx : non utilisé ici
     - level : niveau du message
     - fmt, ... : message formaté (comme printf)
+
+    Publique pour la liaison statique (hal_bind_host.h).
 */
-static void host_log(void *ctx, hal_log_level_t level, const char *fmt, ...)
+void hal_log_stdio_log(void *ctx, hal_log_level_t level, const char *fmt, ...)
 {
     (void)ctx; // pas utilisé sur host
 
@@ -63,7 +65,7 @@ static void host_log(void *ctx, hal_log_level_t level, const char *fmt, ...)
 
     Remplit :
     - ctx (NULL)
-    - log (pointeur vers host_log)
+    - log (pointeur vers hal_log_stdio_log)
 */
 void hal_log_stdio_init(hal_log_t *log)
 {
@@ -72,5 +74,5 @@ void hal_log_stdio_init(hal_log_t *log)
     }
 
     log->ctx = NULL;
-    log->log = host_log;
+    log->log = hal_log_stdio_log;
 }
@@ -0,0 +1,153 @@
+/*
+    hal_thread_slot.c
+
+    Table d'objets par thread avec recyclage à la fin du thread.
+
+    Chemin rapide (hal_thread_slots_get) : cache thread-local d'une entrée.
+    Chemin lent :
+    - pthread_getspecific : le thread a déjà un objet dans cette table
+      (cache écrasé par une autre table)
+    - sinon, sous verrou : reprend le slot d'un thread terminé, ou
+      alloue un nouvel objet
+
+    La valeur de la clé est &state[i] : le destructeur (appelé à la fin
+    du thread) marque le slot "terminé" sans avoir besoin de la table.
+*/
+
+#include "hal/hal_thread_slot.h"
+#include <stdlib.h>  // aligned_alloc, free
+#include <string.h>  // memset
+
+#define SLOT_FREE   0u
+#define SLOT_USED   1u
+#define SLOT_EXITED 2u
+
+/*
+    La génération évite de réutiliser le cache si une nouvelle table
+    est créée à la même adresse (contexte sur la pile).
+*/
+static _Atomic uint32_t g_generation;
+
+static _Thread_local hal_thread_slots_t *t_slots;
+static _Thread_local uint32_t t_gen;
+static _Thread_local void *t_obj;
+
+static void slot_thread_exit(void *value)
+{
+    atomic_store_explicit((_Atomic uint32_t *)value, SLOT_EXITED, memory_order_release);
+
+    // Un log depuis un autre destructeur ne doit pas reprendre l'ancien objet
+    t_slots = NULL;
+    t_obj = NULL;
+}
+
+/*
+    Choisit un slot pour le thread courant (verrou tenu).
+    Renvoie HAL_THREAD_SLOTS_MAX si la table est pleine.
+*/
+static size_t slot_claim(hal_thread_slots_t *slots)
+{
+    size_t n = atomic_load_explicit(&slots->n, memory_order_relaxed);
+
+    for (size_t i = 0; i < n; i++) {
+        uint32_t st = atomic_load_explicit(&slots->state[i], memory_order_acquire);
+        if (st == SLOT_EXITED && (!slots->reusable || slots->reusable(slots->obj[i]))) {
+            atomic_store_explicit(&slots->state[i], SLOT_USED, memory_order_relaxed);
+            return i;
+        }
+    }
+
+    if (n >= HAL_THREAD_SLOTS_MAX) {
+        return HAL_THREAD_SLOTS_MAX;
+    }
+
+    // Taille multiple de l'alignement (exigé par aligned_alloc)
+    size_t size = (slots->obj_size + 63u) & ~(size_t)63u;
+    void *obj = aligned_alloc(64, size);
+    if (!obj) {
+        return HAL_THREAD_SLOTS_MAX;
+    }
+    memset(obj, 0, size);
+
+    slots->obj[n] = obj;
+    atomic_store_explicit(&slots->state[n], SLOT_USED, memory_order_relaxed);
+    atomic_store_explicit(&slots->n, n + 1, memory_order_release);
+    return n;
+}
+
+void *hal_thread_slots_get(hal_thread_slots_t *slots)
+{
+    if (t_slots == slots && t_gen == slots->generation) {
+        return t_obj;
+    }
+
+    size_t i;
+    void *value = pthread_getspecific(slots->key);
+
+    if (value) {
+        i = (size_t)((_Atomic uint32_t *)value - slots->state);
+    } else {
+        pthread_mutex_lock(&slots->lock);
+        i = slot_claim(slots);
+        pthread_mutex_unlock(&slots->lock);
+
+        if (i >= HAL_THREAD_SLOTS_MAX) {
+            return NULL;
+        }
+        if (pthread_setspecific(slots->key, &slots->state[i]) != 0) {
+            slot_thread_exit(&slots->state[i]);
+            return NULL;
+        }
+    }
+
+    t_slots = slots;
+    t_gen = slots->generation;
+    t_obj = slots->obj[i];
+    return t_obj;
+}
+
+int hal_thread_slots_init(
+    hal_thread_slots_t *slots,
+    size_t obj_size,
+    int (*reusable)(const void *obj)
+)
+{
+    if (!slots || obj_size == 0) {
+        return -1;
+    }
+
+    memset(slots, 0, sizeof(*slots));
+    for (size_t i = 0; i < HAL_THREAD_SLOTS_MAX; i++) {
+        atomic_init(&slots->state[i], SLOT_FREE);
+    }
+    atomic_init(&slots->n, 0);
+    slots->obj_size = obj_size;
+    slots->reusable = reusable;
+    slots->generation = atomic_fetch_add(&g_generation, 1) + 1;
+
+    if (pthread_key_create(&slots->key, slot_thread_exit) != 0) {
+        return -1;
+    }
+    pthread_mutex_init(&slots->lock, NULL);
+
+    return 0;
+}
+
+void hal_thread_slots_deinit(hal_thread_slots_t *slots)
+{
+    if (!slots) {
+        return;
+    }
+
+    // Plus de destructeur pour les threads encore vivants
+    pthread_key_delete(slots->key);
+
+    size_t n = atomic_load(&slots->n);
+    for (size_t i = 0; i < n; i++) {
+        free(slots->obj[i]);
+        slots->obj[i] = NULL;
+        atomic_store(&slots->state[i], SLOT_FREE);
+    }
+    atomic_store(&slots->n, 0);
+    pthread_mutex_destroy(&slots->lock);
+}
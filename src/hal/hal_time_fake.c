@@ -1,13 +1,15 @@
 /*
     hal_time_fake.c
 
-    Implémentation macOS/PC de delay_ms.
+    Implémentation macOS/PC de delay_ms et now_ns.
 
-    On utilise usleep() qui attend un nombre de microsecondes.
+    On utilise usleep() qui attend un nombre de microsecondes,
+    et clock_gettime(CLOCK_MONOTONIC) pour l'horloge.
 */
 
 #include "hal/hal_time_fake.h"
 #include <unistd.h> // usleep
+#include <time.h>   // clock_gettime
 
 /*
     Fonction delay_ms pour host.
@@ -26,12 +28,26 @@ static void host_delay_ms(void *ctx, uint32_t ms)
     usleep((useconds_t)(ms * 1000u));
 }
 
+/*
+    Horloge monotone host, en nanosecondes.
+*/
+static uint64_t host_now_ns(void *ctx)
+{
+    (void)ctx;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
 /*
     Initialise la HAL time (host).
 
     Remplit :
     - ctx (ici NULL car pas besoin)
     - delay_ms (pointeur vers host_delay_ms)
+    - now_ns (pointeur vers host_now_ns)
 */
 void hal_time_fake_init(hal_time_t *time)
 {
@@ -41,4 +57,5 @@ void hal_time_fake_init(hal_time_t *time)
 
     time->ctx = NULL;
     time->delay_ms = host_delay_ms;
+    time->now_ns = host_now_ns;
 }
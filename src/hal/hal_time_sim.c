@@ -0,0 +1,53 @@
+/*
+    hal_time_sim.c
+
+    Temps simulé : delay_ms() avance une horloge virtuelle.
+*/
+
+#include "hal/hal_time_sim.h"
+
+/*
+    delay_ms simulé : aucune attente réelle.
+*/
+static void sim_delay_ms(void *ctx, uint32_t ms)
+{
+    if (!ctx) {
+        return;
+    }
+
+    ((hal_time_sim_ctx_t *)ctx)->now_ns += (uint64_t)ms * 1000000u;
+}
+
+/*
+    now_ns simulé : lecture de l'horloge virtuelle.
+*/
+static uint64_t sim_now_ns(void *ctx)
+{
+    if (!ctx) {
+        return 0;
+    }
+
+    return ((hal_time_sim_ctx_t *)ctx)->now_ns;
+}
+
+void hal_time_sim_init(hal_time_sim_ctx_t *ctx, hal_time_t *time, uint64_t start_ns)
+{
+    if (!ctx || !time) {
+        return;
+    }
+
+    ctx->now_ns = start_ns;
+
+    time->ctx = ctx;
+    time->delay_ms = sim_delay_ms;
+    time->now_ns = sim_now_ns;
+}
+
+void hal_time_sim_advance_ns(hal_time_sim_ctx_t *ctx, uint64_t ns)
+{
+    if (!ctx) {
+        return;
+    }
+
+    ctx->now_ns += ns;
+}
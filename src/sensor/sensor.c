@@ -10,24 +10,111 @@
 */
 
 #include "sensor/sensor.h"
+#include "sensor/sensor_regmap.h"
+#include "sensor/sensor_convert.h"
+#include "sensor/sensor_cal.h"
+#include "hal/hal_bind.h"
+#include <string.h> // memset
 
 /*
-    Définition des registres du capteur.
+    Registres : voir sensor/sensor_regmap.h (carte partagée avec le fake).
+*/
+#define REG_WHO_AM_I     SENSOR_REG_WHO_AM_I
+#define REG_TEMP         SENSOR_REG_TEMP
+#define REG_FIFO_CTRL    SENSOR_REG_FIFO_CTRL
+#define REG_FIFO_STATUS  SENSOR_REG_FIFO_STATUS
+#define REG_FIFO_DATA    SENSOR_REG_FIFO_DATA
+
+#define FIFO_STATUS_OVR  SENSOR_FIFO_STATUS_OVR
+#define FIFO_STATUS_LVL  SENSOR_FIFO_STATUS_LVL
 
-    Ces adresses sont fictives mais
-    ressemblent à de vrais capteurs.
+/*
+    Registres volatils de la fenêtre shadow : jamais mis en cache
+    (valeurs produites par le capteur ou effets de bord à la lecture).
+    Tous les autres registres de la fenêtre sont cacheables.
 */
-#define REG_WHO_AM_I  0x00
-#define REG_TEMP_MSB  0x10
-#define REG_TEMP_LSB  0x11
+static int reg_is_volatile(uint8_t reg)
+{
+    return sensor_regmap_is_volatile(reg);
+}
+
+static int reg_is_cacheable(uint8_t reg)
+{
+    return reg < SENSOR_SHADOW_SIZE && !reg_is_volatile(reg);
+}
 
 /*
-    ID attendu du capteur.
+    Registre inscriptible d'après la carte (SENSOR_REG_W) ;
+    WHO_AM_I, les registres d'état et les adresses hors carte ne le sont pas.
+*/
+static int reg_is_writable(uint8_t reg)
+{
+    return sensor_regmap_is_writable(reg);
+}
 
-    Permet de vérifier qu'on parle
-    au bon composant.
+/*
+    Vrai si tous les registres de [reg, reg + len) sont inscriptibles.
 */
-#define EXPECTED_ID 0x42
+static int range_writable(uint8_t reg, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (!reg_is_writable((uint8_t)(reg + i)))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+    Petits accès aux bitmaps valid/dirty.
+*/
+static int bit_get(const uint8_t *map, uint8_t reg)
+{
+    return (map[reg >> 3] >> (reg & 7)) & 1;
+}
+
+static void bit_set(uint8_t *map, uint8_t reg)
+{
+    map[reg >> 3] |= (uint8_t)(1u << (reg & 7));
+}
+
+static void bit_clear(uint8_t *map, uint8_t reg)
+{
+    map[reg >> 3] &= (uint8_t)~(1u << (reg & 7));
+}
+
+/*
+    Vrai si [reg, reg + len) est entièrement cacheable (sans repli 0xFF -> 0x00).
+*/
+static int range_cacheable(uint8_t reg, size_t len)
+{
+    if (len == 0 || (size_t)reg + len > SENSOR_SHADOW_SIZE)
+        return 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (!reg_is_cacheable((uint8_t)(reg + i)))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+    ID attendu du capteur : SENSOR_EXPECTED_ID (sensor.h).
+*/
+#define EXPECTED_ID SENSOR_EXPECTED_ID
+
+/*
+    Nombre d'erreurs bus loggées par fenêtre et par capteur avant
+    limitation (voir HAL_LOGE_RL dans hal_log.h).
+
+    Le limiteur est celui de l'instance (s->log_rl) : un capteur en
+    panne ne fait pas taire les autres.
+*/
+#define SENSOR_LOG_BURST 4
+
+#define SENSOR_LOGE_RL(s_, ...) \
+    HAL_LOGE_RL((s_)->log, &(s_)->log_rl, HAL_TIME_NOW_NS((s_)->clock), SENSOR_LOG_BURST, __VA_ARGS__)
+#define SENSOR_LOGW_RL(s_, ...) \
+    HAL_LOGW_RL((s_)->log, &(s_)->log_rl, HAL_TIME_NOW_NS((s_)->clock), SENSOR_LOG_BURST, __VA_ARGS__)
 
 /*
     Lecture de l'ID capteur.
@@ -38,20 +125,16 @@ sensor_status_t sensor_get_id(
 )
 {
     // Vérifications de sécurité
-    if (!s || !id_out || !s->bus || !s->bus->reg_read)
+    if (!s || !id_out || !HAL_BUS_CAN_READ(s->bus))
         return SENSOR_ERR;
 
     uint8_t id = 0;
 
-    // Lecture du registre WHO_AM_I
-    if (s->bus->reg_read(
-            s->bus->ctx,
-            s->dev_addr,
-            REG_WHO_AM_I,
-            &id,
-            1
-        ) != HAL_OK)
+    // Lecture du registre WHO_AM_I (statique : servi par le cache après la 1re fois)
+    if (sensor_reg_read(s, REG_WHO_AM_I, &id, 1) != SENSOR_OK)
     {
+        SENSOR_LOGE_RL(s,
+                       "sensor 0x%02X: WHO_AM_I read failed", s->dev_addr);
         return SENSOR_ERR;
     }
 
@@ -60,11 +143,9 @@ sensor_status_t sensor_get_id(
 }
 
 /*
-    Initialisation du capteur.
-
-    Vérifie l'ID et prépare la structure.
+    Prépare la structure (commun à sensor_init et sensor_init_start).
 */
-sensor_status_t sensor_init(
+sensor_status_t sensor_bind(
     sensor_t *s,
     uint8_t dev_addr,
     const hal_bus_t *bus,
@@ -73,7 +154,7 @@ sensor_status_t sensor_init(
 )
 {
     // Vérifications de sécurité
-    if (!s || !bus || !bus->reg_read || !bus->reg_write)
+    if (!s || !HAL_BUS_CAN_READ(bus) || !HAL_BUS_CAN_WRITE(bus))
         return SENSOR_ERR;
 
     // Stocker les dépendances HAL
@@ -81,6 +162,31 @@ sensor_status_t sensor_init(
     s->bus = bus;
     s->time = time;
     s->log = log;
+    s->clock = NULL;
+    s->xfer = NULL;
+    s->fifo_overruns = 0;
+    s->cal = NULL;
+    atomic_init(&s->log_rl.state, 0);
+    sensor_cache_invalidate(s);
+
+    return SENSOR_OK;
+}
+
+/*
+    Initialisation du capteur.
+
+    Vérifie l'ID et prépare la structure.
+*/
+sensor_status_t sensor_init(
+    sensor_t *s,
+    uint8_t dev_addr,
+    const hal_bus_t *bus,
+    const hal_time_t *time,
+    const hal_log_t *log
+)
+{
+    if (sensor_bind(s, dev_addr, bus, time, log) != SENSOR_OK)
+        return SENSOR_ERR;
 
     // Lire ID capteur
     uint8_t id = 0;
@@ -88,12 +194,16 @@ sensor_status_t sensor_init(
         return SENSOR_ERR;
 
     // Vérifier ID
-    if (id != EXPECTED_ID)
+    if (id != EXPECTED_ID) {
+        HAL_LOGE(s->log, "sensor 0x%02X: bad id 0x%02X (expected 0x%02X)",
+                 s->dev_addr, id, EXPECTED_ID);
         return SENSOR_BAD_ID;
+    }
 
     // Petit délai après init (comme en vrai)
-    if (s->time && s->time->delay_ms)
-        s->time->delay_ms(s->time->ctx, 10);
+    HAL_TIME_DELAY_MS(s->time, SENSOR_INIT_DELAY_MS);
+
+    HAL_LOGI(s->log, "sensor 0x%02X: init ok", s->dev_addr);
 
     return SENSOR_OK;
 }
@@ -110,20 +220,22 @@ sensor_status_t sensor_read_temperature_centi(
     int16_t *temp_centi_out
 )
 {
-    if (!s || !temp_centi_out || !s->bus || !s->bus->reg_read)
+    if (!s || !temp_centi_out || !HAL_BUS_CAN_READ(s->bus))
         return SENSOR_ERR;
 
     uint8_t buf[2] = {0};
 
-    // Lire MSB + LSB
-    if (s->bus->reg_read(
-            s->bus->ctx,
+    // Lire TEMP (MSB + LSB)
+    if (HAL_BUS_READ(
+            s->bus,
             s->dev_addr,
-            REG_TEMP_MSB,
+            REG_TEMP,
             buf,
             2
         ) != HAL_OK)
     {
+        SENSOR_LOGE_RL(s,
+                       "sensor 0x%02X: temperature read failed", s->dev_addr);
         return SENSOR_ERR;
     }
 
@@ -132,7 +244,480 @@ sensor_status_t sensor_read_temperature_centi(
         ((int16_t)buf[0] << 8) |
         buf[1];
 
-    *temp_centi_out = raw;
+    // Correction propre au capteur (identité sans calibration)
+    *temp_centi_out = sensor_cal_apply(s->cal, raw);
+
+    return SENSOR_OK;
+}
+
+/*
+    Horloge optionnelle (voir sensor.h).
+*/
+sensor_status_t sensor_set_clock(sensor_t *s, const hal_time_t *clock)
+{
+    if (!s)
+        return SENSOR_ERR;
+
+    s->clock = clock;
+    return SENSOR_OK;
+}
+
+/*
+    Transfert vectorisé optionnel (voir sensor.h).
+*/
+sensor_status_t sensor_set_bus_xfer(
+    sensor_t *s,
+    hal_status_t (*xfer)(void *ctx, const hal_bus_seg_t *segs, size_t n)
+)
+{
+    if (!s)
+        return SENSOR_ERR;
+
+    s->xfer = xfer;
+    return SENSOR_OK;
+}
+
+/*
+    Horodatage via l'horloge du capteur.
+*/
+uint64_t sensor_timestamp_us(const sensor_t *s)
+{
+    if (!s)
+        return 0;
+
+    return HAL_TIME_NOW_NS(s->clock) / 1000u;
+}
+
+/*
+    Réglage du watermark FIFO.
+*/
+sensor_status_t sensor_fifo_set_watermark(
+    sensor_t *s,
+    uint8_t watermark
+)
+{
+    if (!s || !HAL_BUS_CAN_WRITE(s->bus))
+        return SENSOR_ERR;
+
+    if (watermark > SENSOR_FIFO_DEPTH)
+        return SENSOR_ERR;
+
+    if (HAL_BUS_WRITE(
+            s->bus,
+            s->dev_addr,
+            REG_FIFO_CTRL,
+            &watermark,
+            1
+        ) != HAL_OK)
+    {
+        HAL_LOGE(s->log, "sensor 0x%02X: FIFO_CTRL write failed", s->dev_addr);
+        return SENSOR_ERR;
+    }
+
+    // Écrit directement : le cache reflète maintenant le capteur
+    s->shadow[REG_FIFO_CTRL] = watermark;
+    bit_set(s->shadow_valid, REG_FIFO_CTRL);
+    bit_clear(s->shadow_dirty, REG_FIFO_CTRL);
+
+    return SENSOR_OK;
+}
+
+/*
+    Lecture en rafale des échantillons FIFO.
+
+    Deux transactions au total, quel que soit le nombre d'échantillons :
+    - FIFO_STATUS (1 octet) pour le niveau et l'overrun
+    - FIFO_DATA (2 * n octets) pour les échantillons
+*/
+sensor_status_t sensor_read_samples(
+    sensor_t *s,
+    int16_t *samples_out,
+    size_t max_samples,
+    size_t *n_read_out
+)
+{
+    if (!s || !samples_out || !n_read_out || !HAL_BUS_CAN_READ(s->bus))
+        return SENSOR_ERR;
+
+    *n_read_out = 0;
+
+    uint8_t status = 0;
+
+    // Niveau FIFO + overrun
+    if (HAL_BUS_READ(
+            s->bus,
+            s->dev_addr,
+            REG_FIFO_STATUS,
+            &status,
+            1
+        ) != HAL_OK)
+    {
+        SENSOR_LOGE_RL(s,
+                       "sensor 0x%02X: FIFO_STATUS read failed", s->dev_addr);
+        return SENSOR_ERR;
+    }
+
+    if (status & FIFO_STATUS_OVR) {
+        s->fifo_overruns++;
+        SENSOR_LOGW_RL(s,
+                       "sensor 0x%02X: FIFO overrun (%lu total)",
+                       s->dev_addr, (unsigned long)s->fifo_overruns);
+    }
+
+    size_t n = status & FIFO_STATUS_LVL;
+    if (n > max_samples)
+        n = max_samples;
+    if (n > SENSOR_FIFO_DEPTH)
+        n = SENSOR_FIFO_DEPTH;
+    if (n == 0)
+        return SENSOR_OK;
+
+    uint8_t buf[2 * SENSOR_FIFO_DEPTH];
+
+    // Une seule rafale pour tous les échantillons
+    if (HAL_BUS_READ(
+            s->bus,
+            s->dev_addr,
+            REG_FIFO_DATA,
+            buf,
+            2 * n
+        ) != HAL_OK)
+    {
+        SENSOR_LOGE_RL(s,
+                       "sensor 0x%02X: FIFO_DATA burst read failed", s->dev_addr);
+        return SENSOR_ERR;
+    }
+
+    // Reconstruction des valeurs 16 bits (big-endian), par lot
+    sensor_convert_be16_to_centi(buf, samples_out, n);
+
+    if (s->cal)
+        sensor_cal_apply_batch(s->cal, samples_out, samples_out, n);
+
+    *n_read_out = n;
+    return SENSOR_OK;
+}
+
+/*
+    Plage entièrement en cache : copie sans accès bus. Renvoie 1 si servie.
+*/
+static int cache_lookup(const sensor_t *s, uint8_t reg, uint8_t *data, size_t len)
+{
+    if (!range_cacheable(reg, len))
+        return 0;
+
+    for (size_t i = 0; i < len; i++) {
+        if (!bit_get(s->shadow_valid, (uint8_t)(reg + i)))
+            return 0;
+    }
+
+    memcpy(data, &s->shadow[reg], len);
+    return 1;
+}
+
+/*
+    Remplissage du cache après une lecture bus ; une écriture en attente
+    reste prioritaire (data est corrigé).
+*/
+static void cache_fill(sensor_t *s, uint8_t reg, uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+
+        if (!reg_is_cacheable(r))
+            continue;
+
+        if (bit_get(s->shadow_dirty, r)) {
+            data[i] = s->shadow[r];
+        } else {
+            s->shadow[r] = data[i];
+            bit_set(s->shadow_valid, r);
+        }
+    }
+}
+
+/*
+    Lecture via le cache shadow.
+*/
+sensor_status_t sensor_reg_read(
+    sensor_t *s,
+    uint8_t reg,
+    uint8_t *data,
+    size_t len
+)
+{
+    if (!s || !data || !HAL_BUS_CAN_READ(s->bus))
+        return SENSOR_ERR;
+
+    // Tout est en cache : aucun accès bus
+    if (cache_lookup(s, reg, data, len))
+        return SENSOR_OK;
+
+    if (HAL_BUS_READ(s->bus, s->dev_addr, reg, data, len) != HAL_OK)
+        return SENSOR_ERR;
+
+    cache_fill(s, reg, data, len);
+    return SENSOR_OK;
+}
+
+/*
+    Écriture : différée si cacheable, immédiate sinon.
+*/
+sensor_status_t sensor_reg_write(
+    sensor_t *s,
+    uint8_t reg,
+    const uint8_t *data,
+    size_t len
+)
+{
+    if (!s || !data || !HAL_BUS_CAN_WRITE(s->bus))
+        return SENSOR_ERR;
+
+    // Registre en lecture seule dans la plage : rien n'est écrit, pas même en cache
+    if (!range_writable(reg, len))
+        return SENSOR_ERR;
+
+    if (range_cacheable(reg, len)) {
+        for (size_t i = 0; i < len; i++) {
+            uint8_t r = (uint8_t)(reg + i);
+            s->shadow[r] = data[i];
+            bit_set(s->shadow_valid, r);
+            bit_set(s->shadow_dirty, r);
+        }
+        return SENSOR_OK;
+    }
+
+    if (HAL_BUS_WRITE(s->bus, s->dev_addr, reg, data, len) != HAL_OK) {
+        SENSOR_LOGE_RL(s,
+                       "sensor 0x%02X: write 0x%02X failed", s->dev_addr, reg);
+        return SENSOR_ERR;
+    }
+
+    // Le capteur a maintenant ces valeurs : cache propre
+    for (size_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)(reg + i);
+        if (reg_is_cacheable(r)) {
+            s->shadow[r] = data[i];
+            bit_set(s->shadow_valid, r);
+            bit_clear(s->shadow_dirty, r);
+        }
+    }
+
+    return SENSOR_OK;
+}
+
+/*
+    Flush : une rafale par groupe de registres sales proches.
+
+    Un trou de SENSOR_FLUSH_MAX_GAP registres au plus est comblé
+    si ces registres sont inscriptibles, cacheables et valides
+    (on renvoie leur valeur actuelle, sans effet).
+*/
+sensor_status_t sensor_flush(sensor_t *s)
+{
+    if (!s || !HAL_BUS_CAN_WRITE(s->bus))
+        return SENSOR_ERR;
+
+    uint8_t r = 0;
+
+    while (r < SENSOR_SHADOW_SIZE) {
+        if (!bit_get(s->shadow_dirty, r)) {
+            r++;
+            continue;
+        }
+
+        uint8_t start = r;
+        uint8_t end = r; // dernier registre sale inclus
+
+        // Étendre la plage tant qu'on trouve un registre sale assez proche
+        for (uint8_t next = (uint8_t)(end + 1); next < SENSOR_SHADOW_SIZE; next++) {
+            if (next - end - 1 > SENSOR_FLUSH_MAX_GAP)
+                break;
+            if (bit_get(s->shadow_dirty, next)) {
+                end = next;
+                continue;
+            }
+            if (!reg_is_writable(next) || !reg_is_cacheable(next) ||
+                !bit_get(s->shadow_valid, next))
+                break;
+        }
+
+        size_t len = (size_t)(end - start) + 1;
+        if (HAL_BUS_WRITE(s->bus, s->dev_addr, start, &s->shadow[start], len) != HAL_OK) {
+            SENSOR_LOGE_RL(s,
+                           "sensor 0x%02X: flush 0x%02X..0x%02X failed", s->dev_addr, start, end);
+            return SENSOR_ERR;
+        }
+
+        for (uint8_t i = start; i <= end; i++) {
+            bit_clear(s->shadow_dirty, i);
+        }
+
+        r = (uint8_t)(end + 1);
+    }
+
+    return SENSOR_OK;
+}
+
+void sensor_cache_invalidate(sensor_t *s)
+{
+    if (!s)
+        return;
+
+    memset(s->shadow_valid, 0, sizeof(s->shadow_valid));
+    memset(s->shadow_dirty, 0, sizeof(s->shadow_dirty));
+}
+
+/*
+    Vrai si [from, to) peut être lu sans effet de bord
+    (on peut donc l'inclure dans une rafale sans le demander).
+*/
+static int gap_is_harmless(unsigned from, unsigned to)
+{
+    for (unsigned r = from; r < to; r++) {
+        if (sensor_regmap_has_read_side_effect((uint8_t)r))
+            return 0;
+    }
+    return 1;
+}
+
+/*
+    Décodage d'un champ selon sa largeur, son endianness et son signe.
+*/
+static int32_t field_decode(const sensor_reg_desc_t *d, const uint8_t *p)
+{
+    uint32_t raw = 0;
+
+    for (uint8_t k = 0; k < d->width; k++) {
+        uint8_t byte = (d->flags & SENSOR_REG_BE) ? p[k] : p[d->width - 1 - k];
+        raw = (raw << 8) | byte;
+    }
+
+    // Extension de signe (complément à 2)
+    if ((d->flags & SENSOR_REG_SIGNED) && d->width < 4) {
+        uint32_t sign = 1u << (8 * d->width - 1);
+        return (int32_t)(raw ^ sign) - (int32_t)sign;
+    }
+
+    return (int32_t)raw;
+}
+
+/*
+    Lecture groupée de champs.
+*/
+sensor_status_t sensor_read_fields(
+    sensor_t *s,
+    const sensor_field_t *fields,
+    size_t n_fields,
+    int32_t *values_out
+)
+{
+    if (!s || !fields || !values_out || !HAL_BUS_CAN_READ(s->bus))
+        return SENSOR_ERR;
+
+    if (n_fields > SENSOR_READ_FIELDS_MAX)
+        return SENSOR_ERR;
+
+    const sensor_reg_desc_t *desc[SENSOR_READ_FIELDS_MAX];
+    uint8_t order[SENSOR_READ_FIELDS_MAX];
+
+    for (size_t i = 0; i < n_fields; i++) {
+        desc[i] = sensor_reg_desc(fields[i]);
+        if (!desc[i] || !(desc[i]->flags & SENSOR_REG_R))
+            return SENSOR_ERR;
+        order[i] = (uint8_t)i;
+    }
+
+    // Tri par adresse (insertion : n petit)
+    for (size_t i = 1; i < n_fields; i++) {
+        uint8_t cur = order[i];
+        size_t j = i;
+        while (j > 0 && desc[order[j - 1]]->addr > desc[cur]->addr) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = cur;
+    }
+
+    /*
+        Rafales : servies par le cache, sinon un segment chacune ;
+        tous les segments partent en un seul transfert vectorisé.
+    */
+    uint8_t buf[256];
+    size_t buf_used = 0;
+    hal_bus_seg_t segs[SENSOR_READ_FIELDS_MAX];
+    size_t n_segs = 0;
+    uint16_t burst_off[SENSOR_READ_FIELDS_MAX];
+    uint8_t burst_start[SENSOR_READ_FIELDS_MAX];
+    uint8_t burst_first[SENSOR_READ_FIELDS_MAX + 1];
+    size_t n_bursts = 0;
+    size_t i = 0;
+
+    while (i < n_fields) {
+        const sensor_reg_desc_t *first = desc[order[i]];
+        unsigned start = first->addr;
+        unsigned end = start + first->width; // exclu
+        size_t j = i + 1;
+
+        // Étendre la rafale tant que le champ suivant est assez proche
+        if (!(first->flags & SENSOR_REG_STREAM)) {
+            while (j < n_fields) {
+                const sensor_reg_desc_t *d = desc[order[j]];
+                unsigned d_end = (unsigned)d->addr + d->width;
+
+                if (d->flags & SENSOR_REG_STREAM)
+                    break;
+                if (d->addr > end + SENSOR_COALESCE_MAX_GAP)
+                    break;
+                if (d->addr > end && !gap_is_harmless(end, d->addr))
+                    break;
+
+                if (d_end > end)
+                    end = d_end;
+                j++;
+            }
+        }
+
+        // Au plus 16 champs de 4 octets + trous de 4 : tient dans buf
+        uint8_t *dst = &buf[buf_used];
+        if (!cache_lookup(s, (uint8_t)start, dst, end - start)) {
+            hal_bus_seg_t *sg = &segs[n_segs++];
+            sg->dev_addr = s->dev_addr;
+            sg->reg = (uint8_t)start;
+            sg->dir = HAL_BUS_SEG_READ;
+            sg->data = dst;
+            sg->len = end - start;
+        }
+
+        burst_off[n_bursts] = (uint16_t)buf_used;
+        burst_start[n_bursts] = (uint8_t)start;
+        burst_first[n_bursts] = (uint8_t)i;
+        n_bursts++;
+        buf_used += end - start;
+
+        i = j;
+    }
+    burst_first[n_bursts] = (uint8_t)n_fields;
+
+    if (n_segs) {
+        if (HAL_BUS_XFER(s->bus, s->xfer, segs, n_segs) != HAL_OK) {
+            SENSOR_LOGE_RL(s,
+                           "sensor 0x%02X: read of %u bursts from 0x%02X failed",
+                           s->dev_addr, (unsigned)n_segs, segs[0].reg);
+            return SENSOR_ERR;
+        }
+        for (size_t k = 0; k < n_segs; k++) {
+            cache_fill(s, segs[k].reg, segs[k].data, segs[k].len);
+        }
+    }
+
+    for (size_t b = 0; b < n_bursts; b++) {
+        const uint8_t *base = &buf[burst_off[b]];
+        for (size_t k = burst_first[b]; k < burst_first[b + 1]; k++) {
+            const sensor_reg_desc_t *d = desc[order[k]];
+            values_out[order[k]] = field_decode(d, &base[d->addr - burst_start[b]]);
+        }
+    }
 
     return SENSOR_OK;
 }
@@ -0,0 +1,180 @@
+/*
+    sensor_cal.c
+
+    Calibration en virgule fixe (aucun flottant).
+*/
+
+#include "sensor/sensor_cal.h"
+#include <string.h> // memset
+
+static int16_t saturate16(int64_t v)
+{
+    if (v > INT16_MAX)
+        return INT16_MAX;
+    if (v < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t)v;
+}
+
+/*
+    Arrondi au plus proche d'une valeur en virgule fixe (frac bits).
+    (décalage arithmétique des négatifs : GCC/Clang/IAR/ARMCC)
+*/
+static int64_t round_shift(int64_t v, unsigned frac)
+{
+    return (v + ((int64_t)1 << (frac - 1))) >> frac;
+}
+
+/*
+    Horner sur u = x / 2^15 : acc reste en Q16 (centi-degrés),
+    chaque étape multiplie par x puis redescend de 15 bits.
+    |acc| <= sum(|ck|) + n (borné à l'init) : acc * x ne déborde pas.
+*/
+static inline int16_t poly_eval(const sensor_cal_t *cal, int16_t x)
+{
+    int64_t acc = cal->coef[cal->n_coef - 1];
+
+    for (int k = (int)cal->n_coef - 2; k >= 0; k--) {
+        acc = round_shift(acc * x, SENSOR_CAL_X_FRAC) + cal->coef[k];
+    }
+
+    return saturate16(round_shift(acc, SENSOR_CAL_FRAC));
+}
+
+/*
+    Segment contenant x (premier / dernier pour l'extrapolation).
+    Recherche dichotomique : au plus 4 itérations pour 16 points.
+*/
+static inline int16_t lut_eval(const sensor_cal_t *cal, int16_t x)
+{
+    size_t lo = 0;
+    size_t hi = (size_t)cal->n_points - 2; // dernier segment
+
+    while (lo < hi) {
+        size_t mid = (lo + hi + 1) / 2;
+        if (cal->lut_x[mid] <= x)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    int64_t dx = (int64_t)x - cal->lut_x[lo];
+    int64_t y = cal->lut_y[lo] + round_shift(dx * cal->lut_slope[lo], SENSOR_CAL_SLOPE_FRAC);
+
+    return saturate16(y);
+}
+
+sensor_status_t sensor_cal_init_poly(
+    sensor_cal_t *cal,
+    const int64_t *coef,
+    size_t n_coef
+)
+{
+    if (!cal || !coef || n_coef == 0 || n_coef > SENSOR_CAL_POLY_MAX_COEF)
+        return SENSOR_ERR;
+
+    // Borne de l'accumulateur (chaque |ck| testé avant la somme : pas de débordement)
+    int64_t sum = 0;
+    for (size_t i = 0; i < n_coef; i++) {
+        if (coef[i] > SENSOR_CAL_COEF_SUM_MAX || coef[i] < -SENSOR_CAL_COEF_SUM_MAX)
+            return SENSOR_ERR;
+        sum += (coef[i] < 0) ? -coef[i] : coef[i];
+    }
+    if (sum > SENSOR_CAL_COEF_SUM_MAX)
+        return SENSOR_ERR;
+
+    memset(cal, 0, sizeof(*cal));
+    cal->kind = SENSOR_CAL_POLY;
+    cal->n_coef = (uint8_t)n_coef;
+
+    for (size_t i = 0; i < n_coef; i++) {
+        cal->coef[i] = coef[i];
+    }
+
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_cal_init_lut(
+    sensor_cal_t *cal,
+    const int16_t *x,
+    const int16_t *y,
+    size_t n
+)
+{
+    if (!cal || !x || !y || n < 2 || n > SENSOR_CAL_LUT_MAX)
+        return SENSOR_ERR;
+
+    memset(cal, 0, sizeof(*cal));
+
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0 && x[i] <= x[i - 1])
+            return SENSOR_ERR;
+
+        cal->lut_x[i] = x[i];
+        cal->lut_y[i] = y[i];
+    }
+
+    // Pentes précalculées : la seule division de la calibration
+    for (size_t i = 0; i + 1 < n; i++) {
+        int64_t dy = (int64_t)y[i + 1] - y[i];
+        int64_t dx = (int64_t)x[i + 1] - x[i];
+        int64_t slope = dy * ((int64_t)1 << SENSOR_CAL_SLOPE_FRAC) / dx;
+
+        if (slope > INT32_MAX || slope < INT32_MIN)
+            return SENSOR_ERR;
+
+        cal->lut_slope[i] = (int32_t)slope;
+    }
+
+    cal->kind = SENSOR_CAL_LUT;
+    cal->n_points = (uint8_t)n;
+    return SENSOR_OK;
+}
+
+int16_t sensor_cal_apply(const sensor_cal_t *cal, int16_t raw)
+{
+    if (!cal)
+        return raw;
+
+    switch (cal->kind) {
+        case SENSOR_CAL_POLY: return poly_eval(cal, raw);
+        case SENSOR_CAL_LUT:  return lut_eval(cal, raw);
+        default:              return raw;
+    }
+}
+
+void sensor_cal_apply_batch(
+    const sensor_cal_t *cal,
+    const int16_t *in,
+    int16_t *out,
+    size_t n
+)
+{
+    if (!in || !out)
+        return;
+
+    // Le type de calibration est testé une fois par lot, pas par échantillon
+    if (cal && cal->kind == SENSOR_CAL_POLY) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = poly_eval(cal, in[i]);
+        }
+    } else if (cal && cal->kind == SENSOR_CAL_LUT) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = lut_eval(cal, in[i]);
+        }
+    } else if (in != out) {
+        memmove(out, in, n * sizeof(*out));
+    }
+}
+
+sensor_status_t sensor_set_calibration(sensor_t *s, const sensor_cal_t *cal)
+{
+    if (!s)
+        return SENSOR_ERR;
+
+    if (cal && cal->kind != SENSOR_CAL_POLY && cal->kind != SENSOR_CAL_LUT)
+        return SENSOR_ERR;
+
+    s->cal = cal;
+    return SENSOR_OK;
+}
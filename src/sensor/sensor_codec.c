@@ -0,0 +1,372 @@
+/*
+    sensor_codec.c
+
+    Delta + zigzag + bit-packing à largeur fixe par bloc.
+
+    La largeur fixe rend le décodage sans branche par échantillon :
+    une lecture de bits à largeur constante puis une addition.
+*/
+
+#include "sensor/sensor_codec.h"
+#include <string.h> // memset
+
+/* ---------------- Utilitaires ---------------- */
+
+static uint64_t zigzag(int64_t v)
+{
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t u)
+{
+    return (int64_t)(u >> 1) ^ -(int64_t)(u & 1);
+}
+
+static uint8_t bit_width(uint64_t v)
+{
+    uint8_t w = 0;
+    while (v) {
+        w++;
+        v >>= 1;
+    }
+    return w;
+}
+
+static void put_le(uint8_t *p, uint64_t v, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static uint64_t get_le(const uint8_t *p, size_t bytes)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        v |= (uint64_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+/*
+    Écriture de bits, LSB d'abord.
+*/
+typedef struct {
+    uint8_t *p;
+    uint64_t acc;
+    unsigned cnt;
+} bit_writer_t;
+
+static void bw_put32(bit_writer_t *bw, uint64_t v, unsigned w)
+{
+    bw->acc |= (v & ((w == 32) ? 0xFFFFFFFFu : ((1ull << w) - 1))) << bw->cnt;
+    bw->cnt += w;
+
+    while (bw->cnt >= 8) {
+        *bw->p++ = (uint8_t)bw->acc;
+        bw->acc >>= 8;
+        bw->cnt -= 8;
+    }
+}
+
+static void bw_put(bit_writer_t *bw, uint64_t v, unsigned w)
+{
+    if (w > 32) {
+        bw_put32(bw, v, 32);
+        bw_put32(bw, v >> 32, w - 32);
+    } else if (w > 0) {
+        bw_put32(bw, v, w);
+    }
+}
+
+static void bw_finish(bit_writer_t *bw)
+{
+    if (bw->cnt > 0) {
+        *bw->p++ = (uint8_t)bw->acc;
+    }
+}
+
+/*
+    Lecture de bits : l'accumulateur est rechargé octet par octet
+    (jamais au-delà de end).
+*/
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    uint64_t acc;
+    unsigned cnt;
+} bit_reader_t;
+
+static inline uint64_t br_get32(bit_reader_t *br, unsigned w)
+{
+    while (br->cnt < w) {
+        uint64_t byte = (br->p < br->end) ? *br->p++ : 0;
+        br->acc |= byte << br->cnt;
+        br->cnt += 8;
+    }
+
+    uint64_t v = br->acc & ((1ull << w) - 1);
+    br->acc >>= w;
+    br->cnt -= w;
+    return v;
+}
+
+static inline uint64_t br_get(bit_reader_t *br, unsigned w)
+{
+    if (w > 32) {
+        uint64_t lo = br_get32(br, 32);
+        return lo | (br_get32(br, w - 32) << 32);
+    }
+    return (w > 0) ? br_get32(br, w) : 0;
+}
+
+static size_t payload_bytes(size_t n, unsigned vb, unsigned tb)
+{
+    size_t bits = (n - 1) * vb + ((n > 2) ? (n - 2) * tb : 0);
+    return (bits + 7) / 8;
+}
+
+/* ---------------- Blocs ---------------- */
+
+sensor_status_t sensor_codec_encode_block(
+    const int16_t *values,
+    const uint64_t *t_us,
+    size_t n,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+)
+{
+    if (!values || !t_us || !out || !written || n == 0 || n > SENSOR_CODEC_BLOCK_MAX)
+        return SENSOR_ERR;
+
+    *written = 0;
+
+    // 1re passe : validité des horodatages + largeurs nécessaires
+    uint64_t vmax = 0;
+    uint64_t tmax = 0;
+
+    for (size_t i = 1; i < n; i++) {
+        if (t_us[i] < t_us[i - 1] || t_us[i] - t_us[i - 1] > UINT32_MAX)
+            return SENSOR_ERR;
+
+        vmax |= zigzag((int64_t)values[i] - values[i - 1]);
+
+        if (i >= 2) {
+            int64_t dod = (int64_t)(t_us[i] - t_us[i - 1]) - (int64_t)(t_us[i - 1] - t_us[i - 2]);
+            tmax |= zigzag(dod);
+        }
+    }
+
+    // OR des valeurs : même largeur que le max, sans comparaison
+    uint8_t vb = bit_width(vmax);
+    uint8_t tb = bit_width(tmax);
+    size_t size = SENSOR_CODEC_HEADER_SIZE + payload_bytes(n, vb, tb);
+
+    if (size > cap)
+        return SENSOR_ERR;
+
+    uint8_t *h = out;
+    h[0] = SENSOR_CODEC_MAGIC;
+    h[1] = vb;
+    h[2] = tb;
+    h[3] = 0;
+    put_le(h + 4, n, 2);
+    put_le(h + 6, (uint16_t)values[0], 2);
+    put_le(h + 8, t_us[0], 8);
+    put_le(h + 16, (n > 1) ? t_us[1] - t_us[0] : 0, 4);
+    put_le(h + 20, size - SENSOR_CODEC_HEADER_SIZE, 4);
+
+    // 2e passe : bit-packing
+    bit_writer_t bw = { out + SENSOR_CODEC_HEADER_SIZE, 0, 0 };
+
+    for (size_t i = 1; i < n; i++) {
+        bw_put(&bw, zigzag((int64_t)values[i] - values[i - 1]), vb);
+    }
+    for (size_t i = 2; i < n; i++) {
+        int64_t dod = (int64_t)(t_us[i] - t_us[i - 1]) - (int64_t)(t_us[i - 1] - t_us[i - 2]);
+        bw_put(&bw, zigzag(dod), tb);
+    }
+    bw_finish(&bw);
+
+    *written = size;
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_codec_block_info(
+    const uint8_t *buf,
+    size_t len,
+    sensor_codec_block_info_t *info
+)
+{
+    if (!buf || !info || len < SENSOR_CODEC_HEADER_SIZE)
+        return SENSOR_ERR;
+
+    if (buf[0] != SENSOR_CODEC_MAGIC || buf[3] != 0)
+        return SENSOR_ERR;
+
+    uint16_t n = (uint16_t)get_le(buf + 4, 2);
+    uint8_t vb = buf[1];
+    uint8_t tb = buf[2];
+    uint32_t payload = (uint32_t)get_le(buf + 20, 4);
+
+    if (n == 0 || n > SENSOR_CODEC_BLOCK_MAX || vb > 17 || tb > 33)
+        return SENSOR_ERR;
+
+    if (payload != payload_bytes(n, vb, tb) || payload > len - SENSOR_CODEC_HEADER_SIZE)
+        return SENSOR_ERR;
+
+    info->n = n;
+    info->value_bits = vb;
+    info->ts_bits = tb;
+    info->v0 = (int16_t)(uint16_t)get_le(buf + 6, 2);
+    info->t0_us = get_le(buf + 8, 8);
+    info->size = SENSOR_CODEC_HEADER_SIZE + payload;
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_codec_decode_block(
+    const uint8_t *buf,
+    size_t len,
+    int16_t *values,
+    uint64_t *t_us,
+    size_t max,
+    size_t *n_out
+)
+{
+    sensor_codec_block_info_t info;
+
+    if (!values || !n_out || sensor_codec_block_info(buf, len, &info) != SENSOR_OK)
+        return SENSOR_ERR;
+
+    if (info.n > max)
+        return SENSOR_ERR;
+
+    size_t n = info.n;
+    bit_reader_t br = { buf + SENSOR_CODEC_HEADER_SIZE, buf + info.size, 0, 0 };
+
+    // Valeurs : cumul des deltas (arithmétique 16 bits modulaire)
+    uint16_t v = (uint16_t)info.v0;
+    values[0] = info.v0;
+
+    if (info.value_bits == 0) {
+        for (size_t i = 1; i < n; i++) {
+            values[i] = info.v0;
+        }
+    } else {
+        for (size_t i = 1; i < n; i++) {
+            v = (uint16_t)(v + (uint16_t)unzigzag(br_get32(&br, info.value_bits)));
+            values[i] = (int16_t)v;
+        }
+    }
+
+    // Horodatages : à la suite des valeurs dans le flux de bits
+    if (t_us) {
+        uint64_t t = info.t0_us;
+        int64_t dt = (int64_t)get_le(buf + 16, 4);
+
+        t_us[0] = t;
+        for (size_t i = 1; i < n; i++) {
+            if (i >= 2) {
+                dt += unzigzag(br_get(&br, info.ts_bits));
+            }
+            t += (uint64_t)dt;
+            t_us[i] = t;
+        }
+    }
+
+    *n_out = n;
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_codec_seek(
+    const uint8_t *stream,
+    size_t len,
+    uint64_t t_us,
+    size_t *offset
+)
+{
+    if (!stream || !offset)
+        return SENSOR_ERR;
+
+    size_t pos = 0;
+    int found = 0;
+
+    while (pos < len) {
+        sensor_codec_block_info_t info;
+        if (sensor_codec_block_info(stream + pos, len - pos, &info) != SENSOR_OK)
+            return SENSOR_ERR;
+
+        if (info.t0_us > t_us)
+            break;
+
+        *offset = pos;
+        found = 1;
+        pos += info.size;
+    }
+
+    return found ? SENSOR_OK : SENSOR_ERR;
+}
+
+/* ---------------- Encodeur en flux ---------------- */
+
+sensor_status_t sensor_encoder_init(sensor_encoder_t *enc, uint16_t block_len)
+{
+    if (!enc || block_len == 0 || block_len > SENSOR_CODEC_BLOCK_MAX)
+        return SENSOR_ERR;
+
+    enc->n = 0;
+    enc->block_len = block_len;
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_encoder_flush(
+    sensor_encoder_t *enc,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+)
+{
+    if (!enc || !out || !written)
+        return SENSOR_ERR;
+
+    *written = 0;
+    if (enc->n == 0)
+        return SENSOR_OK;
+
+    if (sensor_codec_encode_block(enc->values, enc->t_us, enc->n, out, cap, written) != SENSOR_OK)
+        return SENSOR_ERR;
+
+    enc->n = 0;
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_encoder_push(
+    sensor_encoder_t *enc,
+    int16_t value,
+    uint64_t t_us,
+    uint8_t *out,
+    size_t cap,
+    size_t *written
+)
+{
+    if (!enc || !out || !written || cap < SENSOR_CODEC_BLOCK_BOUND(enc->block_len))
+        return SENSOR_ERR;
+
+    *written = 0;
+
+    if (enc->n > 0) {
+        uint64_t prev = enc->t_us[enc->n - 1];
+        if (t_us < prev || t_us - prev > UINT32_MAX)
+            return SENSOR_ERR;
+    }
+
+    enc->values[enc->n] = value;
+    enc->t_us[enc->n] = t_us;
+    enc->n++;
+
+    if (enc->n < enc->block_len)
+        return SENSOR_OK;
+
+    return sensor_encoder_flush(enc, out, cap, written);
+}
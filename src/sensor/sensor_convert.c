@@ -0,0 +1,399 @@
+/*
+    sensor_convert.c
+
+    Kernels de conversion par lots des échantillons int16 big-endian.
+
+    Chaque implémentation traite des blocs de 8 ou 16 échantillons
+    puis délègue la fin du tableau au code scalaire : les résultats
+    sont donc identiques quelle que soit la longueur.
+
+    Choix de l'implémentation :
+    - à la compilation : ce que l'architecture cible sait faire
+      (SSE2 sur x86-64, NEON sur ARM)
+    - à l'exécution : AVX2 seulement si le CPU le supporte
+      (fonctions compilées avec __attribute__((target("avx2"))),
+      sans option globale -mavx2)
+*/
+
+#include "sensor/sensor_convert.h"
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define CONVERT_HAVE_AVX2 1
+#  if defined(__SSE2__)
+#    define CONVERT_HAVE_SSE2 1
+#  endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define CONVERT_HAVE_NEON 1
+#endif
+
+/*
+    Table de kernels d'une implémentation.
+*/
+typedef struct {
+    sensor_convert_isa_t isa;
+    void (*to_centi)(const uint8_t *raw, int16_t *out, size_t n);
+    void (*to_float)(const uint8_t *raw, float *out, size_t n, float scale, float offset);
+    void (*to_fixed)(const uint8_t *raw, int32_t *out, size_t n, int16_t gain, int32_t offset);
+} convert_impl_t;
+
+/* ---------------- Scalaire (référence) ---------------- */
+
+static inline int16_t be16(const uint8_t *p)
+{
+    return (int16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static void scalar_to_centi(const uint8_t *raw, int16_t *out, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[i] = be16(&raw[2 * i]);
+    }
+}
+
+static void scalar_to_float(const uint8_t *raw, float *out, size_t n, float scale, float offset)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (float)be16(&raw[2 * i]) * scale + offset;
+    }
+}
+
+static void scalar_to_fixed(const uint8_t *raw, int32_t *out, size_t n, int16_t gain, int32_t offset)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (int32_t)be16(&raw[2 * i]) * gain + offset;
+    }
+}
+
+static const convert_impl_t impl_scalar = {
+    SENSOR_CONVERT_SCALAR, scalar_to_centi, scalar_to_float, scalar_to_fixed
+};
+
+/* ---------------- SSE2 : 8 échantillons par itération ---------------- */
+
+#if defined(CONVERT_HAVE_SSE2)
+
+// Inversion des octets de chaque mot de 16 bits
+static inline __m128i sse2_bswap16(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static void sse2_to_centi(const uint8_t *raw, int16_t *out, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(raw + 2 * i));
+        _mm_storeu_si128((__m128i *)(out + i), sse2_bswap16(v));
+    }
+
+    scalar_to_centi(raw + 2 * i, out + i, n - i);
+}
+
+static void sse2_to_float(const uint8_t *raw, float *out, size_t n, float scale, float offset)
+{
+    const __m128 vs = _mm_set1_ps(scale);
+    const __m128 vo = _mm_set1_ps(offset);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = sse2_bswap16(_mm_loadu_si128((const __m128i *)(raw + 2 * i)));
+
+        // Extension de signe 16 -> 32 bits (SSE2 : dupliquer puis décaler)
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+
+        _mm_storeu_ps(out + i,     _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(lo), vs), vo));
+        _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(hi), vs), vo));
+    }
+
+    scalar_to_float(raw + 2 * i, out + i, n - i, scale, offset);
+}
+
+static void sse2_to_fixed(const uint8_t *raw, int32_t *out, size_t n, int16_t gain, int32_t offset)
+{
+    const __m128i vg = _mm_set1_epi16(gain);
+    const __m128i vo = _mm_set1_epi32(offset);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = sse2_bswap16(_mm_loadu_si128((const __m128i *)(raw + 2 * i)));
+
+        // Produit 16x16 -> 32 exact : moitiés basse et haute recombinées
+        __m128i pl = _mm_mullo_epi16(v, vg);
+        __m128i ph = _mm_mulhi_epi16(v, vg);
+
+        _mm_storeu_si128((__m128i *)(out + i),
+                         _mm_add_epi32(_mm_unpacklo_epi16(pl, ph), vo));
+        _mm_storeu_si128((__m128i *)(out + i + 4),
+                         _mm_add_epi32(_mm_unpackhi_epi16(pl, ph), vo));
+    }
+
+    scalar_to_fixed(raw + 2 * i, out + i, n - i, gain, offset);
+}
+
+static const convert_impl_t impl_sse2 = {
+    SENSOR_CONVERT_SSE2, sse2_to_centi, sse2_to_float, sse2_to_fixed
+};
+
+#endif
+
+/* ---------------- AVX2 : 16 (centi) ou 8 échantillons par itération ---------------- */
+
+#if defined(CONVERT_HAVE_AVX2)
+
+#define AVX2_FN __attribute__((target("avx2")))
+
+AVX2_FN static void avx2_to_centi(const uint8_t *raw, int16_t *out, size_t n)
+{
+    const __m256i swap = _mm256_setr_epi8(
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+        1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(raw + 2 * i));
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_shuffle_epi8(v, swap));
+    }
+
+    scalar_to_centi(raw + 2 * i, out + i, n - i);
+}
+
+// 8 échantillons big-endian -> 8 entiers 32 bits signés
+AVX2_FN static inline __m256i avx2_load8_be16_epi32(const uint8_t *p)
+{
+    const __m128i swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), swap);
+    return _mm256_cvtepi16_epi32(v);
+}
+
+AVX2_FN static void avx2_to_float(const uint8_t *raw, float *out, size_t n, float scale, float offset)
+{
+    const __m256 vs = _mm256_set1_ps(scale);
+    const __m256 vo = _mm256_set1_ps(offset);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 f = _mm256_cvtepi32_ps(avx2_load8_be16_epi32(raw + 2 * i));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(f, vs), vo));
+    }
+
+    scalar_to_float(raw + 2 * i, out + i, n - i, scale, offset);
+}
+
+AVX2_FN static void avx2_to_fixed(const uint8_t *raw, int32_t *out, size_t n, int16_t gain, int32_t offset)
+{
+    const __m256i vg = _mm256_set1_epi32(gain);
+    const __m256i vo = _mm256_set1_epi32(offset);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = avx2_load8_be16_epi32(raw + 2 * i);
+        _mm256_storeu_si256((__m256i *)(out + i),
+                            _mm256_add_epi32(_mm256_mullo_epi32(x, vg), vo));
+    }
+
+    scalar_to_fixed(raw + 2 * i, out + i, n - i, gain, offset);
+}
+
+static const convert_impl_t impl_avx2 = {
+    SENSOR_CONVERT_AVX2, avx2_to_centi, avx2_to_float, avx2_to_fixed
+};
+
+#endif
+
+/* ---------------- NEON : 8 échantillons par itération ---------------- */
+
+#if defined(CONVERT_HAVE_NEON)
+
+static inline int16x8_t neon_load8_be16(const uint8_t *p)
+{
+    return vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8(p)));
+}
+
+static void neon_to_centi(const uint8_t *raw, int16_t *out, size_t n)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        vst1q_s16(out + i, neon_load8_be16(raw + 2 * i));
+    }
+
+    scalar_to_centi(raw + 2 * i, out + i, n - i);
+}
+
+static void neon_to_float(const uint8_t *raw, float *out, size_t n, float scale, float offset)
+{
+    const float32x4_t vs = vdupq_n_f32(scale);
+    const float32x4_t vo = vdupq_n_f32(offset);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = neon_load8_be16(raw + 2 * i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+
+        vst1q_f32(out + i,     vaddq_f32(vmulq_f32(lo, vs), vo));
+        vst1q_f32(out + i + 4, vaddq_f32(vmulq_f32(hi, vs), vo));
+    }
+
+    scalar_to_float(raw + 2 * i, out + i, n - i, scale, offset);
+}
+
+static void neon_to_fixed(const uint8_t *raw, int32_t *out, size_t n, int16_t gain, int32_t offset)
+{
+    const int16x4_t vg = vdup_n_s16(gain);
+    const int32x4_t vo = vdupq_n_s32(offset);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t v = neon_load8_be16(raw + 2 * i);
+
+        // offset + v * gain, produit 16x16 -> 32 exact
+        vst1q_s32(out + i,     vmlal_s16(vo, vget_low_s16(v), vg));
+        vst1q_s32(out + i + 4, vmlal_s16(vo, vget_high_s16(v), vg));
+    }
+
+    scalar_to_fixed(raw + 2 * i, out + i, n - i, gain, offset);
+}
+
+static const convert_impl_t impl_neon = {
+    SENSOR_CONVERT_NEON, neon_to_centi, neon_to_float, neon_to_fixed
+};
+
+#endif
+
+/* ---------------- Dispatch ---------------- */
+
+/*
+    Implémentation active : résolue au premier appel.
+    Deux threads qui la résolvent en même temps écrivent la même valeur.
+*/
+static _Atomic(const convert_impl_t *) g_impl = NULL;
+
+/*
+    Implémentation demandée, NULL si indisponible ici.
+*/
+static const convert_impl_t *impl_lookup(sensor_convert_isa_t isa)
+{
+    switch (isa) {
+        case SENSOR_CONVERT_AUTO: {
+            const convert_impl_t *best = &impl_scalar;
+#if defined(CONVERT_HAVE_NEON)
+            best = &impl_neon;
+#endif
+#if defined(CONVERT_HAVE_SSE2)
+            best = &impl_sse2;
+#endif
+#if defined(CONVERT_HAVE_AVX2)
+            if (impl_lookup(SENSOR_CONVERT_AVX2))
+                best = &impl_avx2;
+#endif
+            return best;
+        }
+
+        case SENSOR_CONVERT_SCALAR:
+            return &impl_scalar;
+
+#if defined(CONVERT_HAVE_SSE2)
+        case SENSOR_CONVERT_SSE2:
+            return &impl_sse2;
+#endif
+
+#if defined(CONVERT_HAVE_AVX2)
+        case SENSOR_CONVERT_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? &impl_avx2 : NULL;
+#endif
+
+#if defined(CONVERT_HAVE_NEON)
+        case SENSOR_CONVERT_NEON:
+            return &impl_neon;
+#endif
+
+        default:
+            return NULL;
+    }
+}
+
+static const convert_impl_t *impl_get(void)
+{
+    const convert_impl_t *impl = atomic_load_explicit(&g_impl, memory_order_acquire);
+
+    if (!impl) {
+        impl = impl_lookup(SENSOR_CONVERT_AUTO);
+        atomic_store_explicit(&g_impl, impl, memory_order_release);
+    }
+
+    return impl;
+}
+
+/* ---------------- API publique ---------------- */
+
+void sensor_convert_be16_to_centi(const uint8_t *raw, int16_t *out, size_t n)
+{
+    if (!raw || !out || n == 0)
+        return;
+
+    impl_get()->to_centi(raw, out, n);
+}
+
+void sensor_convert_be16_to_float(
+    const uint8_t *raw,
+    float *out,
+    size_t n,
+    float scale,
+    float offset
+)
+{
+    if (!raw || !out || n == 0)
+        return;
+
+    impl_get()->to_float(raw, out, n, scale, offset);
+}
+
+void sensor_convert_be16_to_fixed(
+    const uint8_t *raw,
+    int32_t *out,
+    size_t n,
+    int16_t gain,
+    int32_t offset
+)
+{
+    if (!raw || !out || n == 0)
+        return;
+
+    impl_get()->to_fixed(raw, out, n, gain, offset);
+}
+
+sensor_status_t sensor_convert_select(sensor_convert_isa_t isa)
+{
+    const convert_impl_t *impl = impl_lookup(isa);
+    if (!impl)
+        return SENSOR_ERR;
+
+    atomic_store_explicit(&g_impl, impl, memory_order_release);
+    return SENSOR_OK;
+}
+
+sensor_convert_isa_t sensor_convert_active(void)
+{
+    return impl_get()->isa;
+}
+
+const char *sensor_convert_isa_name(sensor_convert_isa_t isa)
+{
+    switch (isa) {
+        case SENSOR_CONVERT_AUTO:   return "auto";
+        case SENSOR_CONVERT_SCALAR: return "scalar";
+        case SENSOR_CONVERT_SSE2:   return "sse2";
+        case SENSOR_CONVERT_AVX2:   return "avx2";
+        case SENSOR_CONVERT_NEON:   return "neon";
+        default:                    return "?";
+    }
+}
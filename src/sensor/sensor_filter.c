@@ -0,0 +1,395 @@
+/*
+    sensor_filter.c
+
+    Filtres en flux (entiers, sans allocation).
+
+    Seule la médiane sur 3 a un chemin SIMD : c'est le seul étage
+    sans récurrence d'un échantillon au suivant (MA, CIC et IIR
+    dépendent de la sortie ou de l'état précédent).
+*/
+
+#include "sensor/sensor_filter.h"
+#include <string.h> // memset
+
+#if defined(__SSE2__)
+#  include <emmintrin.h>
+#  define FILTER_HAVE_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define FILTER_HAVE_NEON 1
+#endif
+
+static int16_t saturate16(int64_t v)
+{
+    if (v > INT16_MAX)
+        return INT16_MAX;
+    if (v < INT16_MIN)
+        return INT16_MIN;
+    return (int16_t)v;
+}
+
+/*
+    Division arrondie au plus proche (symétrique autour de 0).
+*/
+static int32_t div_round(int32_t num, int32_t den)
+{
+    return (num >= 0) ? (num + den / 2) / den
+                      : -((-num + den / 2) / den);
+}
+
+static int16_t med3(int16_t a, int16_t b, int16_t c)
+{
+    int16_t lo = (a < b) ? a : b;
+    int16_t hi = (a < b) ? b : a;
+    int16_t m = (hi < c) ? hi : c;
+    return (lo > m) ? lo : m;
+}
+
+/* ---------------- Moyenne glissante ---------------- */
+
+static size_t ma_process(sensor_filter_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    uint8_t len = f->u.ma.len;
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t x = in[i];
+
+        if (!f->primed) {
+            for (uint8_t k = 0; k < len; k++) {
+                f->u.ma.hist[k] = x;
+            }
+            f->u.ma.sum = (int32_t)x * len;
+            f->u.ma.pos = 0;
+            f->primed = 1;
+        }
+
+        f->u.ma.sum += x - f->u.ma.hist[f->u.ma.pos];
+        f->u.ma.hist[f->u.ma.pos] = x;
+        f->u.ma.pos = (uint8_t)((f->u.ma.pos + 1 == len) ? 0 : f->u.ma.pos + 1);
+
+        out[i] = (int16_t)div_round(f->u.ma.sum, len);
+    }
+
+    return n;
+}
+
+/* ---------------- CIC ---------------- */
+
+/*
+    Une entrée dans la cascade d'intégrateurs.
+    Retourne 1 (et *y) quand une sortie décimée est produite.
+*/
+static int cic_push(sensor_filter_t *f, int16_t x, int16_t *y)
+{
+    uint8_t order = f->u.cic.order;
+    uint64_t v = (uint64_t)(int64_t)x;
+
+    for (uint8_t k = 0; k < order; k++) {
+        f->u.cic.integ[k] += v;
+        v = f->u.cic.integ[k];
+    }
+
+    if (++f->u.cic.phase < f->u.cic.ratio)
+        return 0;
+
+    f->u.cic.phase = 0;
+
+    // Peignes (retard différentiel 1), à la cadence décimée
+    for (uint8_t k = 0; k < order; k++) {
+        uint64_t prev = f->u.cic.comb[k];
+        f->u.cic.comb[k] = v;
+        v -= prev;
+    }
+
+    // Gain R^N = 2^shift, arrondi au plus proche
+    int64_t acc = (int64_t)v;
+    acc = (acc + ((int64_t)1 << (f->u.cic.shift - 1))) >> f->u.cic.shift;
+    *y = saturate16(acc);
+    return 1;
+}
+
+static size_t cic_process(sensor_filter_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    size_t n_out = 0;
+
+    if (!f->primed && n > 0) {
+        // Amorçage : N * R entrées égales au premier échantillon
+        // amènent la cascade en régime établi
+        int16_t dummy;
+        for (uint32_t k = 0; k < (uint32_t)f->u.cic.order * f->u.cic.ratio; k++) {
+            cic_push(f, in[0], &dummy);
+        }
+        f->primed = 1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t y;
+        if (cic_push(f, in[i], &y)) {
+            out[n_out++] = y; // n_out <= i : sûr en place
+        }
+    }
+
+    return n_out;
+}
+
+/* ---------------- IIR 1er ordre ---------------- */
+
+static size_t iir_process(sensor_filter_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    uint8_t shift = f->u.iir.shift;
+    int32_t state = f->u.iir.state;
+
+    if (!f->primed && n > 0) {
+        state = (int32_t)in[0] * 65536;
+        f->primed = 1;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        int64_t err = (int64_t)in[i] * 65536 - state;
+        state += (int32_t)(err >> shift);
+        out[i] = (int16_t)((state + 32768) >> 16);
+    }
+
+    f->u.iir.state = state;
+    return n;
+}
+
+/* ---------------- Médiane ---------------- */
+
+/*
+    Fenêtre de 3 : win[0] = x[i-2], win[1] = x[i-1].
+    Par blocs de 8 : med3 = max(min(a, b), min(max(a, b), c)).
+*/
+static size_t median3_process(sensor_filter_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    if (!f->primed && n > 0) {
+        f->u.med.win[0] = in[0];
+        f->u.med.win[1] = in[0];
+        f->primed = 1;
+    }
+
+    int16_t a = f->u.med.win[0];
+    int16_t b = f->u.med.win[1];
+    size_t i = 0;
+
+#if defined(FILTER_HAVE_SSE2)
+    if (n >= 8) {
+        __m128i prev = _mm_set_epi16(b, a, 0, 0, 0, 0, 0, 0);
+
+        for (; i + 8 <= n; i += 8) {
+            __m128i c  = _mm_loadu_si128((const __m128i *)(in + i));
+            __m128i x2 = _mm_or_si128(_mm_srli_si128(prev, 12), _mm_slli_si128(c, 4));
+            __m128i x1 = _mm_or_si128(_mm_srli_si128(prev, 14), _mm_slli_si128(c, 2));
+            __m128i m  = _mm_max_epi16(_mm_min_epi16(x2, x1),
+                                       _mm_min_epi16(_mm_max_epi16(x2, x1), c));
+            _mm_storeu_si128((__m128i *)(out + i), m);
+            prev = c; // entrée brute gardée : sûr en place
+        }
+
+        a = (int16_t)_mm_extract_epi16(prev, 6);
+        b = (int16_t)_mm_extract_epi16(prev, 7);
+    }
+#elif defined(FILTER_HAVE_NEON)
+    if (n >= 8) {
+        const int16_t init[8] = { 0, 0, 0, 0, 0, 0, a, b };
+        int16x8_t prev = vld1q_s16(init);
+
+        for (; i + 8 <= n; i += 8) {
+            int16x8_t c  = vld1q_s16(in + i);
+            int16x8_t x2 = vextq_s16(prev, c, 6);
+            int16x8_t x1 = vextq_s16(prev, c, 7);
+            int16x8_t m  = vmaxq_s16(vminq_s16(x2, x1),
+                                     vminq_s16(vmaxq_s16(x2, x1), c));
+            vst1q_s16(out + i, m);
+            prev = c;
+        }
+
+        a = vgetq_lane_s16(prev, 6);
+        b = vgetq_lane_s16(prev, 7);
+    }
+#endif
+
+    for (; i < n; i++) {
+        int16_t c = in[i];
+        out[i] = med3(a, b, c);
+        a = b;
+        b = c;
+    }
+
+    f->u.med.win[0] = a;
+    f->u.med.win[1] = b;
+    return n;
+}
+
+/*
+    Fenêtre 5 ou 7 : tri par insertion d'une copie de la fenêtre.
+*/
+static size_t median_process(sensor_filter_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    uint8_t len = f->u.med.len;
+
+    if (len == 3)
+        return median3_process(f, in, out, n);
+
+    for (size_t i = 0; i < n; i++) {
+        int16_t x = in[i];
+
+        if (!f->primed) {
+            for (uint8_t k = 0; k < len; k++) {
+                f->u.med.win[k] = x;
+            }
+            f->u.med.pos = 0;
+            f->primed = 1;
+        }
+
+        f->u.med.win[f->u.med.pos] = x;
+        f->u.med.pos = (uint8_t)((f->u.med.pos + 1 == len) ? 0 : f->u.med.pos + 1);
+
+        // Mis à zéro : GCC -O2 ne voit pas que tmp[len / 2] est toujours écrit
+        int16_t tmp[SENSOR_FILTER_MEDIAN_MAX] = {0};
+        for (uint8_t k = 0; k < len; k++) {
+            int16_t v = f->u.med.win[k];
+            uint8_t j = k;
+            while (j > 0 && tmp[j - 1] > v) {
+                tmp[j] = tmp[j - 1];
+                j--;
+            }
+            tmp[j] = v;
+        }
+
+        out[i] = tmp[len / 2];
+    }
+
+    return n;
+}
+
+/* ---------------- Initialisation ---------------- */
+
+sensor_status_t sensor_filter_init_ma(sensor_filter_t *f, uint8_t len)
+{
+    if (!f || len == 0 || len > SENSOR_FILTER_MA_MAX)
+        return SENSOR_ERR;
+
+    memset(f, 0, sizeof(*f));
+    f->kind = SENSOR_FILTER_MA;
+    f->u.ma.len = len;
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_filter_init_cic(sensor_filter_t *f, uint8_t order, uint16_t ratio)
+{
+    if (!f || order == 0 || order > SENSOR_FILTER_CIC_MAX_ORDER)
+        return SENSOR_ERR;
+
+    // ratio puissance de 2 : le gain R^N se compense par un décalage
+    if (ratio < 2 || (ratio & (ratio - 1)) != 0)
+        return SENSOR_ERR;
+
+    uint8_t log2r = 0;
+    while ((1u << log2r) < ratio) {
+        log2r++;
+    }
+
+    if (order * log2r > SENSOR_FILTER_CIC_MAX_BITS)
+        return SENSOR_ERR;
+
+    memset(f, 0, sizeof(*f));
+    f->kind = SENSOR_FILTER_CIC;
+    f->u.cic.order = order;
+    f->u.cic.ratio = ratio;
+    f->u.cic.shift = (uint8_t)(order * log2r);
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_filter_init_iir1(sensor_filter_t *f, uint8_t shift)
+{
+    if (!f || shift == 0 || shift > 15)
+        return SENSOR_ERR;
+
+    memset(f, 0, sizeof(*f));
+    f->kind = SENSOR_FILTER_IIR1;
+    f->u.iir.shift = shift;
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_filter_init_median(sensor_filter_t *f, uint8_t len)
+{
+    if (!f || len < 3 || len > SENSOR_FILTER_MEDIAN_MAX || (len & 1) == 0)
+        return SENSOR_ERR;
+
+    memset(f, 0, sizeof(*f));
+    f->kind = SENSOR_FILTER_MEDIAN;
+    f->u.med.len = len;
+    return SENSOR_OK;
+}
+
+void sensor_filter_reset(sensor_filter_t *f)
+{
+    if (!f)
+        return;
+
+    f->primed = 0;
+
+    if (f->kind == SENSOR_FILTER_CIC) {
+        memset(f->u.cic.integ, 0, sizeof(f->u.cic.integ));
+        memset(f->u.cic.comb, 0, sizeof(f->u.cic.comb));
+        f->u.cic.phase = 0;
+    }
+}
+
+size_t sensor_filter_process(
+    sensor_filter_t *f,
+    const int16_t *in,
+    int16_t *out,
+    size_t n
+)
+{
+    if (!f || !in || !out)
+        return 0;
+
+    switch (f->kind) {
+        case SENSOR_FILTER_MA:     return ma_process(f, in, out, n);
+        case SENSOR_FILTER_CIC:    return cic_process(f, in, out, n);
+        case SENSOR_FILTER_IIR1:   return iir_process(f, in, out, n);
+        case SENSOR_FILTER_MEDIAN: return median_process(f, in, out, n);
+        default:                   return 0;
+    }
+}
+
+/* ---------------- Pipeline ---------------- */
+
+sensor_status_t sensor_pipeline_init(
+    sensor_pipeline_t *p,
+    sensor_filter_t *stages,
+    size_t n_stages
+)
+{
+    if (!p || (!stages && n_stages > 0))
+        return SENSOR_ERR;
+
+    p->stages = stages;
+    p->n_stages = n_stages;
+    return SENSOR_OK;
+}
+
+size_t sensor_pipeline_process(sensor_pipeline_t *p, int16_t *buf, size_t n)
+{
+    if (!p || !buf)
+        return 0;
+
+    for (size_t k = 0; k < p->n_stages && n > 0; k++) {
+        n = sensor_filter_process(&p->stages[k], buf, buf, n);
+    }
+
+    return n;
+}
+
+void sensor_pipeline_reset(sensor_pipeline_t *p)
+{
+    if (!p)
+        return;
+
+    for (size_t k = 0; k < p->n_stages; k++) {
+        sensor_filter_reset(&p->stages[k]);
+    }
+}
@@ -0,0 +1,139 @@
+/*
+    sensor_op.c
+
+    Machines à états des opérations non bloquantes.
+
+    Les accès bus réutilisent l'API bloquante (sensor_get_id,
+    sensor_read_temperature_centi) : seules les ATTENTES sont rendues
+    à l'appelant, sous forme de SENSOR_PENDING + wake_at_us.
+*/
+
+#include "sensor/sensor_op.h"
+#include "hal/hal_bind.h"
+
+/*
+    États internes de l'init.
+*/
+enum {
+    INIT_READ_ID = 0,
+    INIT_SETTLE,
+    OP_DONE = 0xFF
+};
+
+/*
+    Prépare une opération (commun à tous les start()).
+*/
+static sensor_status_t op_start(sensor_op_t *op, sensor_t *s, sensor_op_kind_t kind)
+{
+    if (!op || !s)
+        return SENSOR_ERR;
+
+    op->s = s;
+    op->kind = kind;
+    op->state = 0;
+    op->wake_at_us = 0;
+    op->result = SENSOR_PENDING;
+    op->id = 0;
+    op->temp_centi = 0;
+
+    return SENSOR_PENDING;
+}
+
+/*
+    Termine l'opération avec le statut st.
+*/
+static sensor_status_t op_finish(sensor_op_t *op, sensor_status_t st)
+{
+    op->state = OP_DONE;
+    op->result = st;
+    return st;
+}
+
+sensor_status_t sensor_init_start(
+    sensor_op_t *op,
+    sensor_t *s,
+    uint8_t dev_addr,
+    const hal_bus_t *bus,
+    const hal_time_t *time,
+    const hal_log_t *log
+)
+{
+    // op vérifié d'abord : rien n'est écrit si refusé
+    if (!op || sensor_bind(s, dev_addr, bus, time, log) != SENSOR_OK)
+        return SENSOR_ERR;
+
+    return op_start(op, s, SENSOR_OP_INIT);
+}
+
+sensor_status_t sensor_get_id_start(sensor_op_t *op, sensor_t *s)
+{
+    return op_start(op, s, SENSOR_OP_GET_ID);
+}
+
+sensor_status_t sensor_read_temperature_start(sensor_op_t *op, sensor_t *s)
+{
+    return op_start(op, s, SENSOR_OP_READ_TEMP);
+}
+
+/*
+    Étape de l'init :
+    - INIT_READ_ID : lit et vérifie l'ID, puis programme la fin du délai
+    - INIT_SETTLE  : attend wake_at_us
+*/
+static sensor_status_t step_init(sensor_op_t *op, uint64_t now_us)
+{
+    sensor_t *s = op->s;
+
+    switch (op->state) {
+        case INIT_READ_ID:
+            if (sensor_get_id(s, &op->id) != SENSOR_OK)
+                return op_finish(op, SENSOR_ERR);
+
+            if (op->id != SENSOR_EXPECTED_ID) {
+                HAL_LOGE(s->log, "sensor 0x%02X: bad id 0x%02X (expected 0x%02X)",
+                         s->dev_addr, op->id, SENSOR_EXPECTED_ID);
+                return op_finish(op, SENSOR_BAD_ID);
+            }
+
+            op->wake_at_us = now_us + (uint64_t)SENSOR_INIT_DELAY_MS * 1000u;
+            op->state = INIT_SETTLE;
+            return SENSOR_PENDING;
+
+        case INIT_SETTLE:
+            if (now_us < op->wake_at_us)
+                return SENSOR_PENDING;
+
+            HAL_LOGI(s->log, "sensor 0x%02X: init ok", s->dev_addr);
+            return op_finish(op, SENSOR_OK);
+
+        default:
+            return op_finish(op, SENSOR_ERR);
+    }
+}
+
+sensor_status_t sensor_op_step(sensor_op_t *op, uint64_t now_us)
+{
+    if (!op || !op->s)
+        return SENSOR_ERR;
+
+    if (op->state == OP_DONE)
+        return op->result;
+
+    // Trop tôt : rien à faire
+    if (now_us < op->wake_at_us)
+        return SENSOR_PENDING;
+
+    switch (op->kind) {
+        case SENSOR_OP_INIT:
+            return step_init(op, now_us);
+
+        case SENSOR_OP_GET_ID:
+            return op_finish(op, sensor_get_id(op->s, &op->id));
+
+        case SENSOR_OP_READ_TEMP:
+            return op_finish(op, sensor_read_temperature_centi(op->s, &op->temp_centi));
+
+        default:
+            return op_finish(op, SENSOR_ERR);
+    }
+}
@@ -0,0 +1,109 @@
+/*
+    sensor_ring.c
+
+    File SPSC lock-free d'échantillons.
+
+    Ordonnancement mémoire :
+    - le producteur écrit l'échantillon, PUIS publie head (release)
+    - le consommateur lit head (acquire), copie, PUIS publie tail (release)
+    -> chaque côté voit les données de l'autre complètement écrites.
+*/
+
+#include "sensor/sensor_ring.h"
+
+sensor_status_t sensor_ring_init(
+    sensor_ring_t *ring,
+    sensor_sample_t *buf,
+    size_t capacity
+)
+{
+    // Puissance de 2 obligatoire (index par masque)
+    if (!ring || !buf || capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return SENSOR_ERR;
+
+    ring->buf = buf;
+    ring->mask = capacity - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->dropped, 0);
+    ring->tail_cache = 0;
+    ring->head_cache = 0;
+
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_ring_push(
+    sensor_ring_t *ring,
+    const sensor_sample_t *sample
+)
+{
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // Pleine selon la copie locale ? On relit le vrai tail.
+    if (head - ring->tail_cache > ring->mask) {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        if (head - ring->tail_cache > ring->mask) {
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            return SENSOR_ERR;
+        }
+    }
+
+    ring->buf[head & ring->mask] = *sample;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return SENSOR_OK;
+}
+
+size_t sensor_ring_pop_batch(
+    sensor_ring_t *ring,
+    sensor_sample_t *out,
+    size_t max
+)
+{
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    // Vide selon la copie locale ? On relit le vrai head.
+    if (ring->head_cache - tail < max) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+    }
+
+    size_t n = ring->head_cache - tail;
+    if (n > max)
+        n = max;
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = ring->buf[(tail + i) & ring->mask];
+    }
+
+    if (n > 0)
+        atomic_store_explicit(&ring->tail, tail + n, memory_order_release);
+
+    return n;
+}
+
+uint64_t sensor_ring_dropped(const sensor_ring_t *ring)
+{
+    // atomic_load sur un pointeur const : cast explicite
+    return atomic_load_explicit((_Atomic uint64_t *)&ring->dropped, memory_order_relaxed);
+}
+
+sensor_status_t sensor_read_to_ring(
+    sensor_t *s,
+    sensor_ring_t *ring,
+    uint32_t sensor_id,
+    uint64_t t_us
+)
+{
+    if (!ring)
+        return SENSOR_ERR;
+
+    sensor_sample_t sample = {0};
+
+    if (sensor_read_temperature_centi(s, &sample.value) != SENSOR_OK)
+        return SENSOR_ERR;
+
+    sample.t_us = t_us;
+    sample.sensor_id = sensor_id;
+
+    return sensor_ring_push(ring, &sample);
+}
@@ -0,0 +1,196 @@
+/*
+    sensor_rollup.c
+
+    Agrégats multi-résolution à buckets adressés directement.
+*/
+
+#include "sensor/sensor_rollup.h"
+#include <string.h> // memset
+
+sensor_status_t sensor_rollup_init(sensor_rollup_t *r)
+{
+    if (!r)
+        return SENSOR_ERR;
+
+    memset(r, 0, sizeof(*r));
+    return SENSOR_OK;
+}
+
+sensor_status_t sensor_rollup_add_tier(
+    sensor_rollup_t *r,
+    uint64_t res_us,
+    sensor_bucket_t *buckets,
+    uint32_t cap
+)
+{
+    if (!r || !buckets || cap == 0 || res_us == 0 || r->n_tiers >= SENSOR_ROLLUP_MAX_TIERS)
+        return SENSOR_ERR;
+
+    if (r->n_tiers > 0 && res_us <= r->tiers[r->n_tiers - 1].res_us)
+        return SENSOR_ERR;
+
+    memset(buckets, 0, (size_t)cap * sizeof(*buckets));
+
+    sensor_rollup_tier_t *tier = &r->tiers[r->n_tiers++];
+    tier->res_us = res_us;
+    tier->buckets = buckets;
+    tier->cap = cap;
+    return SENSOR_OK;
+}
+
+void sensor_rollup_add(sensor_rollup_t *r, uint64_t t_us, int16_t value)
+{
+    if (!r)
+        return;
+
+    for (uint8_t k = 0; k < r->n_tiers; k++) {
+        const sensor_rollup_tier_t *tier = &r->tiers[k];
+        uint64_t idx = t_us / tier->res_us;
+        uint64_t start = idx * tier->res_us;
+        sensor_bucket_t *b = &tier->buckets[idx % tier->cap];
+
+        if (b->count == 0 || b->t_start_us < start) {
+            // Nouvel intervalle : recyclage du bucket
+            b->t_start_us = start;
+            b->sum = value;
+            b->count = 1;
+            b->min = value;
+            b->max = value;
+        } else if (b->t_start_us == start) {
+            b->sum += value;
+            b->count++;
+            if (value < b->min) b->min = value;
+            if (value > b->max) b->max = value;
+        } else {
+            // Plus ancien que la rétention de ce niveau
+            r->late_drops++;
+        }
+    }
+
+    if (t_us > r->t_last_us)
+        r->t_last_us = t_us;
+}
+
+void sensor_rollup_feed(
+    sensor_rollup_t *by_id,
+    size_t n_ids,
+    const sensor_sample_t *samples,
+    size_t n
+)
+{
+    if (!by_id || !samples)
+        return;
+
+    for (size_t i = 0; i < n; i++) {
+        if (samples[i].sensor_id < n_ids)
+            sensor_rollup_add(&by_id[samples[i].sensor_id], samples[i].t_us, samples[i].value);
+    }
+}
+
+sensor_status_t sensor_rollup_bucket(
+    const sensor_rollup_t *r,
+    uint8_t tier,
+    uint64_t t_us,
+    sensor_bucket_t *out
+)
+{
+    if (!r || !out || tier >= r->n_tiers)
+        return SENSOR_ERR;
+
+    const sensor_rollup_tier_t *tr = &r->tiers[tier];
+    uint64_t idx = t_us / tr->res_us;
+    const sensor_bucket_t *b = &tr->buckets[idx % tr->cap];
+
+    if (b->count == 0 || b->t_start_us != idx * tr->res_us)
+        return SENSOR_ERR;
+
+    *out = *b;
+    return SENSOR_OK;
+}
+
+/*
+    Vrai si le niveau garde encore le bucket de t_us.
+*/
+static int tier_covers(const sensor_rollup_t *r, const sensor_rollup_tier_t *tier, uint64_t t_us)
+{
+    if (t_us >= r->t_last_us)
+        return 1;
+
+    return (r->t_last_us / tier->res_us) - (t_us / tier->res_us) < tier->cap;
+}
+
+static uint8_t pick_tier(const sensor_rollup_t *r, uint64_t t_begin_us, uint64_t t_end_us)
+{
+    uint64_t span = t_end_us - t_begin_us;
+
+    // Le plus grossier qui couvre et donne assez de buckets
+    for (int k = (int)r->n_tiers - 1; k >= 0; k--) {
+        const sensor_rollup_tier_t *tier = &r->tiers[k];
+        if (tier_covers(r, tier, t_begin_us) &&
+            span / tier->res_us >= SENSOR_ROLLUP_QUERY_MIN_BUCKETS)
+            return (uint8_t)k;
+    }
+
+    // Plage courte : le plus fin qui couvre
+    for (uint8_t k = 0; k < r->n_tiers; k++) {
+        if (tier_covers(r, &r->tiers[k], t_begin_us))
+            return k;
+    }
+
+    return (uint8_t)(r->n_tiers - 1);
+}
+
+sensor_status_t sensor_rollup_query(
+    const sensor_rollup_t *r,
+    uint64_t t_begin_us,
+    uint64_t t_end_us,
+    sensor_rollup_stat_t *out
+)
+{
+    if (!r || !out || r->n_tiers == 0 || t_end_us <= t_begin_us)
+        return SENSOR_ERR;
+
+    memset(out, 0, sizeof(*out));
+
+    uint8_t k = pick_tier(r, t_begin_us, t_end_us);
+    const sensor_rollup_tier_t *tier = &r->tiers[k];
+
+    uint64_t idx_first = t_begin_us / tier->res_us;
+    uint64_t idx_last = (t_end_us - 1) / tier->res_us;
+    uint64_t idx_newest = r->t_last_us / tier->res_us;
+
+    // Au plus cap buckets : ceux que le niveau peut encore contenir
+    if (idx_last > idx_newest)
+        idx_last = idx_newest;
+    if (idx_newest >= tier->cap && idx_first < idx_newest - tier->cap + 1)
+        idx_first = idx_newest - tier->cap + 1;
+
+    out->tier = k;
+    out->t_begin_us = idx_first * tier->res_us;
+    out->t_end_us = (idx_last + 1) * tier->res_us;
+    out->min = INT16_MAX;
+    out->max = INT16_MIN;
+
+    for (uint64_t idx = idx_first; idx <= idx_last; idx++) {
+        const sensor_bucket_t *b = &tier->buckets[idx % tier->cap];
+
+        if (b->count == 0 || b->t_start_us != idx * tier->res_us)
+            continue;
+
+        out->count += b->count;
+        out->sum += b->sum;
+        if (b->min < out->min) out->min = b->min;
+        if (b->max > out->max) out->max = b->max;
+    }
+
+    if (out->count == 0) {
+        out->min = 0;
+        out->max = 0;
+        return SENSOR_OK;
+    }
+
+    int64_t c = (int64_t)out->count;
+    out->mean = (int16_t)((out->sum >= 0) ? (out->sum + c / 2) / c
+                                          : -((-out->sum + c / 2) / c));
+    return SENSOR_OK;
+}
@@ -0,0 +1,478 @@
+/*
+    store.c
+
+    Segments mappés en ajout seul + dossier de segments (POSIX).
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "store/store.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>     // snprintf, sscanf
+#include <sys/types.h> // ssize_t
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static size_t page_size(void)
+{
+    long p = sysconf(_SC_PAGESIZE);
+    return (p > 0) ? (size_t)p : 4096u;
+}
+
+static uint64_t round_up(uint64_t v, uint64_t align)
+{
+    return (v + align - 1) / align * align;
+}
+
+static void seg_reset(store_segment_t *seg)
+{
+    memset(seg, 0, sizeof(*seg));
+    seg->fd = -1;
+}
+
+/*
+    Pointeurs vers l'index et les enregistrements dans le mapping.
+*/
+static void seg_bind(store_segment_t *seg)
+{
+    seg->hdr = (store_header_t *)seg->map;
+    seg->index = (store_index_entry_t *)(seg->map + seg->hdr->index_offset);
+    seg->records = (sensor_sample_t *)(seg->map + seg->hdr->records_offset);
+}
+
+/* ---------------- Segment ---------------- */
+
+sensor_status_t store_segment_create(
+    store_segment_t *seg,
+    const char *path,
+    uint64_t capacity
+)
+{
+    if (!seg || !path || capacity == 0)
+        return SENSOR_ERR;
+
+    seg_reset(seg);
+
+    uint64_t page = page_size();
+    uint64_t n_index = (capacity + STORE_INDEX_STRIDE - 1) / STORE_INDEX_STRIDE;
+    uint64_t index_offset = round_up(sizeof(store_header_t), page);
+    uint64_t records_offset = round_up(index_offset + n_index * sizeof(store_index_entry_t), page);
+    uint64_t size = records_offset + capacity * sizeof(sensor_sample_t);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+        return SENSOR_ERR;
+
+    // Fichier creux : les pages ne sont allouées qu'à l'écriture
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        unlink(path);
+        return SENSOR_ERR;
+    }
+
+    void *map = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        unlink(path);
+        return SENSOR_ERR;
+    }
+
+    seg->fd = fd;
+    seg->writable = 1;
+    seg->map = (uint8_t *)map;
+    seg->map_size = (size_t)size;
+
+    store_header_t *h = (store_header_t *)map;
+    h->version = STORE_VERSION;
+    h->record_size = sizeof(sensor_sample_t);
+    h->capacity = capacity;
+    h->index_stride = STORE_INDEX_STRIDE;
+    h->index_offset = index_offset;
+    h->records_offset = records_offset;
+    atomic_store_explicit(&h->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->t_min, UINT64_MAX, memory_order_relaxed);
+    atomic_store_explicit(&h->t_max, 0, memory_order_relaxed);
+
+    // Magic en dernier : un en-tête incomplet n'est jamais reconnu
+    atomic_thread_fence(memory_order_release);
+    memcpy(h->magic, STORE_MAGIC, sizeof(h->magic));
+
+    seg_bind(seg);
+    return SENSOR_OK;
+}
+
+sensor_status_t store_segment_open(
+    store_segment_t *seg,
+    const char *path,
+    int writable
+)
+{
+    if (!seg || !path)
+        return SENSOR_ERR;
+
+    seg_reset(seg);
+
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0)
+        return SENSOR_ERR;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(store_header_t)) {
+        close(fd);
+        return SENSOR_ERR;
+    }
+
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *map = mmap(NULL, (size_t)st.st_size, prot, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        close(fd);
+        return SENSOR_ERR;
+    }
+
+    seg->fd = fd;
+    seg->writable = writable;
+    seg->map = (uint8_t *)map;
+    seg->map_size = (size_t)st.st_size;
+
+    // Validation de l'en-tête contre la taille réelle du fichier
+    const store_header_t *h = (const store_header_t *)map;
+    uint64_t n_index = (h->capacity + STORE_INDEX_STRIDE - 1) / STORE_INDEX_STRIDE;
+    int ok = memcmp(h->magic, STORE_MAGIC, sizeof(h->magic)) == 0
+          && h->version == STORE_VERSION
+          && h->record_size == sizeof(sensor_sample_t)
+          && h->index_stride == STORE_INDEX_STRIDE
+          && h->capacity > 0
+          && h->index_offset + n_index * sizeof(store_index_entry_t) <= h->records_offset
+          && h->records_offset + h->capacity * sizeof(sensor_sample_t) <= seg->map_size
+          && atomic_load_explicit(&h->count, memory_order_acquire) <= h->capacity;
+
+    if (!ok) {
+        store_segment_close(seg);
+        return SENSOR_ERR;
+    }
+
+    seg_bind(seg);
+    return SENSOR_OK;
+}
+
+void store_segment_close(store_segment_t *seg)
+{
+    if (!seg)
+        return;
+
+    if (seg->map)
+        munmap(seg->map, seg->map_size);
+    if (seg->fd >= 0)
+        close(seg->fd);
+
+    seg_reset(seg);
+}
+
+static void atomic_min_relaxed(_Atomic uint64_t *v, uint64_t x)
+{
+    // Un seul écrivain : pas besoin de compare-exchange
+    if (x < atomic_load_explicit(v, memory_order_relaxed))
+        atomic_store_explicit(v, x, memory_order_relaxed);
+}
+
+static void atomic_max_relaxed(_Atomic uint64_t *v, uint64_t x)
+{
+    if (x > atomic_load_explicit(v, memory_order_relaxed))
+        atomic_store_explicit(v, x, memory_order_relaxed);
+}
+
+sensor_status_t store_segment_append(
+    store_segment_t *seg,
+    const sensor_sample_t *sample
+)
+{
+    if (!seg || !seg->map || !seg->writable || !sample)
+        return SENSOR_ERR;
+
+    store_header_t *h = seg->hdr;
+    uint64_t n = atomic_load_explicit(&h->count, memory_order_relaxed);
+
+    if (n >= h->capacity)
+        return SENSOR_ERR;
+
+    seg->records[n] = *sample;
+
+    // Index creux : première entrée d'un bloc -> bornes réinitialisées
+    store_index_entry_t *e = &seg->index[n / STORE_INDEX_STRIDE];
+    if (n % STORE_INDEX_STRIDE == 0) {
+        atomic_store_explicit(&e->t_min, sample->t_us, memory_order_relaxed);
+        atomic_store_explicit(&e->t_max, sample->t_us, memory_order_relaxed);
+    } else {
+        atomic_min_relaxed(&e->t_min, sample->t_us);
+        atomic_max_relaxed(&e->t_max, sample->t_us);
+    }
+
+    atomic_min_relaxed(&h->t_min, sample->t_us);
+    atomic_max_relaxed(&h->t_max, sample->t_us);
+
+    // Publication : tout ce qui précède est visible avant le compteur
+    atomic_store_explicit(&h->count, n + 1, memory_order_release);
+    return SENSOR_OK;
+}
+
+sensor_status_t store_segment_sync(store_segment_t *seg)
+{
+    if (!seg || !seg->map)
+        return SENSOR_ERR;
+
+    return (msync(seg->map, seg->map_size, MS_SYNC) == 0) ? SENSOR_OK : SENSOR_ERR;
+}
+
+uint64_t store_segment_count(const store_segment_t *seg)
+{
+    if (!seg || !seg->hdr)
+        return 0;
+
+    return atomic_load_explicit(&seg->hdr->count, memory_order_acquire);
+}
+
+/* ---------------- Itérateur ---------------- */
+
+void store_iter_init(
+    store_iter_t *it,
+    const store_segment_t *seg,
+    uint64_t t_begin,
+    uint64_t t_end
+)
+{
+    if (!it)
+        return;
+
+    it->seg = seg;
+    it->t_begin = t_begin;
+    it->t_end = t_end;
+    it->pos = 0;
+    it->count = store_segment_count(seg);
+}
+
+const sensor_sample_t *store_iter_next(store_iter_t *it)
+{
+    if (!it || !it->seg || !it->seg->map)
+        return NULL;
+
+    const store_segment_t *seg = it->seg;
+
+    while (it->pos < it->count) {
+        // Début de bloc : saut complet si ses bornes sont hors plage
+        if (it->pos % STORE_INDEX_STRIDE == 0) {
+            store_index_entry_t *e = &seg->index[it->pos / STORE_INDEX_STRIDE];
+            uint64_t lo = atomic_load_explicit(&e->t_min, memory_order_relaxed);
+            uint64_t hi = atomic_load_explicit(&e->t_max, memory_order_relaxed);
+
+            if (hi < it->t_begin || lo > it->t_end) {
+                it->pos += STORE_INDEX_STRIDE;
+                continue;
+            }
+        }
+
+        const sensor_sample_t *r = &seg->records[it->pos++];
+        if (r->t_us >= it->t_begin && r->t_us <= it->t_end)
+            return r;
+    }
+
+    return NULL;
+}
+
+/* ---------------- Dossier de segments ---------------- */
+
+static int seg_path(char *out, size_t cap, const char *dir, uint32_t no)
+{
+    int n = snprintf(out, cap, "%s/seg-%06u.tss", dir, (unsigned)no);
+    return n > 0 && (size_t)n < cap;
+}
+
+/*
+    Plus petit et plus grand numéro de segment présents.
+    Retourne 0 si le dossier n'en contient aucun.
+*/
+static int seg_range(const char *dir, uint32_t *lo, uint32_t *hi)
+{
+    DIR *d = opendir(dir);
+    if (!d)
+        return 0;
+
+    int found = 0;
+    struct dirent *ent;
+
+    while ((ent = readdir(d)) != NULL) {
+        unsigned no;
+        char tail;
+        if (sscanf(ent->d_name, "seg-%6u.ts%c", &no, &tail) != 2 || tail != 's')
+            continue;
+
+        if (!found || no < *lo) *lo = no;
+        if (!found || no > *hi) *hi = no;
+        found = 1;
+    }
+
+    closedir(d);
+    return found;
+}
+
+/*
+    Segment dont la création a été interrompue (crash entre open,
+    ftruncate et l'écriture du magic) : fichier trop court, ou sans
+    magic et sans enregistrement. Jamais publié, donc sans données.
+    Un fichier absent compte aussi (rien à reprendre).
+*/
+static int seg_torn(const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return errno == ENOENT;
+
+    store_header_t h;
+    ssize_t n = pread(fd, &h, sizeof(h), 0);
+    close(fd);
+
+    if (n < (ssize_t)sizeof(h))
+        return 1;
+
+    return memcmp(h.magic, STORE_MAGIC, sizeof(h.magic)) != 0
+        && atomic_load_explicit(&h.count, memory_order_relaxed) == 0;
+}
+
+sensor_status_t store_open(store_t *st, const char *dir, uint64_t seg_capacity)
+{
+    if (!st || !dir || seg_capacity == 0 || strlen(dir) + 16 >= STORE_PATH_MAX)
+        return SENSOR_ERR;
+
+    memset(st, 0, sizeof(*st));
+    seg_reset(&st->cur);
+    memcpy(st->dir, dir, strlen(dir) + 1);
+    st->seg_capacity = seg_capacity;
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+        return SENSOR_ERR;
+
+    char path[STORE_PATH_MAX];
+    uint32_t lo = 0, hi = 0;
+
+    // Reprise : ajout dans le dernier segment valide
+    if (seg_range(dir, &lo, &hi)) {
+        for (uint32_t no = hi; ; no--) {
+            st->seg_no = no;
+            if (!seg_path(path, sizeof(path), dir, no))
+                return SENSOR_ERR;
+            if (store_segment_open(&st->cur, path, 1) == SENSOR_OK)
+                return SENSOR_OK;
+
+            // Création interrompue : effacée, on reprend le précédent.
+            // Un segment corrompu AVEC données n'est jamais effacé.
+            if (!seg_torn(path) || (unlink(path) != 0 && errno != ENOENT))
+                return SENSOR_ERR;
+            if (no == lo)
+                break;
+        }
+
+        // Que des créations interrompues : on repart du plus ancien numéro
+        return store_segment_create(&st->cur, path, seg_capacity);
+    }
+
+    st->seg_no = 0;
+    if (!seg_path(path, sizeof(path), dir, 0))
+        return SENSOR_ERR;
+    return store_segment_create(&st->cur, path, seg_capacity);
+}
+
+sensor_status_t store_append(store_t *st, const sensor_sample_t *sample)
+{
+    if (!st || !st->cur.map)
+        return SENSOR_ERR;
+
+    // Segment plein : bascule sur le suivant.
+    // Le courant reste ouvert tant que le suivant n'existe pas :
+    // après un échec (disque plein...), l'ajout suivant réessaie.
+    if (store_segment_count(&st->cur) >= st->cur.hdr->capacity) {
+        char path[STORE_PATH_MAX];
+        store_segment_t next;
+
+        if (!seg_path(path, sizeof(path), st->dir, st->seg_no + 1))
+            return SENSOR_ERR;
+        if (store_segment_create(&next, path, st->seg_capacity) != SENSOR_OK)
+            return SENSOR_ERR;
+
+        store_segment_close(&st->cur);
+        st->cur = next;
+        st->seg_no++;
+    }
+
+    return store_segment_append(&st->cur, sample);
+}
+
+sensor_status_t store_sync(store_t *st)
+{
+    if (!st)
+        return SENSOR_ERR;
+
+    return store_segment_sync(&st->cur);
+}
+
+void store_close(store_t *st)
+{
+    if (!st)
+        return;
+
+    store_segment_close(&st->cur);
+}
+
+uint64_t store_scan(
+    const char *dir,
+    uint64_t t_begin,
+    uint64_t t_end,
+    store_visit_fn fn,
+    void *user
+)
+{
+    if (!dir || !fn)
+        return 0;
+
+    uint32_t lo = 0, hi = 0;
+    if (!seg_range(dir, &lo, &hi))
+        return 0;
+
+    uint64_t visited = 0;
+
+    for (uint64_t no = lo; no <= hi; no++) {
+        char path[STORE_PATH_MAX];
+        store_segment_t seg;
+
+        if (!seg_path(path, sizeof(path), dir, (uint32_t)no))
+            break;
+        if (store_segment_open(&seg, path, 0) != SENSOR_OK)
+            continue; // segment absent (rétention) ou invalide
+
+        // Compteur lu (acquire) avant les bornes : elles couvrent l'instantané
+        store_iter_t it;
+        store_iter_init(&it, &seg, t_begin, t_end);
+
+        uint64_t s_min = atomic_load_explicit(&seg.hdr->t_min, memory_order_relaxed);
+        uint64_t s_max = atomic_load_explicit(&seg.hdr->t_max, memory_order_relaxed);
+
+        if (s_max >= t_begin && s_min <= t_end) {
+            const sensor_sample_t *r;
+
+            while ((r = store_iter_next(&it)) != NULL) {
+                visited++;
+                if (!fn(r, user)) {
+                    store_segment_close(&seg);
+                    return visited;
+                }
+            }
+        }
+
+        store_segment_close(&seg);
+    }
+
+    return visited;
+}
@@ -0,0 +1,1221 @@
+/*
+    test_hal.c
+
+    Tests unitaires des implémentations HAL host (sans framework externe).
+
+    Objectifs :
+    - vérifier le bus asynchrone (pool, submit, callback, poll)
+    - vérifier la flotte creuse (copy-on-write, registres volatils, mémoire)
+    - vérifier le log asynchrone (décodage, plusieurs threads)
+    - vérifier les décorateurs et backends de bus (stats, trace, shm,
+      temps de fil, transferts vectorisés, bus partagé)
+*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>  // getpid, unlink, fork
+#include <sys/wait.h>
+#include <signal.h>  // kill
+#include <time.h>    // nanosleep
+
+#include "hal/hal_bus_fake.h"
+#include "hal/hal_bus_async_fake.h"
+#include "hal/hal_bus_fake_fleet.h"
+#include "hal/hal_bus_stats.h"
+#include "hal/hal_bus_trace.h"
+#include "hal/hal_bus_shm.h"
+#include "hal/hal_bus_timing.h"
+#include "hal/hal_bus_combine.h"
+#include "hal/hal_log_async.h"
+#include "hal/hal_time.h"
+#include "hal/hal_time_sim.h"
+#include "sensor/sensor_regmap.h"
+
+/* Petit utilitaire : compteur de tests */
+static int g_tests_run = 0;
+static int g_tests_failed = 0;
+
+/*
+    Macro d'assertion minimaliste (même principe que test_sensor.c).
+*/
+#define TEST_ASSERT(cond) do {                                      \
+    g_tests_run++;                                                  \
+    if (!(cond)) {                                                  \
+        g_tests_failed++;                                           \
+        printf("[FAIL] %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+    }                                                               \
+} while (0)
+
+#define REG_WHO_AM_I  SENSOR_REG_WHO_AM_I
+#define REG_TEMP_MSB  SENSOR_REG_TEMP_MSB
+#define EXPECTED_ID   0x42
+
+/*
+    Test 1 : plusieurs lectures en vol, récupérées par poll().
+*/
+static void test_async_poll(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    hal_bus_async_t async;
+    hal_bus_async_fake_ctx_t async_ctx;
+    TEST_ASSERT(hal_bus_async_fake_init(&async_ctx, &async, &bus) == HAL_OK);
+
+    enum { N = 8 };
+    uint8_t ids[N] = {0};
+
+    for (int i = 0; i < N; i++) {
+        hal_bus_xfer_t *x = async.xfer_alloc(async.ctx);
+        TEST_ASSERT(x != NULL);
+        if (!x) {
+            continue;
+        }
+        x->dir = HAL_XFER_READ;
+        x->dev_addr = 0x50;
+        x->reg = REG_WHO_AM_I;
+        x->data = &ids[i];
+        x->len = 1;
+        TEST_ASSERT(async.submit(async.ctx, x) == HAL_OK);
+    }
+
+    size_t completed = 0;
+    while (completed < N) {
+        hal_bus_xfer_t *done[N];
+        size_t n = async.poll(async.ctx, done, N, 1000);
+        TEST_ASSERT(n > 0);
+        if (n == 0) {
+            break;
+        }
+        for (size_t i = 0; i < n; i++) {
+            TEST_ASSERT(done[i]->status == HAL_OK);
+            async.xfer_free(async.ctx, done[i]);
+        }
+        completed += n;
+    }
+
+    for (int i = 0; i < N; i++) {
+        TEST_ASSERT(ids[i] == EXPECTED_ID);
+    }
+
+    hal_bus_async_fake_deinit(&async_ctx);
+    hal_bus_async_fake_deinit(&async_ctx); // second appel : sans effet
+}
+
+/*
+    Callback : compte les complétions.
+*/
+static atomic_int g_cb_count;
+
+static void on_write_done(hal_bus_xfer_t *x)
+{
+    if (x->status == HAL_OK) {
+        atomic_fetch_add(&g_cb_count, 1);
+    }
+}
+
+/*
+    Test 2 : les écritures avec callback ne passent pas par poll(),
+    mais deinit() exécute tout ce qui a été soumis.
+*/
+static void test_async_callback(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    hal_bus_async_t async;
+    hal_bus_async_fake_ctx_t async_ctx;
+    TEST_ASSERT(hal_bus_async_fake_init(&async_ctx, &async, &bus) == HAL_OK);
+
+    atomic_store(&g_cb_count, 0);
+
+    uint8_t values[4] = {0x11, 0x22, 0x33, 0x44};
+    for (int i = 0; i < 4; i++) {
+        hal_bus_xfer_t *x = async.xfer_alloc(async.ctx);
+        TEST_ASSERT(x != NULL);
+        if (!x) {
+            continue;
+        }
+        x->dir = HAL_XFER_WRITE;
+        x->reg = (uint8_t)(0x30 + i);
+        x->data = &values[i];
+        x->len = 1;
+        x->on_done = on_write_done;
+        TEST_ASSERT(async.submit(async.ctx, x) == HAL_OK);
+    }
+
+    hal_bus_async_fake_deinit(&async_ctx);
+
+    TEST_ASSERT(atomic_load(&g_cb_count) == 4);
+    TEST_ASSERT(bus_ctx.regs[0x30] == 0x11);
+    TEST_ASSERT(bus_ctx.regs[0x33] == 0x44);
+}
+
+/*
+    Test 3 : le pool est borné.
+*/
+static void test_async_pool_exhausted(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    hal_bus_async_t async;
+    hal_bus_async_fake_ctx_t async_ctx;
+    TEST_ASSERT(hal_bus_async_fake_init(&async_ctx, &async, &bus) == HAL_OK);
+
+    hal_bus_xfer_t *all[HAL_BUS_ASYNC_FAKE_POOL_SIZE];
+    for (int i = 0; i < HAL_BUS_ASYNC_FAKE_POOL_SIZE; i++) {
+        all[i] = async.xfer_alloc(async.ctx);
+        TEST_ASSERT(all[i] != NULL);
+    }
+    TEST_ASSERT(async.xfer_alloc(async.ctx) == NULL);
+
+    async.xfer_free(async.ctx, all[0]);
+    TEST_ASSERT(async.xfer_alloc(async.ctx) == all[0]);
+
+    hal_bus_async_fake_deinit(&async_ctx);
+}
+
+/*
+    Test 4 : registres creux d'un capteur de la flotte.
+    Inline, puis page privée, sans toucher aux voisins.
+*/
+static void test_fleet_copy_on_write(void)
+{
+    hal_fake_model_t model;
+    hal_fake_model_init_default(&model);
+
+    hal_bus_fake_fleet_t fleet;
+    TEST_ASSERT(hal_bus_fake_fleet_init(&fleet, &model, 2, 8, 0x10) == HAL_OK);
+
+    hal_bus_t bus;
+    TEST_ASSERT(hal_bus_fake_fleet_bus(&fleet, 1, &bus) == HAL_OK);
+
+    uint8_t id = 0;
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x12, REG_WHO_AM_I, &id, 1) == HAL_OK);
+    TEST_ASSERT(id == EXPECTED_ID);
+
+    /* Quelques écritures : stockées inline */
+    uint8_t cfg[3] = {1, 2, 3};
+    TEST_ASSERT(bus.reg_write(bus.ctx, 0x12, 0x30, cfg, 3) == HAL_OK);
+    hal_fake_sparse_dev_t *dev = hal_bus_fake_fleet_dev(&fleet, 1, 0x12);
+    TEST_ASSERT(dev != NULL && dev->page == 0 && dev->n_inline == 3);
+    TEST_ASSERT(fleet.n_pages == 0);
+
+    /* Trop d'écritures : page privée */
+    uint8_t more[4] = {4, 5, 6, 7};
+    TEST_ASSERT(bus.reg_write(bus.ctx, 0x12, 0x33, more, 4) == HAL_OK);
+    TEST_ASSERT(dev->page != 0 && fleet.n_pages == 1);
+
+    uint8_t back[7] = {0};
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x12, 0x30, back, 7) == HAL_OK);
+    TEST_ASSERT(back[0] == 1 && back[3] == 4 && back[6] == 7);
+
+    /* Le voisin (même bus) et l'autre bus lisent toujours le modèle */
+    hal_bus_t bus0;
+    hal_bus_fake_fleet_bus(&fleet, 0, &bus0);
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x13, 0x30, back, 1) == HAL_OK && back[0] == 0);
+    TEST_ASSERT(bus0.reg_read(bus0.ctx, 0x12, 0x30, back, 1) == HAL_OK && back[0] == 0);
+
+    /* Registres volatils : générés, écriture ignorée */
+    uint8_t junk[2] = {0xFF, 0xFF};
+    bus.reg_write(bus.ctx, 0x14, REG_TEMP_MSB, junk, 2);
+    uint8_t t[2] = {0};
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x14, REG_TEMP_MSB, t, 2) == HAL_OK);
+    TEST_ASSERT((int16_t)((t[0] << 8) | t[1]) == 2505);
+    TEST_ASSERT(hal_bus_fake_fleet_dev(&fleet, 1, 0x14)->n_inline == 0);
+
+    /* Hors flotte : NACK */
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x18, REG_WHO_AM_I, &id, 1) == HAL_ERR);
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x0F, REG_WHO_AM_I, &id, 1) == HAL_ERR);
+    TEST_ASSERT(fleet.nack_count == 2);
+
+    hal_bus_fake_fleet_deinit(&fleet);
+}
+
+/*
+    Test 5 : un million de capteurs tient dans quelques dizaines de Mo
+    et répond sur tous les bus.
+*/
+static void test_fleet_million(void)
+{
+    hal_fake_model_t model;
+    hal_fake_model_init_default(&model);
+
+    enum { N_BUSES = 8192, DEVS_PER_BUS = 128 };
+
+    hal_bus_fake_fleet_t fleet;
+    TEST_ASSERT(hal_bus_fake_fleet_init(&fleet, &model, N_BUSES, DEVS_PER_BUS, 0) == HAL_OK);
+    TEST_ASSERT(sizeof(hal_fake_sparse_dev_t) == 16);
+    TEST_ASSERT(hal_bus_fake_fleet_memory(&fleet) < 32u * 1024u * 1024u);
+
+    int errors = 0;
+    for (uint32_t b = 0; b < N_BUSES; b++) {
+        hal_bus_t bus;
+        hal_bus_fake_fleet_bus(&fleet, b, &bus);
+        for (uint8_t a = 0; a < DEVS_PER_BUS; a++) {
+            uint8_t t[2];
+            if (bus.reg_read(bus.ctx, a, REG_TEMP_MSB, t, 2) != HAL_OK ||
+                (int16_t)((t[0] << 8) | t[1]) != 2505) {
+                errors++;
+            }
+        }
+    }
+    TEST_ASSERT(errors == 0);
+
+    hal_bus_fake_fleet_deinit(&fleet);
+}
+
+/*
+    Compte les lignes d'un fichier et copie la première dans first[].
+*/
+static int read_lines(FILE *f, char *first, size_t size)
+{
+    char line[256];
+    int n = 0;
+
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (n == 0 && first) {
+            snprintf(first, size, "%s", line);
+        }
+        n++;
+    }
+    return n;
+}
+
+/*
+    Test 6 : le rendu asynchrone est identique à printf.
+*/
+static void test_log_async_format(void)
+{
+    FILE *out = tmpfile();
+    FILE *err = tmpfile();
+    TEST_ASSERT(out && err);
+    if (!out || !err) {
+        return;
+    }
+
+    hal_log_t log;
+    hal_log_async_ctx_t log_ctx;
+    TEST_ASSERT(hal_log_async_init(&log_ctx, &log, out, err) == 0);
+
+    log.log(log.ctx, HAL_LOG_INFO, "id=0x%02X temp=%d.%02d %s %5.1f%% %hhu %lld %zu",
+            0x42, 25, 7, "ok", 99.5, 300, -5LL, (size_t)12);
+    log.log(log.ctx, HAL_LOG_ERR, "bus error %s at %*d", "NACK", 4, 7);
+    // Largeur '*' négative : alignement à gauche, comme printf
+    log.log(log.ctx, HAL_LOG_INFO, "[%*d|%-*d|%*s|%*u]", -4, 7, 3, 1, -1, "x", -3, 5u);
+    hal_log_async_flush(&log_ctx);
+
+    char line[256];
+    char expected[64];
+    TEST_ASSERT(read_lines(out, line, sizeof(line)) == 2);
+    TEST_ASSERT(strcmp(line, "[INFO] id=0x42 temp=25.07 ok  99.5% 44 -5 12\n") == 0);
+    snprintf(expected, sizeof(expected), "[INFO] [%*d|%-*d|%*s|%*u]\n", -4, 7, 3, 1, -1, "x", -3, 5u);
+    TEST_ASSERT(strcmp(expected, "[INFO] [7   |1  |x|5  ]\n") == 0);
+    rewind(out);
+    TEST_ASSERT(fgets(line, sizeof(line), out) && fgets(line, sizeof(line), out));
+    TEST_ASSERT(strcmp(line, expected) == 0);
+    TEST_ASSERT(read_lines(err, line, sizeof(line)) == 1);
+    TEST_ASSERT(strcmp(line, "[ERR] bus error NACK at    7\n") == 0);
+
+    hal_log_async_deinit(&log_ctx);
+    TEST_ASSERT(hal_log_async_dropped(&log_ctx) == 0);
+
+    fclose(out);
+    fclose(err);
+}
+
+/*
+    Producteur du test 7 : logge 100 messages.
+*/
+static void *log_thread(void *arg)
+{
+    const hal_log_t *log = (const hal_log_t *)arg;
+
+    for (int i = 0; i < 100; i++) {
+        log->log(log->ctx, HAL_LOG_WARN, "msg %d", i);
+    }
+    return NULL;
+}
+
+/*
+    Test 7 : chaque thread a sa propre file, rien n'est perdu.
+*/
+static void test_log_async_threads(void)
+{
+    FILE *out = tmpfile();
+    TEST_ASSERT(out != NULL);
+    if (!out) {
+        return;
+    }
+
+    hal_log_t log;
+    hal_log_async_ctx_t log_ctx;
+    TEST_ASSERT(hal_log_async_init(&log_ctx, &log, out, out) == 0);
+
+    pthread_t th[4];
+    for (int i = 0; i < 4; i++) {
+        pthread_create(&th[i], NULL, log_thread, &log);
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(th[i], NULL);
+    }
+
+    // flush : tout est écrit dans le fichier, sans attendre deinit
+    hal_log_async_flush(&log_ctx);
+    TEST_ASSERT(read_lines(out, NULL, 0) == 400);
+
+    // Threads successifs (pool qui tourne) : les files des threads terminés sont reprises
+    for (int i = 0; i < 3 * HAL_LOG_ASYNC_MAX_THREADS; i++) {
+        pthread_t t;
+        pthread_create(&t, NULL, log_thread, &log);
+        pthread_join(t, NULL);
+        hal_log_async_flush(&log_ctx);
+    }
+    TEST_ASSERT(hal_thread_slots_count(&log_ctx.rings) <= 4);
+
+    hal_log_async_deinit(&log_ctx);
+
+    TEST_ASSERT(hal_thread_slots_count(&log_ctx.rings) == 0);
+    TEST_ASSERT(hal_log_async_dropped(&log_ctx) == 0);
+    TEST_ASSERT(read_lines(out, NULL, 0) == 400 + 3 * HAL_LOG_ASYNC_MAX_THREADS * 100);
+
+    fclose(out);
+}
+
+/*
+    Horloge de test : avance de 250 ns à chaque lecture.
+*/
+static uint64_t tick_now_ns(void *ctx)
+{
+    uint64_t *t = (uint64_t *)ctx;
+    *t += 250;
+    return *t;
+}
+
+/*
+    Bus de test : toute transaction expire.
+*/
+static hal_status_t timeout_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    (void)ctx; (void)dev_addr; (void)reg; (void)data; (void)len;
+    return HAL_TIMEOUT;
+}
+
+static hal_status_t timeout_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    (void)ctx; (void)dev_addr; (void)reg; (void)data; (void)len;
+    return HAL_TIMEOUT;
+}
+
+/* Instantané partagé par les tests 8 et 9 (trop gros pour la pile) */
+static hal_bus_stats_snapshot_t g_snap;
+
+/*
+    Test 8 : compteurs par capteur / registre, erreurs, timeouts, latence.
+*/
+static void test_bus_stats_counts(void)
+{
+    hal_bus_t multi;
+    hal_bus_fake_multi_ctx_t multi_ctx;
+    hal_bus_fake_ctx_t dev;
+    hal_bus_fake_multi_init(&multi_ctx, &multi);
+    hal_bus_fake_dev_init(&dev);
+    hal_bus_fake_multi_attach(&multi_ctx, 0x10, &dev);
+
+    uint64_t now = 0;
+    hal_time_t clock = { .ctx = &now, .delay_ms = NULL, .now_ns = tick_now_ns };
+
+    hal_bus_t bus;
+    hal_bus_stats_ctx_t stats;
+    TEST_ASSERT(hal_bus_stats_init(&stats, &bus, &multi, &clock) == HAL_OK);
+
+    uint8_t buf[2];
+    for (int i = 0; i < 10; i++) {
+        bus.reg_read(bus.ctx, 0x10, REG_TEMP_MSB, buf, 2);
+    }
+    uint8_t ctrl = 0x01;
+    bus.reg_write(bus.ctx, 0x10, SENSOR_REG_CTRL, &ctrl, 1);
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x11, REG_WHO_AM_I, buf, 1) == HAL_ERR);
+
+    hal_bus_t slow = { .ctx = NULL, .reg_read = timeout_read, .reg_write = timeout_write };
+    hal_bus_t slow_bus;
+    hal_bus_stats_ctx_t slow_stats;
+    TEST_ASSERT(hal_bus_stats_init(&slow_stats, &slow_bus, &slow, NULL) == HAL_OK);
+    TEST_ASSERT(slow_bus.reg_write(slow_bus.ctx, 0x20, SENSOR_REG_CTRL, &ctrl, 1) == HAL_TIMEOUT);
+
+    hal_bus_stats_snapshot(&stats, &g_snap);
+    const hal_bus_stats_dev_t *d = &g_snap.dev[0x10];
+    TEST_ASSERT(d->reads == 10 && d->writes == 1);
+    TEST_ASSERT(d->bytes_read == 20 && d->bytes_written == 1);
+    TEST_ASSERT(d->errors == 0 && d->timeouts == 0);
+    TEST_ASSERT(d->lat_total_ns == 11 * 250 && d->lat_max_ns == 250);
+    TEST_ASSERT(hal_bus_stats_percentile_ns(d, 99) == 250);
+
+    TEST_ASSERT(g_snap.dev[0x11].reads == 1 && g_snap.dev[0x11].errors == 1);
+    TEST_ASSERT(g_snap.dev[0x11].bytes_read == 0);
+    TEST_ASSERT(g_snap.reg[REG_TEMP_MSB].reads == 10 && g_snap.reg[REG_TEMP_MSB].bytes == 20);
+    TEST_ASSERT(g_snap.total.reads == 11 && g_snap.total.errors == 1);
+
+    uint8_t hot[2];
+    TEST_ASSERT(hal_bus_stats_hottest_regs(&g_snap, hot, 2) == 2);
+    TEST_ASSERT(hot[0] == REG_TEMP_MSB);
+
+    hal_bus_stats_snapshot(&slow_stats, &g_snap);
+    TEST_ASSERT(g_snap.dev[0x20].writes == 1 && g_snap.dev[0x20].timeouts == 1);
+    TEST_ASSERT(g_snap.dev[0x20].errors == 0 && g_snap.dev[0x20].lat_total_ns == 0);
+
+    hal_bus_stats_deinit(&slow_stats);
+    hal_bus_stats_deinit(&stats);
+}
+
+/*
+    Producteur du test 9 : un thread, un capteur.
+*/
+typedef struct {
+    const hal_bus_t *bus;
+    uint8_t addr;
+} stats_worker_t;
+
+static void *stats_thread(void *arg)
+{
+    const stats_worker_t *w = (const stats_worker_t *)arg;
+    uint8_t id;
+
+    for (int i = 0; i < 1000; i++) {
+        w->bus->reg_read(w->bus->ctx, w->addr, REG_WHO_AM_I, &id, 1);
+    }
+    return NULL;
+}
+
+/*
+    Test 9 : un jeu de compteurs par thread, rien n'est perdu,
+    même avec plus de threads successifs que de slots.
+*/
+static void test_bus_stats_threads(void)
+{
+    enum { T = 4 };
+    hal_bus_t multi;
+    hal_bus_fake_multi_ctx_t multi_ctx;
+    hal_bus_fake_ctx_t devs[T];
+    hal_bus_fake_multi_init(&multi_ctx, &multi);
+
+    hal_bus_t bus;
+    hal_bus_stats_ctx_t stats;
+    TEST_ASSERT(hal_bus_stats_init(&stats, &bus, &multi, NULL) == HAL_OK);
+
+    pthread_t th[T];
+    stats_worker_t w[T];
+    for (int i = 0; i < T; i++) {
+        hal_bus_fake_dev_init(&devs[i]);
+        hal_bus_fake_multi_attach(&multi_ctx, (uint8_t)(0x30 + i), &devs[i]);
+        w[i].bus = &bus;
+        w[i].addr = (uint8_t)(0x30 + i);
+        pthread_create(&th[i], NULL, stats_thread, &w[i]);
+    }
+    for (int i = 0; i < T; i++) {
+        pthread_join(th[i], NULL);
+    }
+
+    TEST_ASSERT(hal_thread_slots_count(&stats.shards) <= T);
+
+    hal_bus_stats_snapshot(&stats, &g_snap);
+    TEST_ASSERT(g_snap.total.reads == T * 1000);
+    TEST_ASSERT(g_snap.reg[REG_WHO_AM_I].reads == T * 1000);
+    TEST_ASSERT(g_snap.uncounted == 0);
+    for (int i = 0; i < T; i++) {
+        TEST_ASSERT(g_snap.dev[0x30 + i].reads == 1000);
+    }
+
+    /* Threads successifs : compteurs des threads terminés repris, rien de perdu */
+    for (int i = 0; i < 3 * HAL_BUS_STATS_MAX_THREADS; i++) {
+        pthread_create(&th[0], NULL, stats_thread, &w[i % T]);
+        pthread_join(th[0], NULL);
+    }
+    TEST_ASSERT(hal_thread_slots_count(&stats.shards) <= T);
+    hal_bus_stats_snapshot(&stats, &g_snap);
+    TEST_ASSERT(g_snap.uncounted == 0);
+    TEST_ASSERT(g_snap.total.reads == (T + 3 * HAL_BUS_STATS_MAX_THREADS) * 1000);
+
+    hal_bus_stats_deinit(&stats);
+}
+
+/*
+    Test 10 : une session enregistrée est rejouée à l'identique,
+    horloge comprise ; le rejeu se resynchronise si le driver saute un accès.
+*/
+static void test_bus_trace_replay(void)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/hal_trace_%d.tr", (int)getpid());
+    unlink(path);
+
+    hal_bus_t fake;
+    hal_bus_fake_ctx_t fake_ctx;
+    hal_bus_fake_init(&fake_ctx, &fake);
+
+    hal_time_t sim;
+    hal_time_sim_ctx_t sim_ctx;
+    hal_time_sim_init(&sim_ctx, &sim, 1000);
+
+    hal_bus_t bus;
+    hal_bus_trace_rec_ctx_t rec;
+    TEST_ASSERT(hal_bus_trace_rec_init(&rec, &bus, &fake, &sim, path) == HAL_OK);
+
+    /* Jamais d'écrasement d'une trace existante */
+    hal_bus_t dup_bus;
+    hal_bus_trace_rec_ctx_t dup;
+    TEST_ASSERT(hal_bus_trace_rec_init(&dup, &dup_bus, &fake, &sim, path) == HAL_ERR);
+
+    enum { N = 50 };
+    uint8_t ctrl = 0x01;
+    uint8_t temps[N][2];
+    uint64_t dates[N];
+
+    bus.reg_write(bus.ctx, 0x50, SENSOR_REG_CTRL, &ctrl, 1);
+    for (int i = 0; i < N; i++) {
+        // Un écart > 4,3 s force un enregistrement de date absolue
+        hal_time_sim_advance_ns(&sim_ctx, i == 10 ? 5000000000ull : 1000000ull);
+        dates[i] = hal_time_now_ns(&sim);
+        bus.reg_read(bus.ctx, 0x50, REG_TEMP_MSB, temps[i], 2);
+    }
+    TEST_ASSERT(rec.hdr->count == N + 1);
+    TEST_ASSERT(rec.dropped == 0);
+    TEST_ASSERT(hal_bus_trace_rec_close(&rec) == HAL_OK);
+
+    hal_bus_t play;
+    hal_time_t play_time;
+    hal_bus_trace_play_ctx_t pc;
+    TEST_ASSERT(hal_bus_trace_play_init(&pc, &play, &play_time, path) == HAL_OK);
+
+    TEST_ASSERT(play.reg_write(play.ctx, 0x50, SENSOR_REG_CTRL, &ctrl, 1) == HAL_OK);
+    int same = 1;
+    for (int i = 0; i < N; i++) {
+        uint8_t t[2];
+        same &= play.reg_read(play.ctx, 0x50, REG_TEMP_MSB, t, 2) == HAL_OK;
+        same &= memcmp(t, temps[i], 2) == 0;
+        same &= hal_time_now_ns(&play_time) == dates[i];
+    }
+    TEST_ASSERT(same);
+    TEST_ASSERT(pc.matched == N + 1 && pc.skipped == 0 && pc.mismatches == 0);
+    TEST_ASSERT(hal_bus_trace_play_done(&pc));
+
+    /* Fin de trace : plus rien à servir */
+    uint8_t t[2];
+    TEST_ASSERT(play.reg_read(play.ctx, 0x50, REG_TEMP_MSB, t, 2) == HAL_ERR);
+    TEST_ASSERT(pc.mismatches == 1);
+
+    /* Driver modifié : saute l'écriture et une lecture, puis accès inconnu */
+    hal_bus_trace_play_rewind(&pc);
+    TEST_ASSERT(play.reg_read(play.ctx, 0x50, REG_TEMP_MSB, t, 2) == HAL_OK);
+    TEST_ASSERT(play.reg_read(play.ctx, 0x50, REG_TEMP_MSB, t, 2) == HAL_OK);
+    TEST_ASSERT(memcmp(t, temps[1], 2) == 0);
+    hal_bus_trace_play_rewind(&pc);
+    TEST_ASSERT(play.reg_read(play.ctx, 0x50, REG_TEMP_MSB, t, 2) == HAL_OK);
+    TEST_ASSERT(play.reg_read(play.ctx, 0x50, REG_TEMP_MSB, t, 2) == HAL_OK);
+    TEST_ASSERT(memcmp(t, temps[1], 2) == 0);
+    TEST_ASSERT(pc.skipped == 1);
+    TEST_ASSERT(play.reg_read(play.ctx, 0x51, REG_WHO_AM_I, t, 1) == HAL_ERR);
+    TEST_ASSERT(pc.mismatches == 1);
+    TEST_ASSERT(!hal_bus_trace_play_done(&pc));
+
+    /* Lecture séquentielle : l'écriture puis les lectures */
+    size_t pos = 0;
+    uint64_t t_ns = 0;
+    hal_bus_trace_record_t r;
+    size_t n_rec = 0;
+    TEST_ASSERT(hal_bus_trace_next(&pc, &pos, &t_ns, &r) == 1);
+    TEST_ASSERT(r.op == HAL_BUS_TRACE_OP_WRITE && r.len == 1 && r.data[0] == ctrl);
+    while (hal_bus_trace_next(&pc, &pos, &t_ns, &r)) {
+        n_rec += r.op == HAL_BUS_TRACE_OP_READ;
+    }
+    TEST_ASSERT(n_rec == N);
+    TEST_ASSERT(t_ns == dates[N - 1]);
+
+    hal_bus_trace_play_close(&pc);
+    unlink(path);
+}
+
+/*
+    Simulateur du test 11 (processus fils) : deux capteurs, servis
+    jusqu'à l'arrêt demandé par le père.
+*/
+static void shm_simulator(const char *name)
+{
+    hal_bus_shm_t shm;
+    if (hal_bus_shm_attach(&shm, name) != HAL_OK) {
+        _exit(2);
+    }
+
+    hal_bus_t multi;
+    hal_bus_fake_multi_ctx_t multi_ctx;
+    static hal_bus_fake_ctx_t devs[4];
+    hal_bus_fake_multi_init(&multi_ctx, &multi);
+    for (int i = 0; i < 4; i++) {
+        hal_bus_fake_dev_init(&devs[i]);
+        hal_bus_fake_multi_attach(&multi_ctx, (uint8_t)(0x50 + i), &devs[i]);
+    }
+
+    uint64_t served = hal_bus_shm_serve(&shm, &multi);
+    hal_bus_shm_detach(&shm);
+    _exit(served > 0 ? 0 : 3);
+}
+
+static void *shm_thread(void *arg)
+{
+    const stats_worker_t *w = (const stats_worker_t *)arg;
+    uint8_t id;
+    intptr_t ok = 1;
+
+    for (int i = 0; i < 500; i++) {
+        ok &= w->bus->reg_read(w->bus->ctx, w->addr, REG_WHO_AM_I, &id, 1) == HAL_OK;
+        ok &= id == EXPECTED_ID;
+    }
+    return (void *)ok;
+}
+
+/*
+    Test 11 : driver et simulateur dans deux processus (fork).
+*/
+static void test_bus_shm_process(void)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/hal_shm_test_%d", (int)getpid());
+
+    hal_bus_shm_t shm;
+    TEST_ASSERT(hal_bus_shm_create(&shm, name) == HAL_OK);
+    if (!shm.region) {
+        return;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        shm_simulator(name);
+    }
+    TEST_ASSERT(pid > 0);
+
+    hal_bus_t bus;
+    TEST_ASSERT(hal_bus_shm_client_init(&shm, &bus) == HAL_OK);
+
+    uint8_t id = 0;
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x50, REG_WHO_AM_I, &id, 1) == HAL_OK);
+    TEST_ASSERT(id == EXPECTED_ID);
+
+    uint8_t ctrl = 0x01, back = 0;
+    TEST_ASSERT(bus.reg_write(bus.ctx, 0x51, SENSOR_REG_CTRL, &ctrl, 1) == HAL_OK);
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x51, SENSOR_REG_CTRL, &back, 1) == HAL_OK);
+    TEST_ASSERT(back == ctrl);
+
+    /* Erreurs : capteur absent (NACK du modèle), transfert trop long */
+    uint8_t big[HAL_BUS_SHM_MAX_LEN + 1];
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x70, REG_WHO_AM_I, &id, 1) == HAL_ERR);
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x50, REG_WHO_AM_I, big, sizeof(big)) == HAL_ERR);
+
+    /* Transfert vectorisé : une chaîne, puis plus de segments que d'emplacements */
+    uint8_t ctrl2 = 0x03, back2 = 0, id2 = 0;
+    hal_bus_seg_t chain[3] = {
+        { 0x52, SENSOR_REG_CTRL, HAL_BUS_SEG_WRITE, &ctrl2, 1 },
+        { 0x52, SENSOR_REG_CTRL, HAL_BUS_SEG_READ, &back2, 1 },
+        { 0x53, REG_WHO_AM_I, HAL_BUS_SEG_READ, &id2, 1 },
+    };
+    TEST_ASSERT(hal_bus_vectored(&bus, chain, 3) == HAL_OK);
+    TEST_ASSERT(back2 == ctrl2 && id2 == EXPECTED_ID);
+
+    enum { LONG = HAL_BUS_SHM_SLOTS + 8 };
+    hal_bus_seg_t many[LONG];
+    uint8_t ids[LONG];
+    for (int i = 0; i < LONG; i++) {
+        ids[i] = 0;
+        many[i] = (hal_bus_seg_t){ (uint8_t)(0x50 + i % 4), REG_WHO_AM_I, HAL_BUS_SEG_READ, &ids[i], 1 };
+    }
+    TEST_ASSERT(hal_bus_vectored(&bus, many, LONG) == HAL_OK);
+    int all_ids = 1;
+    for (int i = 0; i < LONG; i++) {
+        all_ids &= ids[i] == EXPECTED_ID;
+    }
+    TEST_ASSERT(all_ids);
+
+    /* Échec au milieu : statut du segment fautif */
+    chain[1].dev_addr = 0x70;
+    TEST_ASSERT(hal_bus_vectored(&bus, chain, 3) == HAL_ERR);
+
+    /* Plusieurs threads clients sur la même région */
+    pthread_t th[4];
+    stats_worker_t w[4];
+    for (int i = 0; i < 4; i++) {
+        w[i].bus = &bus;
+        w[i].addr = (uint8_t)(0x50 + i);
+        pthread_create(&th[i], NULL, shm_thread, &w[i]);
+    }
+    int all_ok = 1;
+    for (int i = 0; i < 4; i++) {
+        void *ok = NULL;
+        pthread_join(th[i], &ok);
+        all_ok &= ok != NULL;
+    }
+    TEST_ASSERT(all_ok);
+
+    hal_bus_shm_shutdown(&shm);
+    int status = -1;
+    TEST_ASSERT(waitpid(pid, &status, 0) == pid);
+    TEST_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    hal_bus_shm_detach(&shm);
+}
+
+/*
+    Test 12 : simulateur absent -> HAL_TIMEOUT, l'emplacement est rendu.
+*/
+static void test_bus_shm_timeout(void)
+{
+    hal_bus_shm_t shm;
+    TEST_ASSERT(hal_bus_shm_create(&shm, NULL) == HAL_OK);
+    if (!shm.region) {
+        return;
+    }
+    shm.timeout_ms = 20;
+
+    hal_bus_t bus;
+    hal_bus_shm_client_init(&shm, &bus);
+
+    uint8_t id;
+    TEST_ASSERT(bus.reg_read(bus.ctx, 0x50, REG_WHO_AM_I, &id, 1) == HAL_TIMEOUT);
+
+    int all_free = 1;
+    for (int i = 0; i < HAL_BUS_SHM_SLOTS; i++) {
+        all_free &= atomic_load(&shm.region->slots[i].state) == 0;
+    }
+    TEST_ASSERT(all_free);
+
+    hal_bus_shm_detach(&shm);
+}
+
+/*
+    Test 13 : coût sur le fil I2C / SPI et occupation du bus.
+*/
+static void test_bus_timing(void)
+{
+    hal_bus_timing_cfg_t i2c = HAL_BUS_TIMING_I2C_400K;
+    hal_bus_timing_cfg_t i2c_slow = HAL_BUS_TIMING_I2C_100K;
+    hal_bus_timing_cfg_t spi = HAL_BUS_TIMING_SPI(8000000u);
+
+    /* 400 kHz : 2,5 us par période, tBUF 1,3 us */
+    TEST_ASSERT(hal_bus_timing_cost_ns(&i2c, 0, 2, HAL_OK) == 48 * 2500 + 1300);
+    TEST_ASSERT(hal_bus_timing_cost_ns(&i2c, 1, 1, HAL_OK) == 29 * 2500 + 1300);
+    TEST_ASSERT(hal_bus_timing_cost_ns(&i2c, 0, 2, HAL_ERR) == 11 * 2500 + 1300);
+    TEST_ASSERT(hal_bus_timing_cost_ns(&i2c_slow, 0, 2, HAL_OK) == 48 * 10000 + 4700);
+    TEST_ASSERT(hal_bus_timing_cost_ns(&spi, 0, 2, HAL_OK) == 24 * 125 + 100);
+
+    hal_bus_t fake;
+    hal_bus_fake_ctx_t fake_ctx;
+    hal_bus_fake_init(&fake_ctx, &fake);
+
+    hal_time_t sim;
+    hal_time_sim_ctx_t sim_ctx;
+    hal_time_sim_init(&sim_ctx, &sim, 5000);
+
+    /* Appelant bloquant : l'horloge avance du coût de chaque transfert */
+    hal_bus_t bus;
+    hal_bus_timing_ctx_t timing;
+    hal_bus_timing_cfg_t bad = { HAL_BUS_WIRE_I2C, 0, 0 };
+    TEST_ASSERT(hal_bus_timing_init(&timing, &bus, &fake, &bad, &sim_ctx, 1) == HAL_ERR);
+    TEST_ASSERT(hal_bus_timing_init(&timing, &bus, &fake, &i2c, &sim_ctx, 1) == HAL_OK);
+
+    uint8_t buf[2];
+    for (int i = 0; i < 100; i++) {
+        bus.reg_read(bus.ctx, 0x50, REG_TEMP_MSB, buf, 2);
+    }
+    TEST_ASSERT(hal_time_now_ns(&sim) == 5000 + 100 * (48 * 2500 + 1300));
+
+    hal_bus_timing_report_t rep;
+    hal_bus_timing_report(&timing, &rep);
+    TEST_ASSERT(rep.transactions == 100 && rep.bytes == 200);
+    TEST_ASSERT(rep.busy_ns == rep.elapsed_ns && rep.utilization_ppm == 1000000);
+
+    /* Autant de temps à ne rien faire : occupation 50 % */
+    hal_time_sim_advance_ns(&sim_ctx, rep.elapsed_ns);
+    hal_bus_timing_report(&timing, &rep);
+    TEST_ASSERT(rep.utilization_ppm == 500000);
+
+    /* Une journée simulée à 50 % : busy_ns * 10^6 déborderait un uint64 */
+    const uint64_t day_ns = 86400ull * 1000000000u;
+    hal_time_sim_advance_ns(&sim_ctx, day_ns - rep.elapsed_ns);
+    timing.busy_ns = day_ns / 2;
+    hal_bus_timing_report(&timing, &rep);
+    TEST_ASSERT(rep.elapsed_ns == day_ns && rep.utilization_ppm == 500000);
+
+    /* Horloge partagée non avancée : la 2e transaction attend la 1re */
+    hal_bus_timing_ctx_t shared;
+    TEST_ASSERT(hal_bus_timing_init(&shared, &bus, &fake, &spi, &sim_ctx, 0) == HAL_OK);
+    uint64_t t0 = hal_time_now_ns(&sim);
+    bus.reg_read(bus.ctx, 0x50, REG_TEMP_MSB, buf, 2);
+    bus.reg_read(bus.ctx, 0x50, REG_TEMP_MSB, buf, 2);
+    TEST_ASSERT(hal_time_now_ns(&sim) == t0);
+    hal_bus_timing_report(&shared, &rep);
+    TEST_ASSERT(rep.wait_ns == 3100 && rep.busy_ns == 6200 && rep.elapsed_ns == 6200);
+
+    /* Vectorisé I2C : un restart remplace STOP + tBUF + START */
+    hal_bus_seg_t two[2] = {
+        { 0x50, REG_TEMP_MSB, HAL_BUS_SEG_READ, buf, 2 },
+        { 0x50, REG_TEMP_MSB, HAL_BUS_SEG_READ, buf, 2 },
+    };
+    TEST_ASSERT(hal_bus_timing_xfer_cost_ns(&i2c, two, 2) == 95 * 2500 + 1300);
+    TEST_ASSERT(hal_bus_timing_xfer_cost_ns(&i2c, two, 1) == hal_bus_timing_cost_ns(&i2c, 0, 2, HAL_OK));
+    TEST_ASSERT(hal_bus_timing_xfer_cost_ns(&spi, two, 2) == 2 * hal_bus_timing_cost_ns(&spi, 0, 2, HAL_OK));
+
+    hal_bus_timing_reset(&shared);
+    hal_bus_timing_report(&shared, &rep);
+    TEST_ASSERT(rep.transactions == 0 && rep.elapsed_ns == 0);
+}
+
+/*
+    Test 14 : transfert vectorisé natif (multi-capteurs) et repli générique.
+*/
+static void test_bus_xfer(void)
+{
+    hal_bus_t multi;
+    hal_bus_fake_multi_ctx_t multi_ctx;
+    hal_bus_fake_ctx_t dev;
+    hal_bus_fake_multi_init(&multi_ctx, &multi);
+    hal_bus_fake_dev_init(&dev);
+    hal_bus_fake_multi_attach(&multi_ctx, 0x10, &dev);
+    TEST_ASSERT(multi.xfer != NULL);
+
+    uint8_t ctrl = 0x05, back = 0, temp[2];
+    hal_bus_seg_t segs[3] = {
+        { 0x10, SENSOR_REG_CTRL, HAL_BUS_SEG_WRITE, &ctrl, 1 },
+        { 0x10, SENSOR_REG_CTRL, HAL_BUS_SEG_READ, &back, 1 },
+        { 0x10, REG_TEMP_MSB, HAL_BUS_SEG_READ, temp, 2 },
+    };
+    TEST_ASSERT(hal_bus_vectored(&multi, segs, 3) == HAL_OK);
+    TEST_ASSERT(back == ctrl);
+
+    /* Arrêt au premier échec : la 3e écriture n'a pas lieu */
+    uint8_t other = 0x07;
+    hal_bus_seg_t failing[3] = {
+        { 0x10, SENSOR_REG_CTRL, HAL_BUS_SEG_READ, &back, 1 },
+        { 0x11, SENSOR_REG_CTRL, HAL_BUS_SEG_READ, &back, 1 },
+        { 0x10, SENSOR_REG_CTRL, HAL_BUS_SEG_WRITE, &other, 1 },
+    };
+    TEST_ASSERT(hal_bus_vectored(&multi, failing, 3) == HAL_ERR);
+    TEST_ASSERT(dev.regs[SENSOR_REG_CTRL] == ctrl);
+
+    /* Segments absents : refusés par les trois fakes */
+    hal_bus_t single, port;
+    hal_bus_fake_ctx_t single_ctx;
+    hal_bus_fake_init(&single_ctx, &single);
+    hal_fake_model_t model;
+    hal_fake_model_init_default(&model);
+    hal_bus_fake_fleet_t fleet;
+    TEST_ASSERT(hal_bus_fake_fleet_init(&fleet, &model, 1, 1, 0x10) == HAL_OK);
+    TEST_ASSERT(hal_bus_fake_fleet_bus(&fleet, 0, &port) == HAL_OK);
+    TEST_ASSERT(single.xfer(single.ctx, NULL, 1) == HAL_ERR);
+    TEST_ASSERT(multi.xfer(multi.ctx, NULL, 1) == HAL_ERR);
+    TEST_ASSERT(port.xfer(port.ctx, NULL, 1) == HAL_ERR);
+    TEST_ASSERT(port.xfer(port.ctx, NULL, 0) == HAL_OK);
+    hal_bus_fake_fleet_deinit(&fleet);
+
+    /* Décorateur sans xfer natif : un appel par segment */
+    hal_bus_t bus;
+    hal_bus_stats_ctx_t stats;
+    hal_bus_stats_init(&stats, &bus, &multi, NULL);
+    TEST_ASSERT(bus.xfer == NULL);
+    TEST_ASSERT(hal_bus_vectored(&bus, segs, 3) == HAL_OK);
+    hal_bus_stats_snapshot(&stats, &g_snap);
+    TEST_ASSERT(g_snap.dev[0x10].reads == 2 && g_snap.dev[0x10].writes == 1);
+    hal_bus_stats_deinit(&stats);
+
+    /* Backend qui ignore xfer : hal_bus_init efface l'ancien contenu */
+    hal_bus_t legacy;
+    memset(&legacy, 0xA5, sizeof(legacy));
+    hal_bus_init(&legacy);
+    legacy.ctx = multi.ctx;
+    legacy.reg_read = multi.reg_read;
+    legacy.reg_write = multi.reg_write;
+    TEST_ASSERT(legacy.xfer == NULL);
+    TEST_ASSERT(hal_bus_vectored(&legacy, segs, 3) == HAL_OK);
+}
+
+/*
+    Producteur du test 15 : écrit puis relit CTRL sur son capteur,
+    et lit un capteur absent (l'erreur doit lui revenir, à lui seul).
+*/
+static void *combine_thread(void *arg)
+{
+    const stats_worker_t *w = (const stats_worker_t *)arg;
+    intptr_t ok = 1;
+
+    for (int i = 0; i < 300; i++) {
+        uint8_t v = (uint8_t)(w->addr + i), back = 0;
+        ok &= w->bus->reg_write(w->bus->ctx, w->addr, SENSOR_REG_CTRL, &v, 1) == HAL_OK;
+        ok &= w->bus->reg_read(w->bus->ctx, w->addr, SENSOR_REG_CTRL, &back, 1) == HAL_OK;
+        ok &= back == v;
+        if (i % 50 == 0) {
+            ok &= w->bus->reg_read(w->bus->ctx, 0x7F, REG_WHO_AM_I, &back, 1) == HAL_ERR;
+        }
+    }
+    return (void *)ok;
+}
+
+/*
+    Test 15 : bus multi-capteurs non thread-safe partagé par combinaison,
+    y compris au-delà de HAL_BUS_COMBINE_MAX_THREADS threads.
+*/
+static void test_bus_combine(void)
+{
+    enum { T = HAL_BUS_COMBINE_MAX_THREADS + 4 };
+    hal_bus_t multi;
+    hal_bus_fake_multi_ctx_t multi_ctx;
+    static hal_bus_fake_ctx_t devs[T];
+    hal_bus_fake_multi_init(&multi_ctx, &multi);
+
+    hal_bus_t bus;
+    hal_bus_combine_ctx_t comb;
+    TEST_ASSERT(hal_bus_combine_init(&comb, &bus, &multi) == HAL_OK);
+
+    pthread_t th[T];
+    stats_worker_t w[T];
+    for (int i = 0; i < T; i++) {
+        hal_bus_fake_dev_init(&devs[i]);
+        hal_bus_fake_multi_attach(&multi_ctx, (uint8_t)(0x20 + i), &devs[i]);
+        w[i].bus = &bus;
+        w[i].addr = (uint8_t)(0x20 + i);
+    }
+    for (int i = 0; i < T; i++) {
+        pthread_create(&th[i], NULL, combine_thread, &w[i]);
+    }
+
+    int all_ok = 1;
+    for (int i = 0; i < T; i++) {
+        void *ok = NULL;
+        pthread_join(th[i], &ok);
+        all_ok &= ok != NULL;
+    }
+    TEST_ASSERT(all_ok);
+
+    /*
+        Chaque requête d'un thread enregistré passe par un combineur.
+        Les MAX premiers threads gardent leur enregistrement ; les autres
+        en reprennent un si un thread s'est terminé avant eux.
+    */
+    uint64_t per_thread = 300 * 2 + 6;
+    uint64_t requests = atomic_load(&comb.requests);
+    TEST_ASSERT(hal_thread_slots_count(&comb.recs) <= HAL_BUS_COMBINE_MAX_THREADS);
+    TEST_ASSERT(requests >= HAL_BUS_COMBINE_MAX_THREADS * per_thread);
+    TEST_ASSERT(requests <= T * per_thread);
+    TEST_ASSERT(atomic_load(&comb.batches) > 0);
+    TEST_ASSERT(atomic_load(&comb.batches) <= requests);
+
+    /* Threads successifs : enregistrements repris, tout passe par un combineur */
+    size_t recs = hal_thread_slots_count(&comb.recs);
+    for (int i = 0; i < 3 * HAL_BUS_COMBINE_MAX_THREADS; i++) {
+        pthread_create(&th[0], NULL, combine_thread, &w[i % T]);
+        void *ok = NULL;
+        pthread_join(th[0], &ok);
+        TEST_ASSERT(ok != NULL);
+    }
+    TEST_ASSERT(hal_thread_slots_count(&comb.recs) == recs);
+    TEST_ASSERT(atomic_load(&comb.requests) == requests + 3 * HAL_BUS_COMBINE_MAX_THREADS * per_thread);
+
+    /* Transfert vectorisé à travers le combineur */
+    uint8_t ctrl = 0x09, back = 0;
+    hal_bus_seg_t segs[2] = {
+        { 0x20, SENSOR_REG_CTRL, HAL_BUS_SEG_WRITE, &ctrl, 1 },
+        { 0x20, SENSOR_REG_CTRL, HAL_BUS_SEG_READ, &back, 1 },
+    };
+    TEST_ASSERT(hal_bus_vectored(&bus, segs, 2) == HAL_OK);
+    TEST_ASSERT(back == ctrl);
+
+    hal_bus_combine_deinit(&comb);
+}
+
+/*
+    Modèle du test 16 : reste bloqué dans la transaction (simulateur planté).
+*/
+static hal_status_t hang_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    (void)ctx; (void)dev_addr; (void)reg; (void)data; (void)len;
+    while (pause() == -1) {
+        // pause() ne rend la main que sur signal : on y retourne
+    }
+    return HAL_ERR;
+}
+
+static hal_status_t hang_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    (void)ctx; (void)dev_addr; (void)reg; (void)data; (void)len;
+    while (pause() == -1) {
+        // pause() ne rend la main que sur signal : on y retourne
+    }
+    return HAL_ERR;
+}
+
+/*
+    Simulateur fils sur une région anonyme héritée : bloqué ou normal.
+*/
+static pid_t shm_fork_server(hal_bus_shm_t *shm, int hang)
+{
+    pid_t pid = fork();
+    if (pid != 0) {
+        return pid;
+    }
+
+    hal_bus_t model = { NULL, hang_read, hang_write, NULL };
+    hal_bus_fake_multi_ctx_t multi_ctx;
+    static hal_bus_fake_ctx_t dev;
+    if (!hang) {
+        hal_bus_fake_multi_init(&multi_ctx, &model);
+        hal_bus_fake_dev_init(&dev);
+        hal_bus_fake_multi_attach(&multi_ctx, 0x50, &dev);
+    }
+    hal_bus_shm_serve(shm, &model);
+    _exit(0);
+}
+
+static int shm_slots_in_state(const hal_bus_shm_t *shm, uint32_t state)
+{
+    int n = 0;
+    for (int i = 0; i < HAL_BUS_SHM_SLOTS; i++) {
+        n += (atomic_load(&shm->region->slots[i].state) & 0xFFu) == state;
+    }
+    return n;
+}
+
+static void sleep_ms(long ms)
+{
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+static void *shm_crash_client(void *arg)
+{
+    const hal_bus_t *bus = (const hal_bus_t *)arg;
+    uint8_t id = 0;
+    return (void *)(intptr_t)bus->reg_read(bus->ctx, 0x50, REG_WHO_AM_I, &id, 1);
+}
+
+/*
+    Test 16 : simulateur tué en pleine transaction puis remplacé.
+    - client reparti sur timeout (ORPHAN) : chaîne reprise par le suivant
+    - client encore en attente (TAKEN) : reçoit HAL_ERR du suivant
+    - emplacement mal formé (len, op) : HAL_ERR, rien de débordé
+*/
+static void test_bus_shm_server_crash(void)
+{
+    enum { TAKEN = 3, DONE = 4, ORPHAN = 5 };
+
+    hal_bus_shm_t shm;
+    TEST_ASSERT(hal_bus_shm_create(&shm, NULL) == HAL_OK);
+    if (!shm.region) {
+        return;
+    }
+
+    hal_bus_t bus;
+    hal_bus_shm_client_init(&shm, &bus);
+
+    /* 1. Chaîne de 3 prise par un simulateur bloqué ; le client abandonne */
+    pid_t a = shm_fork_server(&shm, 1);
+    shm.timeout_ms = 300;
+    uint8_t v[3];
+    hal_bus_seg_t chain[3];
+    for (int i = 0; i < 3; i++) {
+        chain[i] = (hal_bus_seg_t){ 0x50, REG_WHO_AM_I, HAL_BUS_SEG_READ, &v[i], 1 };
+    }
+    TEST_ASSERT(hal_bus_vectored(&bus, chain, 3) == HAL_TIMEOUT);
+    TEST_ASSERT(shm_slots_in_state(&shm, ORPHAN) == 1);
+    TEST_ASSERT(shm_slots_in_state(&shm, 0) == HAL_BUS_SHM_SLOTS - 3);
+    kill(a, SIGKILL);
+    waitpid(a, NULL, 0);
+
+    /* 2. Un client attend pendant que le simulateur suivant se plante */
+    pid_t b = shm_fork_server(&shm, 1);
+    shm.timeout_ms = 5000;
+    pthread_t th;
+    pthread_create(&th, NULL, shm_crash_client, &bus);
+    for (int i = 0; i < 500 && shm_slots_in_state(&shm, TAKEN) == 0; i++) {
+        sleep_ms(2);
+    }
+    TEST_ASSERT(shm_slots_in_state(&shm, TAKEN) == 1);
+    kill(b, SIGKILL);
+    waitpid(b, NULL, 0);
+
+    /* 3. Nouveau simulateur : tout est repris */
+    pid_t c = shm_fork_server(&shm, 0);
+    void *st = NULL;
+    pthread_join(th, &st);
+    TEST_ASSERT((hal_status_t)(intptr_t)st == HAL_ERR);
+
+    int all_ok = 1;
+    for (int i = 0; i < 2 * HAL_BUS_SHM_SLOTS; i++) {
+        uint8_t id = 0;
+        all_ok &= bus.reg_read(bus.ctx, 0x50, REG_WHO_AM_I, &id, 1) == HAL_OK && id == EXPECTED_ID;
+    }
+    TEST_ASSERT(all_ok);
+    TEST_ASSERT(shm_slots_in_state(&shm, 0) == HAL_BUS_SHM_SLOTS);
+
+    /* 4. Client bogué : len hors borne, op inconnue (écrits à la main) */
+    hal_bus_shm_slot_t *bad = &shm.region->slots[0];
+    hal_bus_shm_slot_t *neighbour = &shm.region->slots[1];
+    const uint32_t bad_len[2] = { HAL_BUS_SHM_MAX_LEN + 64, 1 };
+    const uint8_t bad_op[2] = { 0, 7 };
+    for (int k = 0; k < 2; k++) {
+        atomic_store(&bad->state, 1);  // CLAIMED
+        bad->op = bad_op[k];
+        bad->dev_addr = 0x50;
+        bad->reg = REG_WHO_AM_I;
+        bad->len = bad_len[k];
+        bad->next = HAL_BUS_SHM_END;
+        bad->status = (int8_t)HAL_OK;
+        atomic_store(&bad->state, 2);  // POSTED
+        atomic_fetch_add(&shm.region->req_seq, 1);
+
+        for (int i = 0; i < 1000 && (atomic_load(&bad->state) & 0xFFu) != DONE; i++) {
+            sleep_ms(1);
+        }
+        TEST_ASSERT((atomic_load(&bad->state) & 0xFFu) == DONE);
+        TEST_ASSERT(bad->status == (int8_t)HAL_ERR);
+        atomic_store(&bad->state, 0);
+    }
+    TEST_ASSERT((atomic_load(&neighbour->state) & 0xFFu) == 0);
+
+    hal_bus_shm_shutdown(&shm);
+    int status = -1;
+    TEST_ASSERT(waitpid(c, &status, 0) == c);
+    TEST_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    hal_bus_shm_detach(&shm);
+}
+
+int main(void)
+{
+    printf("=== Running HAL tests ===\n");
+
+    test_async_poll();
+    test_async_callback();
+    test_async_pool_exhausted();
+    test_fleet_copy_on_write();
+    test_fleet_million();
+    test_log_async_format();
+    test_log_async_threads();
+    test_bus_stats_counts();
+    test_bus_stats_threads();
+    test_bus_trace_replay();
+    test_bus_shm_process();
+    test_bus_shm_timeout();
+    test_bus_timing();
+    test_bus_xfer();
+    test_bus_combine();
+    test_bus_shm_server_crash();
+
+    printf("Tests run: %d\n", g_tests_run);
+    printf("Tests failed: %d\n", g_tests_failed);
+
+    return (g_tests_failed == 0) ? 0 : 1;
+}
@@ -7,28 +7,44 @@
     - vérifier que sensor_init() réussit quand WHO_AM_I est correct
     - vérifier que sensor_init() échoue quand WHO_AM_I est faux
     - vérifier que la lecture température renvoie une valeur cohérente
+    - vérifier la lecture FIFO en rafale (niveau, overrun)
+    - vérifier le driver sur une flotte de capteurs (plusieurs bus multi-capteurs)
+    - vérifier la file SPSC d'échantillons (débordement, ordre entre threads)
+    - vérifier qu'une rafale d'erreurs bus ne noie pas le logger
+    - vérifier le temps simulé (délai d'init, horodatage)
+    - vérifier l'API non bloquante (attentes recouvertes entre capteurs)
+    - vérifier le cache shadow (lectures servies en local, flush fusionné)
 
     On utilise :
     - hal_bus_fake (capteur simulé)
-    - hal_time_fake / hal_log_stdio (implémentations host)
-
-    Note :
-    - On ne fait pas de tests "temps réel" : delay_ms n'est pas essentiel ici.
+    - hal_time_sim (temps virtuel : delay_ms ne dort pas)
+    - hal_log_stdio (implémentation host)
 */
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
 
 #include "sensor/sensor.h"
+#include "sensor/sensor_ring.h"
+#include "sensor/sensor_op.h"
+#include "sensor/sensor_convert.h"
+#include "sensor/sensor_cal.h"
+#include "sensor/sensor_filter.h"
+#include "sensor/sensor_codec.h"
+#include "sensor/sensor_rollup.h"
 #include "hal/hal_bus_fake.h"
 #include "hal/hal_time.h"
+#include "hal/hal_time_sim.h"
 #include "hal/hal_log.h"
 
 /*
     Fonctions d'init (implémentées dans src/hal/*.c)
     Comme on n'a pas de headers dédiés, on déclare les prototypes ici.
 */
-void hal_time_fake_init(hal_time_t *time);
 void hal_log_stdio_init(hal_log_t *log);
 
 /* Petit utilitaire : compteur de tests */
@@ -48,10 +64,9 @@ static int g_tests_failed = 0;
 } while (0)
 
 /*
-    Adresses de registres utilisées dans le fake bus.
-    Elles doivent correspondre à celles du driver + fake.
+    Adresses de registres : carte partagée driver + fake.
 */
-#define REG_WHO_AM_I  0x00
+#define REG_WHO_AM_I  SENSOR_REG_WHO_AM_I
 
 /* Valeur attendue par le driver (EXPECTED_ID dans sensor.c) */
 #define EXPECTED_ID   0x42
@@ -66,7 +81,8 @@ static void test_init_ok(void)
     hal_bus_fake_init(&bus_ctx, &bus);
 
     hal_time_t time;
-    hal_time_fake_init(&time);
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 0);
 
     hal_log_t log;
     hal_log_stdio_init(&log);
@@ -93,7 +109,8 @@ static void test_init_bad_id(void)
     bus_ctx.regs[REG_WHO_AM_I] = 0x00; // volontairement faux
 
     hal_time_t time;
-    hal_time_fake_init(&time);
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 0);
 
     hal_log_t log;
     hal_log_stdio_init(&log);
@@ -118,7 +135,8 @@ static void test_read_temperature_plausible(void)
     bus_ctx.regs[REG_WHO_AM_I] = EXPECTED_ID;
 
     hal_time_t time;
-    hal_time_fake_init(&time);
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 0);
 
     hal_log_t log;
     hal_log_stdio_init(&log);
@@ -140,6 +158,1157 @@ static void test_read_temperature_plausible(void)
     TEST_ASSERT(temp < 6000);  // < 60.00°C
 }
 
+/*
+    Test 4 : sensor_read_samples vide la FIFO en une rafale,
+    dans l'ordre de production.
+*/
+static void test_read_samples_burst(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    hal_time_t time;
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 0);
+
+    hal_log_t log;
+    hal_log_stdio_init(&log);
+
+    sensor_t s;
+    sensor_status_t st = sensor_init(&s, 0x50, &bus, &time, &log);
+    TEST_ASSERT(st == SENSOR_OK);
+
+    hal_bus_fake_fifo_fill(&bus_ctx, 10);
+
+    int16_t samples[SENSOR_FIFO_DEPTH];
+    size_t n = 0;
+    st = sensor_read_samples(&s, samples, SENSOR_FIFO_DEPTH, &n);
+    TEST_ASSERT(st == SENSOR_OK);
+    TEST_ASSERT(n == 10);
+
+    /* Le modèle fake avance de +5 centi-degrés par échantillon */
+    for (size_t i = 1; i < n; i++) {
+        TEST_ASSERT(samples[i] - samples[i - 1] == 5);
+    }
+
+    /* FIFO vide après la rafale */
+    st = sensor_read_samples(&s, samples, SENSOR_FIFO_DEPTH, &n);
+    TEST_ASSERT(st == SENSOR_OK);
+    TEST_ASSERT(n == 0);
+    TEST_ASSERT(s.fifo_overruns == 0);
+}
+
+/*
+    Test 5 : une FIFO qui déborde garde les plus récents
+    et signale l'overrun au driver.
+*/
+static void test_read_samples_overrun(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    hal_time_t time;
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 0);
+
+    hal_log_t log;
+    hal_log_stdio_init(&log);
+
+    sensor_t s;
+    sensor_status_t st = sensor_init(&s, 0x50, &bus, &time, &log);
+    TEST_ASSERT(st == SENSOR_OK);
+
+    hal_bus_fake_fifo_fill(&bus_ctx, SENSOR_FIFO_DEPTH + 4);
+
+    int16_t samples[SENSOR_FIFO_DEPTH];
+    size_t n = 0;
+
+    /* Lecture partielle : max_samples est respecté */
+    st = sensor_read_samples(&s, samples, 8, &n);
+    TEST_ASSERT(st == SENSOR_OK);
+    TEST_ASSERT(n == 8);
+    TEST_ASSERT(s.fifo_overruns == 1);
+
+    st = sensor_read_samples(&s, samples, SENSOR_FIFO_DEPTH, &n);
+    TEST_ASSERT(st == SENSOR_OK);
+    TEST_ASSERT(n == SENSOR_FIFO_DEPTH - 8);
+    TEST_ASSERT(samples[n - 1] - samples[0] == (int16_t)(5 * (n - 1)));
+
+    /* L'overrun a été effacé par la première lecture de FIFO_STATUS */
+    TEST_ASSERT(s.fifo_overruns == 1);
+}
+
+/*
+    Test 6 : flotte de capteurs sur plusieurs bus multi-capteurs.
+    Chaque capteur a son propre état, une adresse vide répond NACK.
+*/
+static void test_fleet_multi_bus(void)
+{
+    enum { N_BUSES = 16, DEVS_PER_BUS = 100, ADDR_BASE = 0x10 };
+
+    hal_bus_t buses[N_BUSES];
+    hal_bus_fake_multi_ctx_t *bus_ctx = calloc(N_BUSES, sizeof(*bus_ctx));
+    hal_bus_fake_ctx_t *devs = calloc(N_BUSES * DEVS_PER_BUS, sizeof(*devs));
+    sensor_t *sensors = calloc(N_BUSES * DEVS_PER_BUS, sizeof(*sensors));
+    TEST_ASSERT(bus_ctx && devs && sensors);
+    if (!bus_ctx || !devs || !sensors) {
+        free(bus_ctx);
+        free(devs);
+        free(sensors);
+        return;
+    }
+
+    hal_log_t log;
+    hal_log_stdio_init(&log);
+
+    int init_failures = 0;
+    for (int b = 0; b < N_BUSES; b++) {
+        hal_bus_fake_multi_init(&bus_ctx[b], &buses[b]);
+        for (int d = 0; d < DEVS_PER_BUS; d++) {
+            hal_bus_fake_ctx_t *dev = &devs[b * DEVS_PER_BUS + d];
+            hal_bus_fake_dev_init(dev);
+            dev->fake_temp_centi = (int16_t)(2000 + d); // état propre à chaque capteur
+            hal_bus_fake_multi_attach(&bus_ctx[b], (uint8_t)(ADDR_BASE + d), dev);
+
+            /* Ni délai ni log : on teste l'aiguillage, pas le timing */
+            if (sensor_init(&sensors[b * DEVS_PER_BUS + d], (uint8_t)(ADDR_BASE + d),
+                            &buses[b], NULL, NULL) != SENSOR_OK) {
+                init_failures++;
+            }
+        }
+    }
+    TEST_ASSERT(init_failures == 0);
+
+    /* Chaque capteur renvoie SA température (2000 + d, +5 par lecture) */
+    int mismatches = 0;
+    for (int i = 0; i < N_BUSES * DEVS_PER_BUS; i++) {
+        int16_t temp = 0;
+        if (sensor_read_temperature_centi(&sensors[i], &temp) != SENSOR_OK ||
+            temp != devs[i].fake_temp_centi) {
+            mismatches++;
+        }
+    }
+    TEST_ASSERT(mismatches == 0);
+    TEST_ASSERT(devs[DEVS_PER_BUS - 1].fake_temp_centi == 2000 + (DEVS_PER_BUS - 1) + 2 * 5);
+
+    /* Adresse sans capteur : NACK */
+    sensor_t ghost;
+    TEST_ASSERT(sensor_init(&ghost, 0x08, &buses[0], NULL, &log) == SENSOR_ERR);
+    TEST_ASSERT(bus_ctx[0].nack_count == 1);
+
+    free(sensors);
+    free(devs);
+    free(bus_ctx);
+}
+
+/*
+    Test 7 : file SPSC, lecture capteur -> push -> pop par lot,
+    puis débordement compté.
+*/
+static void test_ring_basic(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    hal_log_t log;
+    hal_log_stdio_init(&log);
+
+    sensor_t s;
+    TEST_ASSERT(sensor_init(&s, 0x50, &bus, NULL, &log) == SENSOR_OK);
+
+    sensor_sample_t buf[4];
+    sensor_ring_t ring;
+    TEST_ASSERT(sensor_ring_init(&ring, buf, 3) == SENSOR_ERR); // pas une puissance de 2
+    TEST_ASSERT(sensor_ring_init(&ring, buf, 4) == SENSOR_OK);
+
+    for (uint64_t t = 0; t < 4; t++) {
+        TEST_ASSERT(sensor_read_to_ring(&s, &ring, 7, 1000 * t) == SENSOR_OK);
+    }
+
+    /* Pleine : l'échantillon est perdu et compté */
+    TEST_ASSERT(sensor_read_to_ring(&s, &ring, 7, 4000) == SENSOR_ERR);
+    TEST_ASSERT(sensor_ring_dropped(&ring) == 1);
+
+    sensor_sample_t out[8];
+    TEST_ASSERT(sensor_ring_pop_batch(&ring, out, 3) == 3);
+    TEST_ASSERT(out[0].t_us == 0 && out[2].t_us == 2000);
+    TEST_ASSERT(out[0].sensor_id == 7);
+    TEST_ASSERT(out[1].value - out[0].value == 5);
+
+    TEST_ASSERT(sensor_ring_pop_batch(&ring, out, 8) == 1);
+    TEST_ASSERT(out[0].t_us == 3000);
+    TEST_ASSERT(sensor_ring_pop_batch(&ring, out, 8) == 0);
+}
+
+/*
+    Producteur du test 8 : pousse des t_us croissants, réessaie si pleine.
+*/
+#define RING_TEST_COUNT 200000u
+
+static void *ring_producer(void *arg)
+{
+    sensor_ring_t *ring = (sensor_ring_t *)arg;
+
+    for (uint64_t i = 0; i < RING_TEST_COUNT; i++) {
+        sensor_sample_t smp = { .t_us = i, .value = (int16_t)i };
+        while (sensor_ring_push(ring, &smp) != SENSOR_OK) {
+            sched_yield(); /* file pleine : on laisse le consommateur avancer */
+        }
+    }
+
+    return NULL;
+}
+
+/*
+    Test 8 : un producteur et un consommateur en parallèle.
+    Le producteur réessaie sur file pleine : aucun échantillon
+    ne doit manquer ni arriver dans le désordre.
+*/
+static void test_ring_threads(void)
+{
+    static sensor_sample_t buf[256];
+    sensor_ring_t ring;
+    TEST_ASSERT(sensor_ring_init(&ring, buf, 256) == SENSOR_OK);
+
+    pthread_t producer;
+    TEST_ASSERT(pthread_create(&producer, NULL, ring_producer, &ring) == 0);
+
+    uint64_t expected = 0;
+    int out_of_order = 0;
+    sensor_sample_t out[32];
+
+    while (expected < RING_TEST_COUNT) {
+        size_t n = sensor_ring_pop_batch(&ring, out, 32);
+        if (n == 0) {
+            sched_yield();
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (out[i].t_us != expected || out[i].value != (int16_t)expected) {
+                out_of_order++;
+            }
+            expected++;
+        }
+    }
+
+    pthread_join(producer, NULL);
+    TEST_ASSERT(out_of_order == 0);
+    TEST_ASSERT(expected == RING_TEST_COUNT);
+}
+
+/*
+    Logger de test : compte les messages par niveau, n'affiche rien.
+*/
+static int g_log_count[3];
+
+/* Logs d'erreur attendus du driver (aucun s'il est compilé sans) */
+#if HAL_LOG_MIN_LEVEL <= 2
+#define DRIVER_ERR_LOGS(n) (n)
+#else
+#define DRIVER_ERR_LOGS(n) 0
+#endif
+
+static void counting_log(void *ctx, hal_log_level_t level, const char *fmt, ...)
+{
+    (void)ctx;
+    (void)fmt;
+    if ((int)level >= 0 && (int)level < 3) {
+        g_log_count[level]++;
+    }
+}
+
+/*
+    Test 9 : une rafale d'erreurs bus est limitée par fenêtre et par capteur,
+    et une nouvelle fenêtre signale les messages jetés.
+*/
+static void test_log_rate_limit(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_multi_ctx_t bus_ctx;
+    hal_bus_fake_multi_init(&bus_ctx, &bus); // aucun capteur : tout est NACK
+
+    hal_log_t log = { .ctx = NULL, .log = counting_log };
+    memset(g_log_count, 0, sizeof(g_log_count));
+
+    /* Sans horloge : une fenêtre = HAL_LOG_RL_WINDOW_EVENTS messages */
+    sensor_t s = { .dev_addr = 0x50, .bus = &bus, .time = NULL, .log = &log };
+
+    int errors = 0;
+    for (int i = 0; i < 1000; i++) {
+        int16_t temp;
+        if (sensor_read_temperature_centi(&s, &temp) == SENSOR_ERR) {
+            errors++;
+        }
+    }
+
+    TEST_ASSERT(errors == 1000);
+    TEST_ASSERT(g_log_count[HAL_LOG_ERR] == DRIVER_ERR_LOGS(4)); // burst
+
+    /* Un autre capteur n'est pas rendu muet par le premier */
+    sensor_t other = { .dev_addr = 0x51, .bus = &bus, .time = NULL, .log = &log };
+    int16_t temp;
+    TEST_ASSERT(sensor_read_temperature_centi(&other, &temp) == SENSOR_ERR);
+    TEST_ASSERT(g_log_count[HAL_LOG_ERR] == DRIVER_ERR_LOGS(5));
+
+    /* Avec horloge : la rafale suivante repasse, précédée du nombre de jetés */
+    hal_time_t time;
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 1000u);
+    sensor_set_clock(&s, &time);
+    atomic_init(&s.log_rl.state, 0);
+    memset(g_log_count, 0, sizeof(g_log_count));
+
+    for (int i = 0; i < 100; i++) {
+        sensor_read_temperature_centi(&s, &temp);
+    }
+    TEST_ASSERT(g_log_count[HAL_LOG_ERR] == DRIVER_ERR_LOGS(4));
+
+    hal_time_sim_advance_ns(&time_ctx, HAL_LOG_RL_WINDOW_NS);
+    sensor_read_temperature_centi(&s, &temp);
+    TEST_ASSERT(g_log_count[HAL_LOG_ERR] == DRIVER_ERR_LOGS(4 + 2)); // "96 messages suppressed" + l'erreur
+
+    /* Le limiteur seul : 3 passent, puis les jetés sont rapportés */
+    hal_log_ratelimit_t rl = {0};
+    uint32_t dropped = 0;
+    int allowed = 0;
+    for (int i = 0; i < 16; i++) {
+        allowed += hal_log_ratelimit_allow(&rl, 5, 3, &dropped);
+    }
+    TEST_ASSERT(allowed == 3);
+    TEST_ASSERT(hal_log_ratelimit_allow(&rl, 5 + HAL_LOG_RL_WINDOW_NS, 3, &dropped));
+    TEST_ASSERT(dropped == 13);
+    TEST_ASSERT(hal_log_ratelimit_allow(&rl, 5 + HAL_LOG_RL_WINDOW_NS, 3, &dropped));
+    TEST_ASSERT(dropped == 0);
+
+    /* Sans horloge : nouvelle fenêtre après HAL_LOG_RL_WINDOW_EVENTS messages */
+    hal_log_ratelimit_t ev = {0};
+    allowed = 0;
+    for (unsigned i = 0; i < HAL_LOG_RL_WINDOW_EVENTS; i++) {
+        allowed += hal_log_ratelimit_allow(&ev, 0, 2, &dropped);
+    }
+    TEST_ASSERT(allowed == 2);
+    TEST_ASSERT(hal_log_ratelimit_allow(&ev, 0, 2, &dropped));
+    TEST_ASSERT(dropped == HAL_LOG_RL_WINDOW_EVENTS - 2);
+}
+
+/*
+    Test 10 : le délai d'init avance l'horloge virtuelle,
+    et les échantillons sont horodatés par la HAL time.
+*/
+static void test_sim_time_stamps(void)
+{
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    hal_time_t time;
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 5000000u); // 5 ms
+
+    sensor_t s;
+    TEST_ASSERT(sensor_init(&s, 0x50, &bus, &time, NULL) == SENSOR_OK);
+    TEST_ASSERT(time_ctx.now_ns == 15000000u); // + 10 ms de délai d'init
+    TEST_ASSERT(sensor_timestamp_us(&s) == 0);   // pas d'horloge donnée
+    TEST_ASSERT(sensor_set_clock(&s, &time) == SENSOR_OK);
+    TEST_ASSERT(sensor_timestamp_us(&s) == 15000u);
+
+    sensor_sample_t buf[4];
+    sensor_ring_t ring;
+    sensor_ring_init(&ring, buf, 4);
+
+    hal_time_sim_advance_ns(&time_ctx, 250000u);
+    TEST_ASSERT(sensor_read_to_ring(&s, &ring, 1, sensor_timestamp_us(&s)) == SENSOR_OK);
+
+    sensor_sample_t out;
+    TEST_ASSERT(sensor_ring_pop_batch(&ring, &out, 1) == 1);
+    TEST_ASSERT(out.t_us == 15250u);
+
+    /* Sans horloge */
+    TEST_ASSERT(sensor_set_clock(&s, NULL) == SENSOR_OK);
+    TEST_ASSERT(sensor_timestamp_us(&s) == 0);
+
+    /* HAL time d'une plateforme antérieure à now_ns : jamais lu par le driver */
+    hal_time_t legacy;
+    memset(&legacy, 0xA5, sizeof(legacy));
+    legacy.ctx = &time_ctx;
+    legacy.delay_ms = time.delay_ms;
+    TEST_ASSERT(sensor_init(&s, 0x50, &bus, &legacy, NULL) == SENSOR_OK);
+    TEST_ASSERT(time_ctx.now_ns == 25250000u);   // délai d'init passé par delay_ms
+    TEST_ASSERT(sensor_timestamp_us(&s) == 0);
+}
+
+/*
+    Test 11 : ordonnanceur coopératif minimal sur 100 capteurs.
+    Les délais d'init se recouvrent : ~10 ms virtuelles au total,
+    pas 100 x 10 ms.
+*/
+static void test_op_overlapped_init(void)
+{
+    enum { N = 100, ADDR_BASE = 0x10 };
+
+    hal_bus_t bus;
+    hal_bus_fake_multi_ctx_t bus_ctx;
+    hal_bus_fake_multi_init(&bus_ctx, &bus);
+
+    static hal_bus_fake_ctx_t devs[N];
+    static sensor_t sensors[N];
+    static sensor_op_t ops[N];
+
+    hal_time_t time;
+    hal_time_sim_ctx_t time_ctx;
+    hal_time_sim_init(&time_ctx, &time, 0);
+
+    for (int i = 0; i < N; i++) {
+        hal_bus_fake_dev_init(&devs[i]);
+        hal_bus_fake_multi_attach(&bus_ctx, (uint8_t)(ADDR_BASE + i), &devs[i]);
+    }
+    devs[N - 1].regs[REG_WHO_AM_I] = 0x00; // un capteur défectueux
+
+    /* Appel refusé (op NULL) : le capteur n'est pas touché */
+    sensors[0].dev_addr = 0xA5;
+    TEST_ASSERT(sensor_init_start(NULL, &sensors[0], ADDR_BASE, &bus, &time, NULL) == SENSOR_ERR);
+    TEST_ASSERT(sensors[0].dev_addr == 0xA5 && sensors[0].bus == NULL);
+
+    for (int i = 0; i < N; i++) {
+        TEST_ASSERT(sensor_init_start(&ops[i], &sensors[i], (uint8_t)(ADDR_BASE + i),
+                                      &bus, &time, NULL) == SENSOR_PENDING);
+    }
+
+    /* Boucle : avancer chaque op prête, puis sauter au prochain réveil */
+    int pending = N;
+    int rounds = 0;
+    while (pending > 0 && rounds < 10) {
+        uint64_t now = hal_time_now_us(&time);
+        uint64_t next_wake = UINT64_MAX;
+        pending = 0;
+
+        for (int i = 0; i < N; i++) {
+            if (sensor_op_step(&ops[i], now) == SENSOR_PENDING) {
+                pending++;
+                if (ops[i].wake_at_us < next_wake) {
+                    next_wake = ops[i].wake_at_us;
+                }
+            }
+        }
+
+        if (pending > 0 && next_wake > now) {
+            hal_time_sim_advance_ns(&time_ctx, (next_wake - now) * 1000u);
+        }
+        rounds++;
+    }
+
+    TEST_ASSERT(pending == 0);
+    TEST_ASSERT(rounds == 2);
+    TEST_ASSERT(time_ctx.now_ns == SENSOR_INIT_DELAY_MS * 1000000u);
+
+    int ok = 0;
+    for (int i = 0; i < N; i++) {
+        ok += (ops[i].result == SENSOR_OK);
+    }
+    TEST_ASSERT(ok == N - 1);
+    TEST_ASSERT(ops[N - 1].result == SENSOR_BAD_ID);
+
+    /* Lecture non bloquante : terminée en une étape */
+    sensor_op_t rd;
+    TEST_ASSERT(sensor_read_temperature_start(&rd, &sensors[0]) == SENSOR_PENDING);
+    TEST_ASSERT(sensor_op_step(&rd, hal_time_now_us(&time)) == SENSOR_OK);
+    TEST_ASSERT(rd.temp_centi == devs[0].fake_temp_centi);
+    TEST_ASSERT(sensor_op_step(&rd, 0) == SENSOR_OK);
+}
+
+/*
+    Bus espion : compte les transactions puis délègue au vrai bus.
+*/
+typedef struct {
+    const hal_bus_t *inner;
+    int reads;
+    int writes;
+    uint8_t last_reg; // dernière lecture
+    size_t last_len;
+} spy_bus_ctx_t;
+
+static hal_status_t spy_reg_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *data, size_t len)
+{
+    spy_bus_ctx_t *spy = (spy_bus_ctx_t *)ctx;
+    spy->reads++;
+    spy->last_reg = reg;
+    spy->last_len = len;
+    return spy->inner->reg_read(spy->inner->ctx, dev_addr, reg, data, len);
+}
+
+static hal_status_t spy_reg_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *data, size_t len)
+{
+    spy_bus_ctx_t *spy = (spy_bus_ctx_t *)ctx;
+    spy->writes++;
+    return spy->inner->reg_write(spy->inner->ctx, dev_addr, reg, data, len);
+}
+
+static void spy_bus_init(spy_bus_ctx_t *spy, hal_bus_t *bus, const hal_bus_t *inner)
+{
+    spy->inner = inner;
+    spy->reads = 0;
+    spy->writes = 0;
+    spy->last_reg = 0;
+    spy->last_len = 0;
+    hal_bus_init(bus);
+    bus->ctx = spy;
+    bus->reg_read = spy_reg_read;
+    bus->reg_write = spy_reg_write;
+    bus->xfer = NULL;   // repli générique : chaque segment passe par le spy
+}
+
+/*
+    Test 12 : cache shadow.
+    - WHO_AM_I n'est lu qu'une fois sur le bus
+    - les écritures de config sont différées puis fusionnées au flush
+*/
+static void test_shadow_cache(void)
+{
+    hal_bus_t fake;
+    hal_bus_fake_ctx_t fake_ctx;
+    hal_bus_fake_init(&fake_ctx, &fake);
+
+    hal_bus_t bus;
+    spy_bus_ctx_t spy;
+    spy_bus_init(&spy, &bus, &fake);
+
+    sensor_t s;
+    TEST_ASSERT(sensor_init(&s, 0x50, &bus, NULL, NULL) == SENSOR_OK);
+    TEST_ASSERT(spy.reads == 1);
+
+    uint8_t id = 0;
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT(sensor_get_id(&s, &id) == SENSOR_OK && id == EXPECTED_ID);
+    }
+    TEST_ASSERT(spy.reads == 1);
+
+    /* La température est volatile : toujours lue sur le bus */
+    int16_t temp;
+    sensor_read_temperature_centi(&s, &temp);
+    sensor_read_temperature_centi(&s, &temp);
+    TEST_ASSERT(spy.reads == 3);
+
+    /* Écritures différées : rien sur le bus avant le flush */
+    uint8_t v[2] = {0xA0, 0xA1};
+    TEST_ASSERT(sensor_reg_write(&s, 0x30, v, 2) == SENSOR_OK);
+    uint8_t w = 0xB8;
+    TEST_ASSERT(sensor_reg_write(&s, 0x38, &w, 1) == SENSOR_OK);
+    TEST_ASSERT(spy.writes == 0);
+    TEST_ASSERT(fake_ctx.regs[0x30] == 0x00);
+
+    /* Relecture : la valeur en attente est servie par le cache */
+    uint8_t back = 0;
+    TEST_ASSERT(sensor_reg_read(&s, 0x38, &back, 1) == SENSOR_OK && back == 0xB8);
+    TEST_ASSERT(spy.reads == 3);
+
+    /* 0x30-0x31 et 0x38 sont trop loin : deux rafales */
+    TEST_ASSERT(sensor_flush(&s) == SENSOR_OK);
+    TEST_ASSERT(spy.writes == 2);
+    TEST_ASSERT(fake_ctx.regs[0x30] == 0xA0 && fake_ctx.regs[0x31] == 0xA1);
+    TEST_ASSERT(fake_ctx.regs[0x38] == 0xB8);
+
+    /* 0x32 connu (lu), 0x30 et 0x33 sales : une seule rafale 0x30..0x33 */
+    TEST_ASSERT(sensor_reg_read(&s, 0x32, &back, 1) == SENSOR_OK);
+    uint8_t x = 0xC0, y = 0xC3;
+    sensor_reg_write(&s, 0x30, &x, 1);
+    sensor_reg_write(&s, 0x33, &y, 1);
+    TEST_ASSERT(sensor_flush(&s) == SENSOR_OK);
+    TEST_ASSERT(spy.writes == 3);
+    TEST_ASSERT(fake_ctx.regs[0x30] == 0xC0 && fake_ctx.regs[0x33] == 0xC3);
+    TEST_ASSERT(fake_ctx.regs[0x31] == 0xA1);
+
+    /* Rien de sale : flush sans transaction */
+    TEST_ASSERT(sensor_flush(&s) == SENSOR_OK);
+    TEST_ASSERT(spy.writes == 3);
+
+    /* WHO_AM_I en lecture seule : refusé par le driver, ni en cache ni au flush */
+    uint8_t bogus[2] = {0x99, 0x05};
+    TEST_ASSERT(sensor_reg_write(&s, REG_WHO_AM_I, bogus, 1) == SENSOR_ERR);
+    TEST_ASSERT(sensor_reg_write(&s, REG_WHO_AM_I, bogus, 2) == SENSOR_ERR); // WHO_AM_I + CTRL
+    TEST_ASSERT(sensor_reg_write(&s, 0x40, bogus, 1) == SENSOR_ERR);         // hors carte
+    TEST_ASSERT(sensor_get_id(&s, &id) == SENSOR_OK && id == EXPECTED_ID);
+    TEST_ASSERT(sensor_flush(&s) == SENSOR_OK);
+    TEST_ASSERT(spy.writes == 3);
+
+    /* ... et ignoré par le capteur simulé */
+    TEST_ASSERT(fake.reg_write(fake.ctx, 0x50, REG_WHO_AM_I, bogus, 2) == HAL_OK);
+    TEST_ASSERT(fake.reg_read(fake.ctx, 0x50, REG_WHO_AM_I, &back, 1) == HAL_OK);
+    TEST_ASSERT(back == EXPECTED_ID);
+    TEST_ASSERT(fake_ctx.regs[SENSOR_REG_CTRL] == 0x05);
+}
+
+/*
+    Transfert vectorisé du fake, compté (test 13).
+*/
+static int g_xfer_calls;
+
+static hal_status_t counting_xfer(void *ctx, const hal_bus_seg_t *segs, size_t n)
+{
+    g_xfer_calls++;
+    return hal_bus_fake_xfer(ctx, segs, n);
+}
+
+/*
+    Test 13 : lecture groupée de champs.
+    - STATUS + TEMP contigus : une seule rafale
+    - WHO_AM_I servi par le cache
+    - FIFO_STATUS trop loin : rafale séparée
+    - FIFO_DATA (flux) toujours lu seul
+    - transfert vectorisé natif seulement après sensor_set_bus_xfer
+*/
+static void test_read_fields_coalesced(void)
+{
+    hal_bus_t fake;
+    hal_bus_fake_ctx_t fake_ctx;
+    hal_bus_fake_init(&fake_ctx, &fake);
+
+    hal_bus_t bus;
+    spy_bus_ctx_t spy;
+    spy_bus_init(&spy, &bus, &fake);
+
+    sensor_t s;
+    TEST_ASSERT(sensor_init(&s, 0x50, &bus, NULL, NULL) == SENSOR_OK);
+
+    const sensor_field_t fields[] = {
+        SENSOR_FIELD_TEMP,
+        SENSOR_FIELD_FIFO_STATUS,
+        SENSOR_FIELD_WHO_AM_I,
+        SENSOR_FIELD_STATUS,
+    };
+    int32_t v[4] = {0};
+
+    int before = spy.reads;
+    TEST_ASSERT(sensor_read_fields(&s, fields, 4, v) == SENSOR_OK);
+    TEST_ASSERT(spy.reads - before == 2);
+
+    /* Valeurs rendues dans l'ordre de la demande */
+    /* (la rafale FIFO_STATUS, lue après, a encore avancé la température) */
+    TEST_ASSERT(v[0] == fake_ctx.fake_temp_centi - 5);
+    TEST_ASSERT(v[1] == 0);
+    TEST_ASSERT(v[2] == EXPECTED_ID);
+    TEST_ASSERT(v[3] == SENSOR_STATUS_DRDY);
+
+    /* Température négative : extension de signe */
+    fake_ctx.fake_temp_centi = -505;
+    const sensor_field_t temp_only = SENSOR_FIELD_TEMP;
+    TEST_ASSERT(sensor_read_fields(&s, &temp_only, 1, v) == SENSOR_OK);
+    TEST_ASSERT(v[0] == -500);
+    TEST_ASSERT(spy.last_reg == SENSOR_REG_TEMP && spy.last_len == 2);
+
+    /* FIFO_CTRL (0x20) + FIFO_DATA (0x22, flux) : jamais fusionnés */
+    hal_bus_fake_fifo_fill(&fake_ctx, 1);
+    const sensor_field_t fifo[] = { SENSOR_FIELD_FIFO_DATA, SENSOR_FIELD_FIFO_CTRL };
+    before = spy.reads;
+    TEST_ASSERT(sensor_read_fields(&s, fifo, 2, v) == SENSOR_OK);
+    TEST_ASSERT(spy.reads - before == 2);
+    TEST_ASSERT(spy.last_reg == SENSOR_REG_FIFO_DATA && spy.last_len == 2);
+    TEST_ASSERT(fake_ctx.fifo_count == 0);
+
+    /* WHO_AM_I (en cache) + CTRL (inconnu) : une rafale 0x00..0x01 */
+    const sensor_field_t cfg[] = { SENSOR_FIELD_CTRL, SENSOR_FIELD_WHO_AM_I };
+    before = spy.reads;
+    TEST_ASSERT(sensor_read_fields(&s, cfg, 2, v) == SENSOR_OK);
+    TEST_ASSERT(spy.reads - before == 1);
+    TEST_ASSERT(spy.last_reg == SENSOR_REG_WHO_AM_I && spy.last_len == 2);
+    TEST_ASSERT(v[0] == 0 && v[1] == EXPECTED_ID);
+
+    /* Deuxième fois : tout vient du cache */
+    TEST_ASSERT(sensor_read_fields(&s, cfg, 2, v) == SENSOR_OK);
+    TEST_ASSERT(spy.reads - before == 1);
+
+    /* Champ inconnu : erreur */
+    const sensor_field_t bad = SENSOR_FIELD_COUNT;
+    TEST_ASSERT(sensor_read_fields(&s, &bad, 1, v) == SENSOR_ERR);
+
+    /* Backend antérieur à xfer (champ indéterminé) : jamais lu par le driver */
+    hal_bus_t legacy;
+    memset(&legacy, 0xA5, sizeof(legacy));
+    legacy.ctx = fake.ctx;
+    legacy.reg_read = fake.reg_read;
+    legacy.reg_write = fake.reg_write;
+
+    sensor_t old;
+    TEST_ASSERT(sensor_init(&old, 0x50, &legacy, NULL, NULL) == SENSOR_OK);
+    TEST_ASSERT(sensor_read_fields(&old, fields, 4, v) == SENSOR_OK);
+    TEST_ASSERT(v[2] == EXPECTED_ID);
+
+    /* Transfert natif sur demande : les deux rafales en un appel */
+    g_xfer_calls = 0;
+    TEST_ASSERT(sensor_set_bus_xfer(&old, counting_xfer) == SENSOR_OK);
+    TEST_ASSERT(sensor_read_fields(&old, fields, 4, v) == SENSOR_OK);
+    TEST_ASSERT(g_xfer_calls == 1);
+    TEST_ASSERT(v[2] == EXPECTED_ID && v[3] == SENSOR_STATUS_DRDY);
+}
+
+/*
+    Test 14 : kernels de conversion.
+    Chaque implémentation disponible doit donner le même résultat
+    que la référence, pour toutes les longueurs (blocs + reste).
+*/
+static void test_convert_kernels(void)
+{
+    enum { N = 77 };
+    uint8_t raw[2 * N];
+    uint32_t x = 12345;
+
+    for (size_t i = 0; i < sizeof(raw); i++) {
+        x = x * 1103515245u + 12345u;
+        raw[i] = (uint8_t)(x >> 16);
+    }
+    raw[0] = 0x80; raw[1] = 0x00; // -32768
+    raw[2] = 0x7F; raw[3] = 0xFF; // 32767
+
+    const sensor_convert_isa_t isas[] = {
+        SENSOR_CONVERT_SCALAR, SENSOR_CONVERT_SSE2, SENSOR_CONVERT_AVX2, SENSOR_CONVERT_NEON
+    };
+
+    int tested = 0;
+    for (size_t k = 0; k < sizeof(isas) / sizeof(isas[0]); k++) {
+        if (sensor_convert_select(isas[k]) != SENSOR_OK)
+            continue;
+        TEST_ASSERT(sensor_convert_active() == isas[k]);
+        tested++;
+
+        for (size_t n = 0; n <= N; n += (n < 20) ? 1 : 19) {
+            int16_t centi[N];
+            float f[N];
+            int32_t q[N];
+
+            sensor_convert_be16_to_centi(raw, centi, n);
+            sensor_convert_be16_to_float(raw, f, n, 0.01f, -1.5f);
+            sensor_convert_be16_to_fixed(raw, q, n, -300, 1 << 20);
+
+            int ok = 1;
+            for (size_t i = 0; i < n; i++) {
+                int16_t ref = (int16_t)(((uint16_t)raw[2 * i] << 8) | raw[2 * i + 1]);
+                float fref = (float)ref * 0.01f - 1.5f;
+                float err = f[i] - fref;
+
+                ok &= centi[i] == ref;
+                ok &= q[i] == (int32_t)ref * -300 + (1 << 20);
+                ok &= err < 1e-3f && err > -1e-3f;
+            }
+            TEST_ASSERT(ok);
+        }
+    }
+    TEST_ASSERT(tested >= 1);
+
+    /* Implémentation absente ou invalide : refusée */
+    TEST_ASSERT(sensor_convert_select((sensor_convert_isa_t)99) == SENSOR_ERR);
+
+    TEST_ASSERT(sensor_convert_select(SENSOR_CONVERT_AUTO) == SENSOR_OK);
+    TEST_ASSERT(sensor_convert_active() != SENSOR_CONVERT_AUTO);
+    printf("convert: %d implementation(s), active = %s\n",
+           tested, sensor_convert_isa_name(sensor_convert_active()));
+}
+
+/*
+    Test 15 : calibration en virgule fixe.
+    - polynôme (gain/offset, terme quadratique, ajustement cubique, bornes)
+    - LUT (interpolation, extrapolation, saturation)
+    - appliquée par le driver, en unitaire et par lot
+*/
+static void test_calibration(void)
+{
+    sensor_cal_t poly;
+    sensor_cal_t lut;
+
+    /* y = -50 + 1.01 x */
+    const int64_t lin[] = { -50 * SENSOR_CAL_UNIT(0), SENSOR_CAL_UNIT(1) * 101 / 100 };
+    TEST_ASSERT(sensor_cal_init_poly(&poly, lin, 2) == SENSOR_OK);
+    TEST_ASSERT(sensor_cal_apply(&poly, 2500) == 2475);
+    TEST_ASSERT(sensor_cal_apply(&poly, -1000) == -1060);
+    TEST_ASSERT(sensor_cal_apply(&poly, 32767) == INT16_MAX); // saturé
+
+    /* y = x + 0.0001 x^2 */
+    const int64_t quad[] = { 0, SENSOR_CAL_UNIT(1), SENSOR_CAL_UNIT(2) / 10000 };
+    TEST_ASSERT(sensor_cal_init_poly(&poly, quad, 3) == SENSOR_OK);
+    TEST_ASSERT(sensor_cal_apply(&poly, 1000) == 1100);
+    TEST_ASSERT(sensor_cal_apply(&poly, -1000) == -900);
+
+    TEST_ASSERT(sensor_cal_init_poly(&poly, quad, 0) == SENSOR_ERR);
+    TEST_ASSERT(sensor_cal_init_poly(&poly, quad, 5) == SENSOR_ERR);
+
+    /*
+        Ajustement cubique réaliste (type thermistance linéarisée) :
+        y = 12.5 + 0.98 x + 2.1e-6 x^2 - 1.5e-10 x^3
+        À x = 10000 les termes x^2 et x^3 pèsent +210 et -150 centi-degrés ;
+        écart à la référence flottante <= 1 sur toute la plage int16.
+    */
+    const double fit[] = { 12.5, 0.98, 2.1e-6, -1.5e-10 };
+    int64_t cubic[4];
+    for (int k = 0; k < 4; k++) {
+        double c = fit[k] * (double)SENSOR_CAL_UNIT(k);
+        cubic[k] = (int64_t)(c < 0 ? c - 0.5 : c + 0.5);
+    }
+    TEST_ASSERT(sensor_cal_init_poly(&poly, cubic, 4) == SENSOR_OK);
+    int max_err = 0;
+    for (int x = INT16_MIN; x <= INT16_MAX; x += 7) {
+        double ref = fit[0] + x * (fit[1] + x * (fit[2] + x * fit[3]));
+        int err = sensor_cal_apply(&poly, (int16_t)x) - (int)(ref < 0 ? ref - 0.5 : ref + 0.5);
+        err = err < 0 ? -err : err;
+        max_err = err > max_err ? err : max_err;
+    }
+    TEST_ASSERT(max_err <= 1);
+
+    /* Coefficients qui pourraient déborder sur la plage int16 : refusés */
+    const int64_t huge[] = { 0, 0, 0, INT64_MAX };
+    const int64_t edge[] = { SENSOR_CAL_COEF_SUM_MAX / 2, 0, 0, SENSOR_CAL_COEF_SUM_MAX / 2 };
+    const int64_t over[] = { SENSOR_CAL_COEF_SUM_MAX / 2, 0, 0, -(SENSOR_CAL_COEF_SUM_MAX / 2) - 1 };
+    TEST_ASSERT(sensor_cal_init_poly(&poly, huge, 4) == SENSOR_ERR);
+    TEST_ASSERT(sensor_cal_init_poly(&poly, edge, 4) == SENSOR_OK);
+    TEST_ASSERT(sensor_cal_apply(&poly, INT16_MIN) == 0);
+    TEST_ASSERT(sensor_cal_init_poly(&poly, over, 4) == SENSOR_ERR);
+
+    /* Table : 0 -> 10, 1000 -> 1030, 2000 -> 2000 */
+    const int16_t lx[] = { 0, 1000, 2000 };
+    const int16_t ly[] = { 10, 1030, 2000 };
+    TEST_ASSERT(sensor_cal_init_lut(&lut, lx, ly, 3) == SENSOR_OK);
+    TEST_ASSERT(sensor_cal_apply(&lut, 0) == 10);
+    TEST_ASSERT(sensor_cal_apply(&lut, 500) == 520);
+    TEST_ASSERT(sensor_cal_apply(&lut, 1000) == 1030);
+    TEST_ASSERT(sensor_cal_apply(&lut, 1500) == 1515);
+    TEST_ASSERT(sensor_cal_apply(&lut, -100) == -92);  // 1er segment prolongé
+    TEST_ASSERT(sensor_cal_apply(&lut, 3000) == 2970); // dernier segment prolongé
+
+    const int16_t bad_x[] = { 0, 0 };
+    TEST_ASSERT(sensor_cal_init_lut(&lut, bad_x, ly, 2) == SENSOR_ERR);
+    TEST_ASSERT(sensor_cal_init_lut(&lut, lx, ly, 3) == SENSOR_OK);
+
+    /* Lot = unitaire, en place */
+    int16_t v[5] = { -100, 0, 750, 1999, 3000 };
+    int16_t ref[5];
+    for (int i = 0; i < 5; i++) {
+        ref[i] = sensor_cal_apply(&lut, v[i]);
+    }
+    sensor_cal_apply_batch(&lut, v, v, 5);
+    TEST_ASSERT(memcmp(v, ref, sizeof(v)) == 0);
+
+    /* Attachée au capteur */
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+
+    sensor_t s;
+    TEST_ASSERT(sensor_init(&s, 0x50, &bus, NULL, NULL) == SENSOR_OK);
+    TEST_ASSERT(sensor_cal_init_poly(&poly, lin, 2) == SENSOR_OK);
+    TEST_ASSERT(sensor_set_calibration(&s, &poly) == SENSOR_OK);
+
+    int16_t t = 0;
+    TEST_ASSERT(sensor_read_temperature_centi(&s, &t) == SENSOR_OK);
+    TEST_ASSERT(t == sensor_cal_apply(&poly, bus_ctx.fake_temp_centi));
+
+    int16_t samples[8];
+    size_t n = 0;
+    int16_t first_raw = (int16_t)(bus_ctx.fake_temp_centi + 5);
+    hal_bus_fake_fifo_fill(&bus_ctx, 8);
+    TEST_ASSERT(sensor_read_samples(&s, samples, 8, &n) == SENSOR_OK && n == 8);
+    TEST_ASSERT(samples[0] == sensor_cal_apply(&poly, first_raw));
+
+    /* Détachée : valeurs brutes */
+    TEST_ASSERT(sensor_set_calibration(&s, NULL) == SENSOR_OK);
+    TEST_ASSERT(sensor_read_temperature_centi(&s, &t) == SENSOR_OK);
+    TEST_ASSERT(t == bus_ctx.fake_temp_centi);
+}
+
+/*
+    Test 16 : filtres en flux.
+    - signal constant : chaque étage rend la constante dès le début
+    - médiane 3 (SIMD) = référence scalaire, en place, découpage quelconque
+    - CIC : décimation et gain unitaire ; pipeline complet
+*/
+static int16_t ref_med3(int16_t a, int16_t b, int16_t c)
+{
+    if ((a <= b && b <= c) || (c <= b && b <= a)) return b;
+    if ((b <= a && a <= c) || (c <= a && a <= b)) return a;
+    return c;
+}
+
+static void test_filters(void)
+{
+    sensor_filter_t f;
+    int16_t buf[64];
+    size_t n;
+
+    /* Constante : aucun transitoire */
+    TEST_ASSERT(sensor_filter_init_ma(&f, 5) == SENSOR_OK);
+    for (int i = 0; i < 64; i++) buf[i] = -1234;
+    TEST_ASSERT(sensor_filter_process(&f, buf, buf, 64) == 64);
+    TEST_ASSERT(buf[0] == -1234 && buf[63] == -1234);
+
+    TEST_ASSERT(sensor_filter_init_iir1(&f, 3) == SENSOR_OK);
+    for (int i = 0; i < 64; i++) buf[i] = 2500;
+    sensor_filter_process(&f, buf, buf, 64);
+    TEST_ASSERT(buf[0] == 2500 && buf[63] == 2500);
+
+    TEST_ASSERT(sensor_filter_init_cic(&f, 3, 8) == SENSOR_OK);
+    for (int i = 0; i < 64; i++) buf[i] = -700;
+    n = sensor_filter_process(&f, buf, buf, 64);
+    TEST_ASSERT(n == 8);
+    TEST_ASSERT(buf[0] == -700 && buf[7] == -700);
+
+    /* MA : échelon 0 -> 400 sur 4 échantillons */
+    TEST_ASSERT(sensor_filter_init_ma(&f, 4) == SENSOR_OK);
+    int16_t step[6] = { 0, 400, 400, 400, 400, 400 };
+    sensor_filter_process(&f, step, step, 6);
+    TEST_ASSERT(step[1] == 100 && step[2] == 200 && step[4] == 400);
+
+    /* IIR : converge vers l'échelon */
+    TEST_ASSERT(sensor_filter_init_iir1(&f, 2) == SENSOR_OK);
+    int16_t x0 = 0;
+    sensor_filter_process(&f, &x0, &x0, 1);
+    for (int i = 0; i < 64; i++) buf[i] = 1000;
+    sensor_filter_process(&f, buf, buf, 64);
+    TEST_ASSERT(buf[0] == 250 && buf[1] == 438 && buf[63] == 1000);
+
+    /* Médiane 3 : référence, en place, blocs de tailles variées */
+    int16_t src[61];
+    uint32_t r = 7;
+    for (int i = 0; i < 61; i++) {
+        r = r * 1103515245u + 12345u;
+        src[i] = (int16_t)(r >> 16);
+    }
+    src[10] = INT16_MIN; src[30] = INT16_MAX; // pics isolés
+
+    int16_t ref[61];
+    for (int i = 0; i < 61; i++) {
+        int16_t a = src[i >= 2 ? i - 2 : 0];
+        int16_t b = src[i >= 1 ? i - 1 : 0];
+        ref[i] = ref_med3(a, b, src[i]);
+    }
+
+    TEST_ASSERT(sensor_filter_init_median(&f, 3) == SENSOR_OK);
+    memcpy(buf, src, sizeof(src));
+    size_t chunks[] = { 1, 9, 16, 3, 32 };
+    size_t off = 0;
+    for (size_t k = 0; k < 5; k++) {
+        sensor_filter_process(&f, buf + off, buf + off, chunks[k]);
+        off += chunks[k];
+    }
+    TEST_ASSERT(off == 61);
+    TEST_ASSERT(memcmp(buf, ref, sizeof(ref)) == 0);
+
+    /* Médiane 5 : pic isolé supprimé */
+    TEST_ASSERT(sensor_filter_init_median(&f, 5) == SENSOR_OK);
+    int16_t spike[8] = { 10, 10, 10, 30000, 30000, 10, 10, 10 };
+    sensor_filter_process(&f, spike, spike, 8);
+    TEST_ASSERT(spike[3] == 10 && spike[4] == 10 && spike[7] == 10);
+
+    /* Paramètres refusés */
+    TEST_ASSERT(sensor_filter_init_ma(&f, 0) == SENSOR_ERR);
+    TEST_ASSERT(sensor_filter_init_cic(&f, 2, 6) == SENSOR_ERR);
+    TEST_ASSERT(sensor_filter_init_cic(&f, 4, 512) == SENSOR_ERR);
+    TEST_ASSERT(sensor_filter_init_median(&f, 4) == SENSOR_ERR);
+    TEST_ASSERT(sensor_filter_init_iir1(&f, 16) == SENSOR_ERR);
+
+    /* Pipeline : médiane 3 -> IIR -> CIC /4 -> MA 2 */
+    sensor_filter_t stages[4];
+    sensor_filter_init_median(&stages[0], 3);
+    sensor_filter_init_iir1(&stages[1], 1);
+    sensor_filter_init_cic(&stages[2], 2, 4);
+    sensor_filter_init_ma(&stages[3], 2);
+
+    sensor_pipeline_t p;
+    TEST_ASSERT(sensor_pipeline_init(&p, stages, 4) == SENSOR_OK);
+    for (int i = 0; i < 64; i++) buf[i] = (i == 20) ? 9999 : 2000;
+    n = sensor_pipeline_process(&p, buf, 64);
+    TEST_ASSERT(n == 16);
+    int flat = 1;
+    for (size_t i = 0; i < n; i++) flat &= buf[i] == 2000;
+    TEST_ASSERT(flat); // le pic isolé ne passe pas la médiane
+
+    /* Blocs successifs : la phase de décimation est conservée */
+    for (int i = 0; i < 6; i++) buf[i] = 2000;
+    TEST_ASSERT(sensor_pipeline_process(&p, buf, 6) == 1);
+    TEST_ASSERT(sensor_pipeline_process(&p, buf, 2) == 1);
+
+    sensor_pipeline_reset(&p);
+    for (int i = 0; i < 4; i++) buf[i] = -50;
+    TEST_ASSERT(sensor_pipeline_process(&p, buf, 4) == 1 && buf[0] == -50);
+}
+
+/*
+    Test 17 : codec delta / zigzag / bit-packing.
+    - flux régulier du fake : au moins 4x plus petit que le brut
+    - aller-retour exact avec gigue, sauts et extrêmes int16
+    - en-têtes : accès aléatoire (seek) et rejet d'un bloc corrompu
+*/
+static void test_codec(void)
+{
+    enum { N = 1000, BLOCK = 128 };
+    static int16_t v[N], v2[N];
+    static uint64_t t[N], t2[N];
+    static uint8_t stream[N * 12];
+
+    /* Flux du fake : +5 par lecture, période fixe de 1 ms */
+    hal_bus_t bus;
+    hal_bus_fake_ctx_t bus_ctx;
+    hal_bus_fake_init(&bus_ctx, &bus);
+    sensor_t s;
+    TEST_ASSERT(sensor_init(&s, 0x50, &bus, NULL, NULL) == SENSOR_OK);
+
+    for (int i = 0; i < N; i++) {
+        sensor_read_temperature_centi(&s, &v[i]);
+        t[i] = 1000000u + 1000u * (uint64_t)i;
+    }
+
+    sensor_encoder_t enc;
+    TEST_ASSERT(sensor_encoder_init(&enc, BLOCK) == SENSOR_OK);
+
+    size_t len = 0, w = 0;
+    int ok = 1;
+    for (int i = 0; i < N; i++) {
+        ok &= sensor_encoder_push(&enc, v[i], t[i], stream + len, sizeof(stream) - len, &w) == SENSOR_OK;
+        len += w;
+    }
+    TEST_ASSERT(ok);
+    TEST_ASSERT(sensor_encoder_flush(&enc, stream + len, sizeof(stream) - len, &w) == SENSOR_OK);
+    len += w;
+    TEST_ASSERT(len * 4 <= N * (sizeof(int16_t) + sizeof(uint64_t)));
+
+    /* Décodage bloc par bloc */
+    size_t pos = 0, total = 0;
+    while (pos < len) {
+        sensor_codec_block_info_t info;
+        size_t n = 0;
+        TEST_ASSERT(sensor_codec_block_info(stream + pos, len - pos, &info) == SENSOR_OK);
+        TEST_ASSERT(info.ts_bits == 0);
+        TEST_ASSERT(sensor_codec_decode_block(stream + pos, len - pos,
+                                              v2 + total, t2 + total, N - total, &n) == SENSOR_OK);
+        total += n;
+        pos += info.size;
+    }
+    TEST_ASSERT(total == N);
+    TEST_ASSERT(memcmp(v, v2, sizeof(v)) == 0 && memcmp(t, t2, sizeof(t)) == 0);
+
+    /* Accès aléatoire : bloc contenant l'échantillon 700 */
+    size_t off = 0;
+    TEST_ASSERT(sensor_codec_seek(stream, len, t[700], &off) == SENSOR_OK);
+    size_t n = 0;
+    TEST_ASSERT(sensor_codec_decode_block(stream + off, len - off, v2, t2, N, &n) == SENSOR_OK);
+    TEST_ASSERT(t2[0] <= t[700] && t2[n - 1] >= t[700]);
+    TEST_ASSERT(v2[700 - 5 * BLOCK] == v[700]);
+    TEST_ASSERT(sensor_codec_seek(stream, len, t[0] - 1, &off) == SENSOR_ERR);
+
+    /* Données difficiles : gigue, extrêmes, horodatages égaux, gros écart */
+    uint32_t r = 99;
+    for (int i = 0; i < BLOCK; i++) {
+        r = r * 1103515245u + 12345u;
+        v[i] = (int16_t)(r >> 16);
+        t[i] = (i == 0) ? 5 : t[i - 1] + (r >> 28);
+    }
+    v[3] = INT16_MIN; v[4] = INT16_MAX; v[5] = INT16_MIN;
+    t[BLOCK - 1] = t[BLOCK - 2] + UINT32_MAX;
+
+    TEST_ASSERT(sensor_codec_encode_block(v, t, BLOCK, stream, sizeof(stream), &w) == SENSOR_OK);
+    TEST_ASSERT(w <= SENSOR_CODEC_BLOCK_BOUND(BLOCK));
+    TEST_ASSERT(sensor_codec_decode_block(stream, w, v2, t2, BLOCK, &n) == SENSOR_OK && n == BLOCK);
+    TEST_ASSERT(memcmp(v, v2, BLOCK * sizeof(int16_t)) == 0);
+    TEST_ASSERT(memcmp(t, t2, BLOCK * sizeof(uint64_t)) == 0);
+
+    /* Valeurs seules */
+    TEST_ASSERT(sensor_codec_decode_block(stream, w, v2, NULL, BLOCK, &n) == SENSOR_OK);
+    TEST_ASSERT(v2[BLOCK - 1] == v[BLOCK - 1]);
+
+    /* Rejets : bloc tronqué, en-tête corrompu, temps qui recule */
+    TEST_ASSERT(sensor_codec_decode_block(stream, w - 1, v2, t2, BLOCK, &n) == SENSOR_ERR);
+    stream[1] = 40;
+    TEST_ASSERT(sensor_codec_decode_block(stream, w, v2, t2, BLOCK, &n) == SENSOR_ERR);
+    t[10] = t[9] - 1;
+    TEST_ASSERT(sensor_codec_encode_block(v, t, BLOCK, stream, sizeof(stream), &w) == SENSOR_ERR);
+}
+
+/*
+    Test 18 : agrégats multi-résolution.
+    - 2 h à 10 Hz, niveaux 1 s / 1 min / 1 h
+    - requêtes comparées au calcul brut sur les mêmes bornes
+    - aiguillage par sensor_id, échantillons trop anciens
+*/
+static int16_t rollup_value(uint64_t i)
+{
+    return (int16_t)(2000 + (int)(i % 1000) - (int)((i / 7) % 300));
+}
+
+static void test_rollup(void)
+{
+    enum { HZ = 10, SECONDS = 7200 };
+    static sensor_bucket_t b_sec[120], b_min[180], b_hour[24];
+
+    sensor_rollup_t r;
+    TEST_ASSERT(sensor_rollup_init(&r) == SENSOR_OK);
+    TEST_ASSERT(sensor_rollup_add_tier(&r, 1000000u, b_sec, 120) == SENSOR_OK);
+    TEST_ASSERT(sensor_rollup_add_tier(&r, 60000000u, b_min, 180) == SENSOR_OK);
+    TEST_ASSERT(sensor_rollup_add_tier(&r, 30000000u, b_min, 10) == SENSOR_ERR); // non croissant
+    TEST_ASSERT(sensor_rollup_add_tier(&r, 3600000000u, b_hour, 24) == SENSOR_OK);
+
+    const uint64_t t0 = 1000000000u; // 1000 s : non aligné sur l'heure
+    for (uint64_t i = 0; i < (uint64_t)HZ * SECONDS; i++) {
+        sensor_rollup_add(&r, t0 + i * (1000000u / HZ), rollup_value(i));
+    }
+    TEST_ASSERT(r.late_drops == 0);
+
+    /* Requête : le calcul brut sur la plage alignée doit coïncider */
+    const uint64_t ranges[][2] = {
+        { t0 + 7100000000u, t0 + 7105000000u }, // 5 s récentes -> niveau 1 s
+        { t0 + 600000000u,  t0 + 4200000000u }, // 1 h -> niveau 1 min
+        { t0,               t0 + 7200000000u }, // tout -> niveau 1 min (8+ buckets)
+    };
+    const uint8_t expected_tier[] = { 0, 1, 1 };
+
+    for (size_t q = 0; q < 3; q++) {
+        sensor_rollup_stat_t st;
+        TEST_ASSERT(sensor_rollup_query(&r, ranges[q][0], ranges[q][1], &st) == SENSOR_OK);
+        TEST_ASSERT(st.tier == expected_tier[q]);
+
+        uint64_t n = 0;
+        int64_t sum = 0;
+        int16_t mn = INT16_MAX, mx = INT16_MIN;
+        for (uint64_t i = 0; i < (uint64_t)HZ * SECONDS; i++) {
+            uint64_t t = t0 + i * (1000000u / HZ);
+            if (t < st.t_begin_us || t >= st.t_end_us)
+                continue;
+            int16_t v = rollup_value(i);
+            n++;
+            sum += v;
+            if (v < mn) mn = v;
+            if (v > mx) mx = v;
+        }
+        TEST_ASSERT(st.count == n && st.sum == sum && st.min == mn && st.max == mx);
+        TEST_ASSERT(st.t_begin_us <= ranges[q][0] + 60000000u);
+    }
+
+    /* Bucket d'une seconde ancienne : recyclé au niveau 1 s, présent au niveau 1 min */
+    sensor_bucket_t b;
+    TEST_ASSERT(sensor_rollup_bucket(&r, 0, t0 + 10000000u, &b) == SENSOR_ERR);
+    TEST_ASSERT(sensor_rollup_bucket(&r, 1, t0 + 10000000u, &b) == SENSOR_OK);
+    TEST_ASSERT(b.count > 0);
+    TEST_ASSERT(sensor_rollup_bucket(&r, 0, t0 + 7199000000u, &b) == SENSOR_OK && b.count == HZ);
+
+    /* Échantillon trop vieux pour le niveau 1 s, accepté plus haut */
+    sensor_rollup_add(&r, t0 + 1000u, 0);
+    TEST_ASSERT(r.late_drops == 1);
+
+    /* Aiguillage par capteur */
+    static sensor_bucket_t fb[2][8];
+    sensor_rollup_t by_id[2];
+    for (int i = 0; i < 2; i++) {
+        sensor_rollup_init(&by_id[i]);
+        sensor_rollup_add_tier(&by_id[i], 1000000u, fb[i], 8);
+    }
+    sensor_sample_t batch[4] = {
+        { 100, 0, 10, 0 }, { 200, 1, 20, 0 }, { 300, 0, 30, 0 }, { 400, 7, 99, 0 },
+    };
+    sensor_rollup_feed(by_id, 2, batch, 4);
+
+    sensor_rollup_stat_t st;
+    TEST_ASSERT(sensor_rollup_query(&by_id[0], 0, 1000000u, &st) == SENSOR_OK);
+    TEST_ASSERT(st.count == 2 && st.mean == 20 && st.min == 10 && st.max == 30);
+    TEST_ASSERT(sensor_rollup_query(&by_id[1], 0, 1000000u, &st) == SENSOR_OK);
+    TEST_ASSERT(st.count == 1 && st.mean == 20);
+}
+
 int main(void)
 {
     printf("=== Running sensor tests ===\n");
@@ -147,6 +1316,21 @@ int main(void)
     test_init_ok();
     test_init_bad_id();
     test_read_temperature_plausible();
+    test_read_samples_burst();
+    test_read_samples_overrun();
+    test_fleet_multi_bus();
+    test_ring_basic();
+    test_ring_threads();
+    test_log_rate_limit();
+    test_sim_time_stamps();
+    test_op_overlapped_init();
+    test_shadow_cache();
+    test_read_fields_coalesced();
+    test_convert_kernels();
+    test_calibration();
+    test_filters();
+    test_codec();
+    test_rollup();
 
     printf("Tests run: %d\n", g_tests_run);
     printf("Tests failed: %d\n", g_tests_failed);
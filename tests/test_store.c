@@ -0,0 +1,335 @@
+/*
+    test_store.c
+
+    Tests unitaires du stockage mmap (sans framework externe).
+
+    Objectifs :
+    - ajout / relecture zéro copie d'un segment
+    - plage de temps via l'index creux (données non triées)
+    - lecteur concurrent sur un second mapping
+    - dossier de segments : bascule, reprise, rétention
+    - reprise après crash (création interrompue) et échec de bascule
+*/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "store/store.h"
+
+/* Petit utilitaire : compteur de tests */
+static int g_tests_run = 0;
+static int g_tests_failed = 0;
+
+/*
+    Macro d'assertion minimaliste (même principe que test_sensor.c).
+*/
+#define TEST_ASSERT(cond) do {                                      \
+    g_tests_run++;                                                  \
+    if (!(cond)) {                                                  \
+        g_tests_failed++;                                           \
+        printf("[FAIL] %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+    }                                                               \
+} while (0)
+
+static char g_dir[64];
+
+static void path_in_dir(char *out, size_t cap, const char *name)
+{
+    snprintf(out, cap, "%s/%s", g_dir, name);
+}
+
+static sensor_sample_t make_sample(uint64_t t_us, uint32_t id, int16_t value)
+{
+    sensor_sample_t s;
+    memset(&s, 0, sizeof(s));
+    s.t_us = t_us;
+    s.sensor_id = id;
+    s.value = value;
+    return s;
+}
+
+/*
+    Test 1 : segment seul.
+*/
+static void test_segment_basic(void)
+{
+    char path[128];
+    path_in_dir(path, sizeof(path), "basic.tss");
+
+    store_segment_t w, dup;
+    TEST_ASSERT(store_segment_create(&w, path, 4000) == SENSOR_OK);
+    TEST_ASSERT(store_segment_create(&dup, path, 4000) == SENSOR_ERR); // existe déjà
+
+    /* 3000 enregistrements, 3 capteurs, t = 1000 * i (+ désordre local) */
+    int ok = 1;
+    for (uint32_t i = 0; i < 3000; i++) {
+        uint64_t t = 1000u * (uint64_t)i + ((i % 7 == 0) ? 1500u : 0u);
+        sensor_sample_t s = make_sample(t, i % 3, (int16_t)i);
+        ok &= store_segment_append(&w, &s) == SENSOR_OK;
+    }
+    TEST_ASSERT(ok);
+    TEST_ASSERT(store_segment_count(&w) == 3000);
+
+    /* Lecteur sur un second mapping, pendant que l'écrivain est ouvert */
+    store_segment_t r;
+    TEST_ASSERT(store_segment_open(&r, path, 0) == SENSOR_OK);
+    TEST_ASSERT(store_segment_append(&r, &(sensor_sample_t){0}) == SENSOR_ERR); // lecture seule
+
+    store_iter_t it;
+    const sensor_sample_t *p;
+    uint64_t n = 0;
+    int in_range = 1, zero_copy = 1;
+
+    store_iter_init(&it, &r, 1000000, 1999999);
+    while ((p = store_iter_next(&it)) != NULL) {
+        n++;
+        in_range &= p->t_us >= 1000000 && p->t_us <= 1999999;
+        zero_copy &= (const uint8_t *)p >= r.map && (const uint8_t *)p < r.map + r.map_size;
+    }
+    TEST_ASSERT(in_range && zero_copy);
+
+    /* Référence : comptage brut */
+    uint64_t ref = 0;
+    for (uint32_t i = 0; i < 3000; i++) {
+        uint64_t t = 1000u * (uint64_t)i + ((i % 7 == 0) ? 1500u : 0u);
+        ref += t >= 1000000 && t <= 1999999;
+    }
+    TEST_ASSERT(n == ref);
+
+    /* Ajout après l'ouverture du lecteur : visible par un nouvel itérateur */
+    sensor_sample_t late = make_sample(1500000, 9, -1);
+    TEST_ASSERT(store_segment_append(&w, &late) == SENSOR_OK);
+    store_iter_init(&it, &r, 1500000, 1500000);
+    int seen = 0;
+    while ((p = store_iter_next(&it)) != NULL) {
+        seen |= p->sensor_id == 9;
+    }
+    TEST_ASSERT(seen);
+
+    /* Plage vide */
+    store_iter_init(&it, &r, 10000000, 20000000);
+    TEST_ASSERT(store_iter_next(&it) == NULL);
+
+    TEST_ASSERT(store_segment_sync(&w) == SENSOR_OK);
+    store_segment_close(&r);
+    store_segment_close(&w);
+
+    /* Réouverture : tout est là */
+    TEST_ASSERT(store_segment_open(&r, path, 0) == SENSOR_OK);
+    TEST_ASSERT(store_segment_count(&r) == 3001);
+    TEST_ASSERT(r.records[2999].value == 2999);
+    store_segment_close(&r);
+    unlink(path);
+}
+
+/*
+    Test 2 : segment plein, fichier invalide.
+*/
+static void test_segment_limits(void)
+{
+    char path[128];
+    path_in_dir(path, sizeof(path), "small.tss");
+
+    store_segment_t seg;
+    TEST_ASSERT(store_segment_create(&seg, path, 2) == SENSOR_OK);
+    sensor_sample_t s = make_sample(1, 0, 0);
+    TEST_ASSERT(store_segment_append(&seg, &s) == SENSOR_OK);
+    TEST_ASSERT(store_segment_append(&seg, &s) == SENSOR_OK);
+    TEST_ASSERT(store_segment_append(&seg, &s) == SENSOR_ERR);
+    store_segment_close(&seg);
+    unlink(path);
+
+    /* Fichier quelconque : refusé */
+    path_in_dir(path, sizeof(path), "junk.tss");
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    char junk[8192];
+    memset(junk, 0x5A, sizeof(junk));
+    TEST_ASSERT(fd >= 0 && write(fd, junk, sizeof(junk)) == (ssize_t)sizeof(junk));
+    close(fd);
+    TEST_ASSERT(store_segment_open(&seg, path, 0) == SENSOR_ERR);
+    unlink(path);
+}
+
+/*
+    Test 3 : dossier de segments.
+*/
+typedef struct {
+    uint64_t n;
+    uint64_t last_t;
+    int ordered;
+} scan_acc_t;
+
+static int scan_visit(const sensor_sample_t *s, void *user)
+{
+    scan_acc_t *acc = (scan_acc_t *)user;
+    acc->ordered &= s->t_us >= acc->last_t;
+    acc->last_t = s->t_us;
+    acc->n++;
+    return 1;
+}
+
+static int scan_stop_at_10(const sensor_sample_t *s, void *user)
+{
+    (void)s;
+    return ++*(int *)user < 10;
+}
+
+static void test_store_dir(void)
+{
+    char dir[128];
+    path_in_dir(dir, sizeof(dir), "series");
+
+    store_t st;
+    TEST_ASSERT(store_open(&st, dir, 1000) == SENSOR_OK);
+
+    int ok = 1;
+    for (uint32_t i = 0; i < 2500; i++) {
+        sensor_sample_t s = make_sample(10u * i, 0, (int16_t)i);
+        ok &= store_append(&st, &s) == SENSOR_OK;
+    }
+    TEST_ASSERT(ok);
+    TEST_ASSERT(st.seg_no == 2);
+    TEST_ASSERT(store_sync(&st) == SENSOR_OK);
+    store_close(&st);
+
+    /* Reprise : ajout dans le dernier segment */
+    TEST_ASSERT(store_open(&st, dir, 1000) == SENSOR_OK);
+    TEST_ASSERT(st.seg_no == 2 && store_segment_count(&st.cur) == 500);
+    sensor_sample_t s = make_sample(25000, 0, 2500);
+    TEST_ASSERT(store_append(&st, &s) == SENSOR_OK);
+    store_close(&st);
+
+    /* Parcours d'une plage à cheval sur deux segments */
+    scan_acc_t acc = { 0, 0, 1 };
+    TEST_ASSERT(store_scan(dir, 9000, 12990, scan_visit, &acc) == 400);
+    TEST_ASSERT(acc.n == 400 && acc.ordered);
+
+    /* Arrêt demandé par le callback */
+    int count = 0;
+    TEST_ASSERT(store_scan(dir, 0, UINT64_MAX, scan_stop_at_10, &count) == 10);
+
+    /* Rétention : premier segment supprimé */
+    char path[160];
+    snprintf(path, sizeof(path), "%s/seg-000000.tss", dir);
+    TEST_ASSERT(unlink(path) == 0);
+    acc = (scan_acc_t){ 0, 0, 1 };
+    TEST_ASSERT(store_scan(dir, 0, UINT64_MAX, scan_visit, &acc) == 1501);
+
+    for (int i = 1; i <= 2; i++) {
+        snprintf(path, sizeof(path), "%s/seg-%06d.tss", dir, i);
+        unlink(path);
+    }
+    rmdir(dir);
+}
+
+static int seg_exists(const char *dir, int no)
+{
+    char path[160];
+    snprintf(path, sizeof(path), "%s/seg-%06d.tss", dir, no);
+    return access(path, F_OK) == 0;
+}
+
+/*
+    Fichier laissé par un crash pendant store_segment_create
+    (taille posée, magic pas encore écrit ; ou vide).
+*/
+static void make_torn_segment(const char *dir, int no, off_t size)
+{
+    char path[160];
+    snprintf(path, sizeof(path), "%s/seg-%06d.tss", dir, no);
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        if (ftruncate(fd, size) != 0) {
+            printf("ftruncate failed\n");
+        }
+        close(fd);
+    }
+}
+
+/*
+    Test 4 : reprise après crash, échec de bascule.
+*/
+static void test_store_recovery(void)
+{
+    char dir[128];
+    path_in_dir(dir, sizeof(dir), "crash");
+
+    store_t st;
+    TEST_ASSERT(store_open(&st, dir, 100) == SENSOR_OK);
+    int ok = 1;
+    for (uint32_t i = 0; i < 150; i++) {
+        sensor_sample_t s = make_sample(i, 0, (int16_t)i);
+        ok &= store_append(&st, &s) == SENSOR_OK;
+    }
+    TEST_ASSERT(ok && st.seg_no == 1);
+    store_close(&st);
+
+    /* Crash pendant la création des segments 2 (taille posée) et 3 (vide) */
+    make_torn_segment(dir, 2, 1 << 16);
+    make_torn_segment(dir, 3, 0);
+
+    TEST_ASSERT(store_open(&st, dir, 100) == SENSOR_OK);
+    TEST_ASSERT(st.seg_no == 1 && store_segment_count(&st.cur) == 50);
+    TEST_ASSERT(!seg_exists(dir, 2) && !seg_exists(dir, 3));
+
+    /* Échec de bascule (nom du segment 2 pris) : le segment plein reste ouvert */
+    for (uint32_t i = 150; i < 200; i++) {
+        sensor_sample_t s = make_sample(i, 0, (int16_t)i);
+        ok &= store_append(&st, &s) == SENSOR_OK;
+    }
+    TEST_ASSERT(ok);
+
+    char blocker[160];
+    snprintf(blocker, sizeof(blocker), "%s/seg-000002.tss", dir);
+    TEST_ASSERT(mkdir(blocker, 0755) == 0);
+    sensor_sample_t s = make_sample(200, 0, 200);
+    TEST_ASSERT(store_append(&st, &s) == SENSOR_ERR);
+    TEST_ASSERT(st.seg_no == 1 && st.cur.map != NULL);
+
+    /* Cause levée : l'ajout suivant bascule normalement */
+    TEST_ASSERT(rmdir(blocker) == 0);
+    TEST_ASSERT(store_append(&st, &s) == SENSOR_OK);
+    TEST_ASSERT(st.seg_no == 2 && store_segment_count(&st.cur) == 1);
+    store_close(&st);
+
+    scan_acc_t acc = { 0, 0, 1 };
+    TEST_ASSERT(store_scan(dir, 0, UINT64_MAX, scan_visit, &acc) == 201);
+    TEST_ASSERT(acc.ordered);
+
+    for (int i = 0; i <= 2; i++) {
+        char path[160];
+        snprintf(path, sizeof(path), "%s/seg-%06d.tss", dir, i);
+        unlink(path);
+    }
+    rmdir(dir);
+}
+
+int main(void)
+{
+    printf("=== Running store tests ===\n");
+
+    snprintf(g_dir, sizeof(g_dir), "/tmp/store_testXXXXXX");
+    if (!mkdtemp(g_dir)) {
+        printf("mkdtemp failed\n");
+        return 1;
+    }
+
+    test_segment_basic();
+    test_segment_limits();
+    test_store_dir();
+    test_store_recovery();
+
+    rmdir(g_dir);
+
+    printf("Tests run: %d\n", g_tests_run);
+    printf("Tests failed: %d\n", g_tests_failed);
+
+    return (g_tests_failed == 0) ? 0 : 1;
+}